@@ -1,3 +1,16 @@
+-- The LZ4 and zstd codecs in util-compression are optional, since they need
+-- the lz4 and zstd projects.  Set this to true to build them.
+local with_lz4_zstd = false
+
+local compression_defines = { 'BE_UTIL_COMPRESSION_IMPL' }
+local compression_projects = { 'core' }
+if with_lz4_zstd then
+   compression_defines[#compression_defines + 1] = 'BE_UTIL_COMPRESSION_LZ4'
+   compression_defines[#compression_defines + 1] = 'BE_UTIL_COMPRESSION_ZSTD'
+   compression_projects[#compression_projects + 1] = 'lz4'
+   compression_projects[#compression_projects + 1] = 'zstd'
+end
+
 module 'util' {
    lib {
       src {
@@ -16,8 +29,8 @@ module 'util' {
          'src-compression/*.cpp',
          pch_src 'src-compression/pch.cpp'
       },
-      define 'BE_UTIL_COMPRESSION_IMPL',
-      link_project 'core'
+      define(compression_defines),
+      link_project(compression_projects)
    },
    lib '-prng' {
       src {
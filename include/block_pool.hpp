@@ -0,0 +1,191 @@
+#pragma once
+#ifndef BE_UTIL_BLOCK_POOL_HPP_
+#define BE_UTIL_BLOCK_POOL_HPP_
+
+#include <be/core/be.hpp>
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <type_traits>
+
+namespace be::util {
+
+///////////////////////////////////////////////////////////////////////////////
+struct BlockPoolStats {
+   std::size_t block_size = 0;
+   std::size_t blocks_per_magazine = 0;
+   std::size_t slabs = 0;
+   std::size_t huge_page_slabs = 0;
+   std::size_t slab_bytes = 0;
+   std::size_t blocks_carved = 0;
+};
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Shared state for a single block size class.
+///
+/// \details Memory is obtained from the OS in large slabs (huge pages when
+///         available) which are never returned until the process exits.
+///         Free blocks are passed between threads in magazines: chains of
+///         up to blocks_per_magazine blocks.  Full magazines are kept on a
+///         lock-free (Treiber) stack.  A mutex is only taken when carving
+///         new blocks out of a slab, which happens once per magazine at most.
+class BlockPoolState {
+public:
+   struct Block {
+      Block* next;
+      Block* next_magazine;   // only valid for the first block in a magazine
+      std::size_t count;      // only valid for the first block in a magazine
+   };
+
+   ////////////////////////////////////////////////////////////////////////////
+   /// \brief  Blocks cached by one thread.
+   ///
+   /// \details Trivially destructible so that it remains usable while other
+   ///         thread_local and static objects (which may own blocks) are
+   ///         destroyed; ThreadCacheGuard flushes the cache and disables it
+   ///         instead.
+   struct ThreadCache {
+      BlockPoolState* state;
+      Block* head;            // partially full magazine which blocks are allocated from/freed to
+      std::size_t count;
+      std::size_t limit;
+      Block* spare;           // full magazine, or nullptr
+      bool initialized;
+      bool disabled;
+   };
+
+   struct ThreadCacheGuard {
+      ~ThreadCacheGuard();
+
+      ThreadCache& cache;
+   };
+
+   BlockPoolState(std::size_t block_size, std::size_t block_align) noexcept;
+   BlockPoolState(const BlockPoolState&) = delete;
+   BlockPoolState& operator=(const BlockPoolState&) = delete;
+
+   void init(ThreadCache& cache) noexcept;
+   void* refill(ThreadCache& cache);
+   void drain(ThreadCache& cache) noexcept;
+   void flush(ThreadCache& cache) noexcept;
+
+   void* allocate_uncached();
+   void deallocate_uncached(void* ptr) noexcept;
+
+   BlockPoolStats stats() const;
+
+private:
+   void push_magazine_(Block* magazine) noexcept;
+   Block* pop_magazine_() noexcept;
+   Block* carve_magazine_();
+
+   const std::size_t block_size_;
+   const std::size_t block_align_;
+   const std::size_t magazine_size_;
+
+   std::atomic<U64> free_magazines_;
+
+   mutable std::mutex mutex_;
+   UC* slab_cursor_;
+   UC* slab_end_;
+   std::size_t slabs_;
+   std::size_t huge_page_slabs_;
+   std::size_t slab_bytes_;
+   std::size_t blocks_carved_;
+};
+
+void* allocate_slab(std::size_t size, bool& huge_pages) noexcept;
+
+} // be::util::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A process-wide pool of fixed-size memory blocks.
+///
+/// \details Each thread allocates from and frees to its own magazine without
+///         any synchronization, keeping one spare full magazine to absorb
+///         alternating allocations and frees.  When both are exhausted it
+///         takes a full magazine from the shared lock-free free list (or
+///         carves a new one from a slab); when both are full it pushes the
+///         spare back.  Blocks may be freed on a
+///         different thread from the one that allocated them.  When a thread
+///         exits, its cached blocks are returned to the shared free list,
+///         and any blocks it allocates or frees after that (for instance
+///         from the destructors of static objects) go directly to and from
+///         the shared free list.
+///
+///         Memory is never returned to the OS, so BlockPool is best suited
+///         to long-running processes whose working set of blocks is roughly
+///         stable.  Freed blocks are reused in LIFO order, so over time
+///         consecutively allocated blocks become scattered; this matters
+///         little for blocks of a cache line or more (such as ChunkedList
+///         nodes) but can hurt traversal of containers of very small nodes.
+///
+/// \tparam Size The size of each block in bytes.
+/// \tparam Align The alignment of each block.
+template <std::size_t Size, std::size_t Align = alignof(std::max_align_t)>
+class BlockPool {
+public:
+   static constexpr std::size_t block_size = Size;
+   static constexpr std::size_t block_align = Align;
+
+   static void* allocate();
+   static void deallocate(void* ptr) noexcept;
+   static BlockPoolStats stats();
+
+private:
+   static detail::BlockPoolState& state_();
+   static detail::BlockPoolState::ThreadCache* cache_();
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A stateless allocator which services single-object allocations
+///         from a BlockPool sized for T.
+///
+/// \details Intended for node-based containers such as ChunkedList, which
+///         only ever call allocate(1).  Allocations of more than one object
+///         fall back to std::allocator.  All PoolAllocators compare
+///         equal.
+template <typename T>
+class PoolAllocator {
+public:
+   using value_type = T;
+   using size_type = std::size_t;
+   using difference_type = std::ptrdiff_t;
+   using pointer = T*;
+   using const_pointer = const T*;
+   using reference = T&;
+   using const_reference = const T&;
+   using propagate_on_container_move_assignment = std::true_type;
+   using is_always_equal = std::true_type;
+
+   template <typename U>
+   struct rebind {
+      using other = PoolAllocator<U>;
+   };
+
+   PoolAllocator() noexcept = default;
+   template <typename U>
+   PoolAllocator(const PoolAllocator<U>&) noexcept { }
+
+   T* allocate(std::size_t n);
+   void deallocate(T* ptr, std::size_t n) noexcept;
+
+private:
+   using pool = BlockPool<sizeof(T), (alignof(T) > alignof(void*) ? alignof(T) : alignof(void*))>;
+};
+
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept;
+
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept;
+
+} // be::util
+
+#include "block_pool.inl"
+
+#endif
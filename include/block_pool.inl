@@ -0,0 +1,112 @@
+#if !defined(BE_UTIL_BLOCK_POOL_HPP_) && !defined(DOXYGEN)
+#include "block_pool.hpp"
+#elif !defined(BE_UTIL_BLOCK_POOL_INL_)
+#define BE_UTIL_BLOCK_POOL_INL_
+
+namespace be::util {
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t Size, std::size_t Align>
+void* BlockPool<Size, Align>::allocate() {
+   detail::BlockPoolState::ThreadCache* cache = cache_();
+   if (!cache) {
+      return state_().allocate_uncached();
+   }
+
+   detail::BlockPoolState::Block* block = cache->head;
+   if (block) {
+      cache->head = block->next;
+      --cache->count;
+      return block;
+   }
+
+   return cache->state->refill(*cache);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t Size, std::size_t Align>
+void BlockPool<Size, Align>::deallocate(void* ptr) noexcept {
+   if (!ptr) {
+      return;
+   }
+
+   detail::BlockPoolState::ThreadCache* cache = cache_();
+   if (!cache) {
+      state_().deallocate_uncached(ptr);
+      return;
+   }
+
+   if (cache->count == cache->limit) {
+      cache->state->drain(*cache);
+   }
+
+   detail::BlockPoolState::Block* block = static_cast<detail::BlockPoolState::Block*>(ptr);
+   block->next = cache->head;
+   cache->head = block;
+   ++cache->count;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t Size, std::size_t Align>
+BlockPoolStats BlockPool<Size, Align>::stats() {
+   return state_().stats();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \details The state is intentionally never destroyed so that blocks can
+///         safely be freed by objects with static storage duration.
+template <std::size_t Size, std::size_t Align>
+detail::BlockPoolState& BlockPool<Size, Align>::state_() {
+   alignas(detail::BlockPoolState) static UC storage[sizeof(detail::BlockPoolState)];
+   static detail::BlockPoolState* state = new (storage) detail::BlockPoolState(Size, Align);
+   return *state;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \returns nullptr if the calling thread's cache has already been
+///         destroyed.
+template <std::size_t Size, std::size_t Align>
+detail::BlockPoolState::ThreadCache* BlockPool<Size, Align>::cache_() {
+   thread_local detail::BlockPoolState::ThreadCache cache;
+   if (!cache.initialized) {
+      state_().init(cache);
+      thread_local detail::BlockPoolState::ThreadCacheGuard guard { cache };
+   }
+   return cache.disabled ? nullptr : &cache;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+T* PoolAllocator<T>::allocate(std::size_t n) {
+   if (n == 1) {
+      return static_cast<T*>(pool::allocate());
+   }
+
+   return std::allocator<T>().allocate(n);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void PoolAllocator<T>::deallocate(T* ptr, std::size_t n) noexcept {
+   if (n == 1) {
+      pool::deallocate(ptr);
+   } else {
+      std::allocator<T>().deallocate(ptr, n);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename U>
+bool operator==(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept {
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename U>
+bool operator!=(const PoolAllocator<T>&, const PoolAllocator<U>&) noexcept {
+   return false;
+}
+
+} // be::util
+
+#endif
@@ -6,6 +6,13 @@
 #include <be/core/t_container_types.hpp>
 #include <be/core/t_is_iterator.hpp>
 #include <be/core/small_triplet.hpp>
+#include <algorithm>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <type_traits>
+#include <vector>
 
 namespace be::util {
 namespace detail {
@@ -32,12 +39,93 @@ public:
 };
 
 ///////////////////////////////////////////////////////////////////////////////
-template<typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-class ChunkedListBase {
-   using base = ChunkedListBase<T, A, N, M, S>;
+/// \brief  Detects ranges whose elements are stored contiguously as T, i.e.
+///         those supporting std::data() and std::size().
+template <typename R, typename T, typename = void>
+struct ChunkedListIsContiguousRange : std::false_type { };
+
+template <typename R, typename T>
+struct ChunkedListIsContiguousRange<R, T, std::void_t<decltype(std::data(std::declval<R&>())), decltype(std::size(std::declval<R&>()))>>
+   : std::is_same<std::remove_cv_t<std::remove_pointer_t<decltype(std::data(std::declval<R&>()))>>, T> { };
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Optional flat array of pointers to every allocated data node,
+///         allowing node lookup in constant time regardless of how many
+///         metanodes a container has.
+///
+/// \details The default (X = false) specialization is empty and all its
+///         operations are no-ops.
+template <typename P, typename A, bool X>
+class ChunkedListNodeIndex {
+protected:
+   ChunkedListNodeIndex(const A&) { }
+
+   void index_push_(P) { }
+   void index_truncate_(std::size_t) noexcept { }
+   void index_swap_(ChunkedListNodeIndex&) noexcept { }
+   void index_shrink_() { }
+   std::size_t index_bytes_() const noexcept { return 0; }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename P, typename A>
+class ChunkedListNodeIndex<P, A, true> {
+   using index_alloc = typename std::allocator_traits<A>::template rebind_alloc<P>;
+protected:
+   ChunkedListNodeIndex(const A& alloc)
+      : nodes_(index_alloc(alloc))
+   { }
+
+   void index_push_(P node) {
+      nodes_.push_back(node);
+   }
+
+   void index_truncate_(std::size_t count) noexcept {
+      if (count < nodes_.size()) {
+         nodes_.erase(nodes_.begin() + count, nodes_.end());
+      }
+   }
+
+   void index_swap_(ChunkedListNodeIndex& other) noexcept {
+      nodes_.swap(other.nodes_);
+   }
+
+   void index_shrink_() {
+      nodes_.shrink_to_fit();
+   }
+
+   std::size_t index_bytes_() const noexcept {
+      return nodes_.capacity() * sizeof(P);
+   }
+
+   P index_get_(std::size_t node_index) const noexcept {
+      assert(node_index < nodes_.size());
+      return nodes_[node_index];
+   }
+
+   std::size_t index_size_() const noexcept {
+      return nodes_.size();
+   }
+
+private:
+   std::vector<P, index_alloc> nodes_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A>
+using ChunkedListAllocator = typename t::Select<t::IsSimpleAlloc<typename t::ContainerTypes<T, A>::allocator>::value, A, std::allocator<T>>::type;
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, bool X>
+using ChunkedListBaseIndex = ChunkedListNodeIndex<typename t::ContainerTypes<T, ChunkedListAllocator<T, A>>::types::pointer, ChunkedListAllocator<T, A>, X>;
+
+///////////////////////////////////////////////////////////////////////////////
+template<typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+class ChunkedListBase : public ChunkedListBaseIndex<T, A, X> {
+   using base = ChunkedListBase<T, A, N, M, S, X>;
 protected:
    using node = ChunkedListNode<T, N>;
-   using allocator = typename t::Select<t::IsSimpleAlloc<typename t::ContainerTypes<T, A>::allocator>::value, A, std::allocator<T>>::type;
+   using allocator = ChunkedListAllocator<T, A>;
    using contypes = t::ContainerTypes<T, allocator>;
    using nodetypes = t::ContainerTypes<node, allocator>;
    using types = typename contypes::types;
@@ -59,7 +147,8 @@ protected:
    using meta_alloc = typename metatypes::allocator;
 
    ChunkedListBase(const allocator& alloc = allocator())
-      : triplet_(OneArgTag(), OneArgTag(), alloc, alloc)
+      : ChunkedListBaseIndex<T, A, X>(alloc),
+        triplet_(OneArgTag(), OneArgTag(), alloc, alloc)
    { }
 
    void set_allocator_(const allocator& alloc) {
@@ -124,7 +213,10 @@ private:
 ///         it may be several arrays).  It supports random element access in
 ///         constant time for small containers, and O(N) in the worst case
 ///         (very large containers).  Vectors are slightly more efficient since
-///         they always store all their data in a single array.
+///         they always store all their data in a single array.  If X is true,
+///         the container additionally maintains a flat array of node pointers
+///         (similar to a deque's map) making random access O(1) regardless of
+///         size.
 ///
 ///         Like a deque, inserting and erasing elements at the back of a
 ///         chunked_list will never invalidate any iterators or references
@@ -162,6 +254,10 @@ private:
 ///         Attempting to use a non-simple allocator will result in
 ///         std::allocator being used instead.
 ///
+///         When X is true, the node index is a std::vector of node pointers
+///         using an allocator rebound from A.  This is the only allocation
+///         the container makes which is not of a single node or metanode.
+///
 ///         Allocator::construct() is not used to construct objects;
 ///         placement-new is used directly.  If non-standard construction
 ///         is required, override operator new (size_t, void*).
@@ -172,10 +268,12 @@ private:
 /// \tparam M The number of nodes tracked per metanode.
 /// \tparam S The number of nodes that can be tracked without allocating any
 ///         metanodes.
-template <typename T, typename A = std::allocator<T>, std::size_t N = 16, std::size_t M = 7, std::size_t S = 2>
-class ChunkedList : public detail::ChunkedListBase<T, A, N, M, S> {
-   using container = ChunkedList<T, A, N, M, S>;
-   using base = detail::ChunkedListBase<T, A, N, M, S>;
+/// \tparam X If true, maintain a flat index of node pointers so that random
+///         access never needs to walk the metanode chain.
+template <typename T, typename A = std::allocator<T>, std::size_t N = 16, std::size_t M = 7, std::size_t S = 2, bool X = false>
+class ChunkedList : public detail::ChunkedListBase<T, A, N, M, S, X> {
+   using container = ChunkedList<T, A, N, M, S, X>;
+   using base = detail::ChunkedListBase<T, A, N, M, S, X>;
    using node_alloc = typename base::node_alloc;
    using meta_alloc = typename base::meta_alloc;
    using staticmetanode = typename base::staticmetanode;
@@ -198,11 +296,14 @@ public:
    static constexpr const std::size_t chunk_size = N;
    static constexpr const std::size_t chunks_per_metanode = M;
    static constexpr const std::size_t static_chunks = S;
+   static constexpr const bool indexed = X;
 
    using iterator = typename detail::ChunkedListIterator<container>;
    using const_iterator = typename detail::ChunkedListConstIterator<container>;
    using reverse_iterator = std::reverse_iterator<iterator>;
    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+   using chunk_type = gsl::span<value_type>;
+   using const_chunk_type = gsl::span<const value_type>;
 
    ChunkedList();
    explicit ChunkedList(const allocator_type& alloc);
@@ -259,6 +360,11 @@ public:
    bool empty() const noexcept;
    size_type size() const noexcept;
    size_type max_size() const noexcept;
+   size_type capacity() const;
+   void reserve(size_type count);
+   void shrink_to_fit();
+   void compact();
+   size_type memory_usage() const;
 
    iterator insert(const_iterator pos, const value_type& value);
    iterator insert(const_iterator pos, value_type&& value);
@@ -273,6 +379,8 @@ public:
    void push_back(value_type&& value);
    template <class... P>
    void emplace_back(P&&... args);
+   template <typename R>
+   void append_range(R&& range);
 
    void pop_back();
 
@@ -286,6 +394,11 @@ public:
 
    void swap(container& other);
 
+   template <typename F>
+   void for_each_chunk(F&& func);
+   template <typename F>
+   void for_each_chunk(F&& func) const;
+
 private:
    static size_type get_node_index_(size_type pos);
    static size_type get_node_index_(size_type pos, size_type& index);
@@ -312,6 +425,7 @@ private:
    void delete_metanodes_(metanode* meta);
 
    size_type get_capacity_() const;
+   size_type count_nodes_(size_type& metanodes) const;
    size_type get_capacity_(metanode*& last_meta);
    size_type ensure_capacity_(size_type count);
 
@@ -332,6 +446,8 @@ private:
 
    template <typename I>
    void insert_back_(I first, I last, std::forward_iterator_tag);
+   template <typename I>
+   void construct_back_(I first, size_type count);
 
    template <typename I>
    void assign_(I first, I last, std::input_iterator_tag);
@@ -344,26 +460,103 @@ private:
 
    void move_assign_(const_iterator first, const_iterator last);
 
+   template <typename F>
+   void for_each_node_(F& func) const;
+
+   template <typename F>
+   void for_each_segment_(size_type pos, size_type count, F func);
+
+   void get_nodes_(size_type first_node, size_type count, pointer* out);
+   void relocate_(size_type dest, size_type src, size_type count);
+   void rotate_back_(size_type offset, size_type old_size);
+
    size_type size_;
 };
 
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator==(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right);
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator==(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right);
+
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator!=(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right);
 
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator!=(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right);
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator<=(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right);
 
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator<=(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right);
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator>(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right);
 
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator>(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right);
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator<=(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right);
 
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator<=(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right);
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator>(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right);
 
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator>(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right);
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Finds the number of elements per node which wastes the smallest
+///         fraction of a node whose size is a whole number of cache lines.
+///
+/// \details Node sizes from node_bytes (or min_elems elements, if larger),
+///         rounded up to a cache line, through page_bytes are considered.
+///         Ties are resolved in favor of smaller nodes.
+constexpr std::size_t chunked_list_auto_chunk_size(std::size_t elem_bytes, std::size_t node_bytes, std::size_t min_elems, std::size_t line_bytes, std::size_t page_bytes) {
+   std::size_t min_bytes = (std::max(node_bytes, elem_bytes * min_elems) + line_bytes - 1) / line_bytes * line_bytes;
+   std::size_t max_bytes = std::max(page_bytes, min_bytes);
+
+   std::size_t best_n = 1;
+   std::size_t best_bytes = 1;
+   std::size_t best_waste = 1;
+   for (std::size_t bytes = min_bytes; bytes <= max_bytes; bytes += line_bytes) {
+      std::size_t n = bytes / elem_bytes;
+      std::size_t waste = bytes - n * elem_bytes;
+      if (waste * best_bytes < best_waste * bytes) {
+         best_n = n;
+         best_bytes = bytes;
+         best_waste = waste;
+      }
+      if (waste == 0) {
+         break;
+      }
+   }
+   return best_n;
+}
+
+} // be::util::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Chooses ChunkedList layout parameters for a given element type.
+///
+/// \details Data nodes are sized to a whole number of cache lines holding
+///         as many elements as possible with minimal slack, so that a `char`
+///         list and a list of large structs both get reasonably sized nodes.
+///         Nodes are at least NodeBytes and hold at least min_chunk_size
+///         elements; they are no larger than one page unless that is needed
+///         to hold min_chunk_size elements.  Metanodes fill exactly
+///         one cache line.  The number of node pointers stored in the
+///         container object itself is chosen so that the object (excluding
+///         any empty allocators and the optional node index) occupies at
+///         most TargetBytes.
+///
+/// \tparam T The type of objects to store in the container.
+/// \tparam TargetBytes The target size of the ChunkedList object.
+/// \tparam NodeBytes The minimum size of each data node.
+template <typename T, std::size_t TargetBytes = 64, std::size_t NodeBytes = 256>
+struct ChunkedListAutoLayout {
+   static constexpr std::size_t cache_line_bytes = 64;
+   static constexpr std::size_t page_bytes = 4096;
+   static constexpr std::size_t min_chunk_size = 16;
+
+   static constexpr std::size_t chunk_size = detail::chunked_list_auto_chunk_size(sizeof(T), NodeBytes, min_chunk_size, cache_line_bytes, page_bytes);
+   static constexpr std::size_t chunks_per_metanode = cache_line_bytes / sizeof(void*) - 1;
+   static constexpr std::size_t static_chunks = TargetBytes > 3 * sizeof(void*) ? (TargetBytes - 2 * sizeof(void*)) / sizeof(void*) : 1;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A ChunkedList whose layout parameters are chosen by a
+///         ChunkedListAutoLayout policy.
+template <typename T, typename A = std::allocator<T>, typename L = ChunkedListAutoLayout<T>, bool X = false>
+using AutoChunkedList = ChunkedList<T, A, L::chunk_size, L::chunks_per_metanode, L::static_chunks, X>;
 
 //template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
 //struct PrintTraits<chunked_list<T, A, N, M, S>> : PrintTraits<void>
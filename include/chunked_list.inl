@@ -8,21 +8,21 @@ namespace be::util {
 #pragma region construction/destruction
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::ChunkedList()
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::ChunkedList()
    : size_(0)
 { }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::ChunkedList(const allocator_type& alloc)
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::ChunkedList(const allocator_type& alloc)
    : base(alloc),
      size_(0)
 { }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::ChunkedList(size_type count, const value_type& value, const allocator_type& alloc)
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::ChunkedList(size_type count, const value_type& value, const allocator_type& alloc)
    : base(alloc),
      size_(0)
 {
@@ -34,8 +34,8 @@ ChunkedList<T, A, N, M, S>::ChunkedList(size_type count, const value_type& value
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::ChunkedList(size_type count, const allocator_type& alloc)
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::ChunkedList(size_type count, const allocator_type& alloc)
    : base(alloc),
      size_(0)
 {
@@ -47,9 +47,9 @@ ChunkedList<T, A, N, M, S>::ChunkedList(size_type count, const allocator_type& a
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename I, typename>
-ChunkedList<T, A, N, M, S>::ChunkedList(I first, I last, const allocator_type& alloc)
+ChunkedList<T, A, N, M, S, X>::ChunkedList(I first, I last, const allocator_type& alloc)
    : base(alloc),
      size_(0)
 {
@@ -57,48 +57,50 @@ ChunkedList<T, A, N, M, S>::ChunkedList(I first, I last, const allocator_type& a
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::ChunkedList(const container& other)
-   : base(other.get_node_alloc_().select_on_container_copy_construction()),
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::ChunkedList(const container& other)
+   : base(std::allocator_traits<node_alloc>::select_on_container_copy_construction(other.get_node_alloc_())),
      size_(0)
 {
    this->insert_back_(other.begin(), other.end(), std::random_access_iterator_tag());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::ChunkedList(const container& other, const allocator_type& alloc)
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::ChunkedList(const container& other, const allocator_type& alloc)
    : base(alloc),
      size_(0)
 {
-   this->insert_back_(other.begin(), other.end(), typename std::iterator_traits<I>::iterator_category());
+   this->insert_back_(other.begin(), other.end(), std::random_access_iterator_tag());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::ChunkedList(container&& other)
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::ChunkedList(container&& other)
    : size_(0)
 {
    using std::swap;
    this->swap_allocators_(other);
    swap(size_, other.size_);
    swap(this->get_static_metanode_(), other.get_static_metanode_());
+   this->index_swap_(other);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::ChunkedList(container&& other, const allocator_type& alloc)
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::ChunkedList(container&& other, const allocator_type& alloc)
    : base(alloc),
      size_(0)
 {
    using std::swap;
    swap(size_, other.size_);
    swap(this->get_static_metanode_(), other.get_static_metanode_());
+   this->index_swap_(other);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::ChunkedList(std::initializer_list<value_type> il, const allocator_type& alloc)
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::ChunkedList(std::initializer_list<value_type> il, const allocator_type& alloc)
    : base(alloc),
      size_(0)
 {
@@ -107,8 +109,8 @@ ChunkedList<T, A, N, M, S>::ChunkedList(std::initializer_list<value_type> il, co
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>::~ChunkedList() {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>::~ChunkedList() {
    clear();
 }
 
@@ -116,11 +118,11 @@ ChunkedList<T, A, N, M, S>::~ChunkedList() {
 #pragma region assignment
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>&
-ChunkedList<T, A, N, M, S>::operator=(const container& other) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>&
+ChunkedList<T, A, N, M, S, X>::operator=(const container& other) {
    if (&other != this) {
-      if (other.get_node_alloc_() != this->get_node_alloc_() && node_alloc::propagate_on_container_copy_assignment::value) {
+      if (other.get_node_alloc_() != this->get_node_alloc_() && std::allocator_traits<node_alloc>::propagate_on_container_copy_assignment::value) {
          clear();
          this->set_allocator_(other.get_node_alloc_());
          this->insert_back_(other.begin(), other.end(), std::random_access_iterator_tag());
@@ -135,18 +137,20 @@ ChunkedList<T, A, N, M, S>::operator=(const container& other) {
 #pragma warning(disable: 4127) // conditional is constant
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>&
-ChunkedList<T, A, N, M, S>::operator=(container&& other) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>&
+ChunkedList<T, A, N, M, S, X>::operator=(container&& other) {
    using std::swap;
    if (&other != this) {
       if (other.get_node_alloc_() == this->get_node_alloc_()) {
          swap(size_, other.size_);
          swap(this->get_static_metanode_(), other.get_static_metanode_());
-      } else if (node_alloc::propagate_on_container_move_assignment::value) {
+         this->index_swap_(other);
+      } else if (std::allocator_traits<node_alloc>::propagate_on_container_move_assignment::value) {
          this->swap_allocators_(other);
          swap(size_, other.size_);
          swap(this->get_static_metanode_(), other.get_static_metanode_());
+         this->index_swap_(other);
       } else {
          // Can't take ownership of other's nodes
          this->move_assign_(other.begin(), other.end());
@@ -158,17 +162,17 @@ ChunkedList<T, A, N, M, S>::operator=(container&& other) {
 #pragma warning(pop)
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-ChunkedList<T, A, N, M, S>&
-ChunkedList<T, A, N, M, S>::operator=(std::initializer_list<value_type> il) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+ChunkedList<T, A, N, M, S, X>&
+ChunkedList<T, A, N, M, S, X>::operator=(std::initializer_list<value_type> il) {
    using cat = typename std::iterator_traits<typename std::initializer_list<value_type>::iterator>::iterator_category;
    assign_(il.begin(), il.end(), cat());
    return *this;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::assign(size_type count, const value_type& value) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::assign(size_type count, const value_type& value) {
    if (count == 0) {
       clear();
       return;
@@ -197,15 +201,15 @@ void ChunkedList<T, A, N, M, S>::assign(size_type count, const value_type& value
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename I, typename>
-void ChunkedList<T, A, N, M, S>::assign(I first, I last) {
+void ChunkedList<T, A, N, M, S, X>::assign(I first, I last) {
    assign_(first, last, typename std::iterator_traits<I>::iterator_category());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::assign(std::initializer_list<value_type> il) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::assign(std::initializer_list<value_type> il) {
    using cat = typename std::iterator_traits<typename std::initializer_list<value_type>::iterator>::iterator_category;
    assign_(il.begin(), il.end(), cat());
 }
@@ -214,9 +218,9 @@ void ChunkedList<T, A, N, M, S>::assign(std::initializer_list<value_type> il) {
 #pragma region random access
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::reference
-ChunkedList<T, A, N, M, S>::at(size_type pos) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::reference
+ChunkedList<T, A, N, M, S, X>::at(size_type pos) {
    if (pos >= size_) {
       throw std::out_of_range("ChunkedList index out of range!");
    }
@@ -229,9 +233,9 @@ ChunkedList<T, A, N, M, S>::at(size_type pos) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_reference
-ChunkedList<T, A, N, M, S>::at(size_type pos) const {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_reference
+ChunkedList<T, A, N, M, S, X>::at(size_type pos) const {
    if (pos >= size_) {
       throw std::out_of_range("ChunkedList index out of range!");
    }
@@ -244,9 +248,9 @@ ChunkedList<T, A, N, M, S>::at(size_type pos) const {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::reference
-ChunkedList<T, A, N, M, S>::operator[](size_type pos) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::reference
+ChunkedList<T, A, N, M, S, X>::operator[](size_type pos) {
    assert(size_ > pos);
    size_type node_index = pos / chunk_size;
    size_type index = pos % chunk_size;
@@ -256,9 +260,9 @@ ChunkedList<T, A, N, M, S>::operator[](size_type pos) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_reference
-ChunkedList<T, A, N, M, S>::operator[](size_type pos) const {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_reference
+ChunkedList<T, A, N, M, S, X>::operator[](size_type pos) const {
    assert(size_ > pos);
    size_type node_index = pos / chunk_size;
    size_type index = pos % chunk_size;
@@ -268,25 +272,25 @@ ChunkedList<T, A, N, M, S>::operator[](size_type pos) const {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::reference
-ChunkedList<T, A, N, M, S>::front() {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::reference
+ChunkedList<T, A, N, M, S, X>::front() {
    assert(size_ >= 1);
    return *get_node_(0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_reference
-ChunkedList<T, A, N, M, S>::front() const {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_reference
+ChunkedList<T, A, N, M, S, X>::front() const {
    assert(size_ >= 1);
    return *get_node_(0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::reference
-ChunkedList<T, A, N, M, S>::back() {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::reference
+ChunkedList<T, A, N, M, S, X>::back() {
    const size_type pos = size_ - 1;
    assert(pos >= 0);
 
@@ -294,9 +298,9 @@ ChunkedList<T, A, N, M, S>::back() {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_reference
-ChunkedList<T, A, N, M, S>::back() const {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_reference
+ChunkedList<T, A, N, M, S, X>::back() const {
    const size_type pos = size_ - 1;
    assert(pos >= 0);
 
@@ -307,86 +311,86 @@ ChunkedList<T, A, N, M, S>::back() const {
 #pragma region iterators
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::begin() noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::begin() noexcept {
    return iterator(this, difference_type(0));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_iterator
-ChunkedList<T, A, N, M, S>::begin() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_iterator
+ChunkedList<T, A, N, M, S, X>::begin() const noexcept {
    return const_iterator(this, difference_type(0));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_iterator
-ChunkedList<T, A, N, M, S>::cbegin() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_iterator
+ChunkedList<T, A, N, M, S, X>::cbegin() const noexcept {
    return begin();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::end() noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::end() noexcept {
    return iterator(this, difference_type(size_));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_iterator
-ChunkedList<T, A, N, M, S>::end() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_iterator
+ChunkedList<T, A, N, M, S, X>::end() const noexcept {
    return const_iterator(this, difference_type(size_));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_iterator
-ChunkedList<T, A, N, M, S>::cend() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_iterator
+ChunkedList<T, A, N, M, S, X>::cend() const noexcept {
    return end();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::reverse_iterator
-ChunkedList<T, A, N, M, S>::rbegin() noexcept  {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::reverse_iterator
+ChunkedList<T, A, N, M, S, X>::rbegin() noexcept  {
    return reverse_iterator(end());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_reverse_iterator
-ChunkedList<T, A, N, M, S>::rbegin() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_reverse_iterator
+ChunkedList<T, A, N, M, S, X>::rbegin() const noexcept {
    return const_reverse_iterator(end());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_reverse_iterator
-ChunkedList<T, A, N, M, S>::crbegin() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_reverse_iterator
+ChunkedList<T, A, N, M, S, X>::crbegin() const noexcept {
    return rbegin();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::reverse_iterator
-ChunkedList<T, A, N, M, S>::rend() noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::reverse_iterator
+ChunkedList<T, A, N, M, S, X>::rend() noexcept {
    return reverse_iterator(begin());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_reverse_iterator
-ChunkedList<T, A, N, M, S>::rend() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_reverse_iterator
+ChunkedList<T, A, N, M, S, X>::rend() const noexcept {
    return const_reverse_iterator(begin());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::const_reverse_iterator
-ChunkedList<T, A, N, M, S>::crend() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::const_reverse_iterator
+ChunkedList<T, A, N, M, S, X>::crend() const noexcept {
    return rend();
 }
 
@@ -394,65 +398,145 @@ ChunkedList<T, A, N, M, S>::crend() const noexcept {
 #pragma region size
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool ChunkedList<T, A, N, M, S>::empty() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool ChunkedList<T, A, N, M, S, X>::empty() const noexcept {
    return size_ == 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::size_type
-ChunkedList<T, A, N, M, S>::size() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::size() const noexcept {
    return size_;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::size_type
-ChunkedList<T, A, N, M, S>::max_size() const noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::max_size() const noexcept {
    return std::numeric_limits<size_type>::max();
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the number of elements the container can hold without
+///         allocating any more nodes.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::capacity() const {
+   return get_capacity_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Allocates enough nodes and metanodes to hold at least count
+///         elements.
+///
+/// \details All nodes are allocated up front, so a following series of
+///         push_back() calls (or a bulk append) only constructs elements.
+///         Does not change size() and does not invalidate iterators or
+///         references.  Unused nodes are released by shrink_to_fit(),
+///         compact(), clear(), assign(), and any erase() or pop_back() which
+///         empties a node.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::reserve(size_type count) {
+   ensure_capacity_(count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns any nodes and metanodes not needed to hold the current
+///         elements to the allocator, along with any unused node index
+///         storage.
+///
+/// \details Does not invalidate iterators or references.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::shrink_to_fit() {
+   cleanup_();
+   this->index_shrink_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Moves all elements into a freshly allocated set of nodes and
+///         metanodes and returns the old ones to the allocator.
+///
+/// \details The new nodes are all allocated, in order, before any element
+///         is moved, so after a long history of growing and shrinking they
+///         are more likely to be close together in memory than the nodes
+///         they replace.  Spare capacity is released as with
+///         shrink_to_fit().  This is O(size()) and invalidates all iterators
+///         and references.  If an exception is thrown the container is
+///         unchanged.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::compact() {
+   container tmp(get_allocator());
+   if (size_ > 0) {
+      tmp.ensure_capacity_(size_);
+      if constexpr (std::is_nothrow_move_constructible<value_type>::value && !std::is_trivially_copyable<value_type>::value) {
+         tmp.construct_back_(std::make_move_iterator(begin()), size_);
+      } else {
+         tmp.construct_back_(cbegin(), size_);
+      }
+   }
+
+   swap(tmp);
+   this->index_shrink_();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the total number of bytes held by the container: the
+///         container object itself plus all allocated nodes, metanodes and
+///         node index storage.
+///
+/// \details Allocator bookkeeping overhead is not included.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::memory_usage() const {
+   size_type metanodes;
+   size_type nodes = count_nodes_(metanodes);
+   return sizeof(container)
+      + nodes * sizeof(typename base::node)
+      + metanodes * sizeof(metanode)
+      + this->index_bytes_();
+}
+
 #pragma endregion
 #pragma region insertion
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::insert(const_iterator pos, const value_type& value) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::insert(const_iterator pos, const value_type& value) {
    size_type offset = pos - begin();
    size_type old_size = size_;
    push_back(value);
-   std::rotate(iterator(this, difference_type(offset)), iterator(this, difference_type(old_size)), end());
+   rotate_back_(offset, old_size);
    return iterator(this, difference_type(offset));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::insert(const_iterator pos, value_type&& value) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::insert(const_iterator pos, value_type&& value) {
    size_type offset = pos - begin();
    size_type old_size = size_;
    push_back(std::forward<value_type>(value));
-   std::rotate(iterator(this, difference_type(offset)), iterator(this, difference_type(old_size)), end());
+   rotate_back_(offset, old_size);
    return iterator(this, difference_type(offset));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::insert(const_iterator pos, size_type count, const value_type& value) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::insert(const_iterator pos, size_type count, const value_type& value) {
    if (count > 1) {
       size_type offset = pos - begin();
       size_type old_size = size_;
       push_back_n_(count, value);
-      std::rotate(iterator(this, difference_type(offset)), iterator(this, difference_type(old_size)), end());
+      rotate_back_(offset, old_size);
       return iterator(this, difference_type(offset));
    } else if (count == 1) {
       size_type offset = pos - begin();
       size_type old_size = size_;
       push_back(value);
-      std::rotate(iterator(this, difference_type(offset)), iterator(this, difference_type(old_size)), end());
+      rotate_back_(offset, old_size);
       return iterator(this, difference_type(offset));
    } else {
       return end();
@@ -460,19 +544,19 @@ ChunkedList<T, A, N, M, S>::insert(const_iterator pos, size_type count, const va
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename I, typename>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::insert(const_iterator pos, I first, I last) {
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::insert(const_iterator pos, I first, I last) {
    size_type offset = pos - begin();
-   insert_(pos, first, last, std::iterator_traits<I>::iterator_category());
+   insert_(pos, first, last, typename std::iterator_traits<I>::iterator_category());
    return iterator(this, difference_type(offset));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::insert(const_iterator pos, std::initializer_list<value_type> il) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::insert(const_iterator pos, std::initializer_list<value_type> il) {
    using cat = typename std::iterator_traits<typename std::initializer_list<value_type>::iterator>::iterator_category;
    size_type offset = pos - begin();
    insert_(pos, il.begin(), il.end(), cat());
@@ -480,20 +564,20 @@ ChunkedList<T, A, N, M, S>::insert(const_iterator pos, std::initializer_list<val
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename... P>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::emplace(const_iterator pos, P&&... args) {
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::emplace(const_iterator pos, P&&... args) {
    size_type offset = pos - begin();
    size_type old_size = size_;
    emplace_back(std::forward<P>(args)...);
-   std::rotate(iterator(this, difference_type(offset)), iterator(this, difference_type(old_size)), end());
+   rotate_back_(offset, old_size);
    return iterator(this, difference_type(offset));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::push_back(const value_type& value) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::push_back(const value_type& value) {
    size_type index = size_ % chunk_size;
    pointer ptr;
    if (index > 0) {
@@ -508,8 +592,8 @@ void ChunkedList<T, A, N, M, S>::push_back(const value_type& value) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::push_back(value_type&& value) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::push_back(value_type&& value) {
    size_type index = size_ % chunk_size;
    pointer ptr;
    if (index > 0) {
@@ -524,9 +608,9 @@ void ChunkedList<T, A, N, M, S>::push_back(value_type&& value) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename... P>
-void ChunkedList<T, A, N, M, S>::emplace_back(P&&... args) {
+void ChunkedList<T, A, N, M, S, X>::emplace_back(P&&... args) {
    size_type index = size_ % chunk_size;
    pointer ptr;
    if (index > 0) {
@@ -540,37 +624,49 @@ void ChunkedList<T, A, N, M, S>::emplace_back(P&&... args) {
    ++size_;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends copies of every element in range to the end of the
+///         container.
+///
+/// \details All required nodes are allocated before any elements are
+///         constructed, and elements are then written one node at a time.
+///         Contiguous ranges of a trivially copyable value_type (arrays,
+///         std::vector, gsl::span, etc.) are copied with memcpy.  If an
+///         exception is thrown, the container is left unchanged (although
+///         its capacity may have grown).
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+template <typename R>
+void ChunkedList<T, A, N, M, S, X>::append_range(R&& range) {
+   if constexpr (detail::ChunkedListIsContiguousRange<R, value_type>::value) {
+      const value_type* data = std::data(range);
+      insert_back_(data, data + std::size(range), std::random_access_iterator_tag());
+   } else {
+      using std::begin;
+      using std::end;
+      auto first = begin(range);
+      auto last = end(range);
+      insert_back_(first, last, typename std::iterator_traits<decltype(first)>::iterator_category());
+   }
+}
+
 #pragma endregion
 #pragma region removal
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::pop_back() {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::pop_back() {
    size_type new_size = size_ - 1;
    size_type node_index = new_size / chunk_size;
    size_type index = new_size % chunk_size;
 
-   metanode* prev = nullptr;
-   metanode* meta = nullptr;
-   size_type meta_index;
-   pointer& node = get_node_(node_index, prev, meta, meta_index);
+   pointer node = get_node_(node_index);
 
    node[index].~T();
    --size_;
 
    if (index == 0) {
-      // destroy node
-      dealloc_node_(node);
-      node = nullptr;
-
-      if (meta && meta_index == 0) {
-         // destroy/dealloc metanode, set previous metanode/staticmetanode next pointer to nullptr
-         if (prev) {
-            prev->next = delete_meta_(meta);
-         } else {
-            this->get_static_metanode_().next = delete_meta_(meta);
-         }
-      }
+      // destroy this node, along with any spare nodes/metanodes after it
+      deallocate_nodes_(node_index);
    }
 }
 
@@ -578,8 +674,8 @@ void ChunkedList<T, A, N, M, S>::pop_back() {
 /// \brief  Removes all elements from the container.
 ///
 /// \details Invalidates all iterators and references.
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::clear() noexcept {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::clear() noexcept {
    // destroy all elements
    for (iterator i = begin(), e = end(); i != e; ++i) {
       (*i).~T();
@@ -595,9 +691,9 @@ void ChunkedList<T, A, N, M, S>::clear() noexcept {
 ///
 /// \details All iterators and references to the removed element or any
 ///         subsequent elements are invalidated.
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::erase(const_iterator pos) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::erase(const_iterator pos) {
    return erase(pos, pos + 1);
 }
 
@@ -607,9 +703,9 @@ ChunkedList<T, A, N, M, S>::erase(const_iterator pos) {
 ///
 /// \details All iterators and references to removed elements or any element
 ///         after the first removed element will be invalidated.
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::iterator
-ChunkedList<T, A, N, M, S>::erase(const_iterator first, const_iterator last) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::iterator
+ChunkedList<T, A, N, M, S, X>::erase(const_iterator first, const_iterator last) {
    // check that iterators belong to this container and are not out-of-bounds
    assert(first >= begin());
    assert(last <= end());
@@ -618,18 +714,25 @@ ChunkedList<T, A, N, M, S>::erase(const_iterator first, const_iterator last) {
    size_type offset = first - begin();
 
    if (first < last) {
-      iterator old_end(end());
       size_type new_size = size_ - (last - first);
-      iterator new_end(this, new_size);
 
-      // move [last, end) to [first, first + end - last)
-      for (iterator si(last), di(first); si != old_end; ++si, ++di) {
-         std::iter_swap(di, si);
-      }
+      if constexpr (std::is_trivially_copyable<value_type>::value) {
+         // move [last, end) to [first, first + end - last); no destructors need to run
+         size_type src = last - begin();
+         relocate_(offset, src, size_ - src);
+      } else {
+         iterator old_end(end());
+         iterator new_end(this, new_size);
 
-      // destroy [new_end, end)
-      for (iterator i(new_end); i != old_end; ++i) {
-         (*i).~T();
+         // move [last, end) to [first, first + end - last)
+         for (iterator si(last), di(first); si != old_end; ++si, ++di) {
+            std::iter_swap(di, si);
+         }
+
+         // destroy [new_end, end)
+         for (iterator i(new_end); i != old_end; ++i) {
+            (*i).~T();
+         }
       }
 
       // deallocate nodes/metanodes used exclusively for [new_end, end)
@@ -649,15 +752,15 @@ ChunkedList<T, A, N, M, S>::erase(const_iterator first, const_iterator last) {
 #pragma region misc
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::allocator_type
-ChunkedList<T, A, N, M, S>::get_allocator() const {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::allocator_type
+ChunkedList<T, A, N, M, S, X>::get_allocator() const {
    return static_cast<allocator_type>(this->get_node_alloc_());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::resize(size_type count) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::resize(size_type count) {
    if (count < size_) {
       // pop back (size_ - count) elements
       this->erase(const_iterator(this, difference_type(count)), end());
@@ -668,8 +771,8 @@ void ChunkedList<T, A, N, M, S>::resize(size_type count) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::resize(size_type count, const value_type& value) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::resize(size_type count, const value_type& value) {
    if (count < size_) {
       // pop back (size_ - count) elements
       this->erase(const_iterator(this, difference_type(size_ - count)), end());
@@ -685,46 +788,82 @@ void ChunkedList<T, A, N, M, S>::resize(size_type count, const value_type& value
 /// \details All references to elements remain valid, but all iterators are
 ///         invalidated.  This behavior differs from that of standard-library
 ///         containers.
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::swap(container& other) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::swap(container& other) {
    using std::swap;
    if (this == &other) {
       // nop
    } else if (this->get_node_alloc_() == other.get_node_alloc_()) {
       swap(size_, other.size_);
       swap(this->get_static_metanode_(), other.get_static_metanode_());
-   } else if (node_alloc::propagate_on_container_swap::value) {
-      this->swap_allocators_();
+      this->index_swap_(other);
+   } else if (std::allocator_traits<node_alloc>::propagate_on_container_swap::value) {
+      this->swap_allocators_(other);
       swap(size_, other.size_);
       swap(this->get_static_metanode_(), other.get_static_metanode_());
+      this->index_swap_(other);
    } else {
       // containers are incompatible
       assert(false);
    }
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calls func once for each data node, in order, passing a
+///         chunk_type span covering the node's elements.
+///
+/// \details Every span is non-empty and only the last may hold fewer than
+///         chunk_size elements.  Nodes are found by walking the metanode
+///         chain directly, so visiting every chunk is O(N) even for
+///         unindexed containers.  func must not change the container's
+///         size.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+template <typename F>
+void ChunkedList<T, A, N, M, S, X>::for_each_chunk(F&& func) {
+   auto visitor = [&func](pointer node, size_type count) {
+      func(chunk_type(node, count));
+   };
+   for_each_node_(visitor);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calls func once for each data node, in order, passing a
+///         const_chunk_type span covering the node's elements.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+template <typename F>
+void ChunkedList<T, A, N, M, S, X>::for_each_chunk(F&& func) const {
+   auto visitor = [&func](const_pointer node, size_type count) {
+      func(const_chunk_type(node, count));
+   };
+   for_each_node_(visitor);
+}
+
 #pragma endregion
 #pragma region private
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::size_type
-ChunkedList<T, A, N, M, S>::get_node_index_(size_type pos) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::get_node_index_(size_type pos) {
    return pos / chunk_size;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::size_type
-ChunkedList<T, A, N, M, S>::get_node_index_(size_type pos, size_type& index) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::get_node_index_(size_type pos, size_type& index) {
    index = pos % chunk_size;
    return pos / chunk_size;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::pointer
-ChunkedList<T, A, N, M, S>::get_node_(size_type node_index) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::pointer
+ChunkedList<T, A, N, M, S, X>::get_node_(size_type node_index) {
+   if constexpr (indexed) {
+      return this->index_get_(node_index);
+   }
+
    if (node_index < static_chunks) {
       assert(this->get_static_metanode_().nodes[node_index]);
       return this->get_static_metanode_().nodes[node_index];
@@ -745,9 +884,9 @@ ChunkedList<T, A, N, M, S>::get_node_(size_type node_index) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::pointer&
-ChunkedList<T, A, N, M, S>::get_node_(size_type node_index,
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::pointer&
+ChunkedList<T, A, N, M, S, X>::get_node_(size_type node_index,
                                       metanode*& prev_meta,
                                       metanode*& meta,
                                       size_type& meta_index) {
@@ -776,9 +915,9 @@ ChunkedList<T, A, N, M, S>::get_node_(size_type node_index,
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::metanode*
-ChunkedList<T, A, N, M, S>::get_last_meta_(size_type& meta_index) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::metanode*
+ChunkedList<T, A, N, M, S, X>::get_last_meta_(size_type& meta_index) {
    if (size_ == 0) {
       meta_index = static_chunks;
       return nullptr;
@@ -805,25 +944,36 @@ ChunkedList<T, A, N, M, S>::get_last_meta_(size_type& meta_index) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::pointer
-ChunkedList<T, A, N, M, S>::alloc_node_() {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::pointer
+ChunkedList<T, A, N, M, S, X>::alloc_node_() {
    // allocated memory has no effective type so reinterpret_cast shouldn't
    // cause any strict aliasing issues
-   return reinterpret_cast<pointer>(this->get_node_alloc_().allocate(1));
+   pointer node = reinterpret_cast<pointer>(this->get_node_alloc_().allocate(1));
+
+   // nodes are always allocated in order, so a new node always belongs at the
+   // end of the index.
+   try {
+      this->index_push_(node);
+   } catch (...) {
+      dealloc_node_(node);
+      throw;
+   }
+
+   return node;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 void
-ChunkedList<T, A, N, M, S>::dealloc_node_(pointer node) {
+ChunkedList<T, A, N, M, S, X>::dealloc_node_(pointer node) {
    this->get_node_alloc_().deallocate(reinterpret_cast<typename node_alloc::pointer>(node), 1);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::pointer
-ChunkedList<T, A, N, M, S>::get_push_node_() {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::pointer
+ChunkedList<T, A, N, M, S, X>::get_push_node_() {
    size_type meta_index;
    metanode* meta = get_last_meta_(meta_index);
    ++meta_index;
@@ -866,17 +1016,17 @@ ChunkedList<T, A, N, M, S>::get_push_node_() {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::metanode*
-ChunkedList<T, A, N, M, S>::new_meta_() {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::metanode*
+ChunkedList<T, A, N, M, S, X>::new_meta_() {
    metanode* meta = this->get_meta_alloc_().allocate(1);
    return new (meta) metanode();
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::metanode*
-ChunkedList<T, A, N, M, S>::delete_meta_(metanode* meta) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::metanode*
+ChunkedList<T, A, N, M, S, X>::delete_meta_(metanode* meta) {
    metanode* next = meta->next;
    (*meta).~metanode();
    this->get_meta_alloc_().deallocate(meta, 1);
@@ -884,8 +1034,8 @@ ChunkedList<T, A, N, M, S>::delete_meta_(metanode* meta) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::cleanup_() {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::cleanup_() {
    size_type index;
    size_type node_index = this->get_node_index_(size_, index);
    if (index > 0) {
@@ -898,8 +1048,10 @@ void ChunkedList<T, A, N, M, S>::cleanup_() {
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Deallocates all nodes with indices >= first_index and cleans up any
 ///         metanodes that are no longer necessary.
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::deallocate_nodes_(size_type first_index) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::deallocate_nodes_(size_type first_index) {
+   this->index_truncate_(first_index);
+
    if (first_index <= static_chunks) {
       // deallocate static nodes & set to null
       for (size_type i = first_index; i < static_chunks; ++i) {
@@ -948,7 +1100,8 @@ void ChunkedList<T, A, N, M, S>::deallocate_nodes_(size_type first_index) {
                return; // end of nodes found
             }
 
-            dealloc_node_(meta->nodes[i]);
+            dealloc_node_(ptr);
+            ptr = nullptr;
          }
 
          delete_metanodes_(meta->next);
@@ -961,8 +1114,8 @@ void ChunkedList<T, A, N, M, S>::deallocate_nodes_(size_type first_index) {
 /// \brief  Deallocates all nodes in the provided metanode and deallocates the
 ///         metanode itself.  If meta->next is nonnull, it will recursively
 ///         deallocate that node as well.
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::delete_metanodes_(metanode* meta) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::delete_metanodes_(metanode* meta) {
    while (meta) {
       for (size_type i = 0; i < chunks_per_metanode; ++i) {
          pointer& ptr = meta->nodes[i];
@@ -978,9 +1131,239 @@ void ChunkedList<T, A, N, M, S>::delete_metanodes_(metanode* meta) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::size_type
-ChunkedList<T, A, N, M, S>::get_capacity_() const {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+template <typename F>
+void ChunkedList<T, A, N, M, S, X>::for_each_node_(F& func) const {
+   size_type remaining = size_;
+
+   for (size_type i = 0; i < static_chunks && remaining > 0; ++i) {
+      size_type count = std::min(remaining, size_type(chunk_size));
+      func(this->get_static_metanode_().nodes[i], count);
+      remaining -= count;
+   }
+
+   const metanode* meta = this->get_static_metanode_().next;
+   while (remaining > 0) {
+      assert(meta);
+      for (size_type i = 0; i < chunks_per_metanode && remaining > 0; ++i) {
+         size_type count = std::min(remaining, size_type(chunk_size));
+         func(meta->nodes[i], count);
+         remaining -= count;
+      }
+      meta = meta->next;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calls func(ptr, n) for each contiguous run of elements in
+///         [pos, pos + count).
+///
+/// \details The positions must be within the container's capacity, but need
+///         not be below size().  The metanode chain is walked only once.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+template <typename F>
+void ChunkedList<T, A, N, M, S, X>::for_each_segment_(size_type pos, size_type count, F func) {
+   size_type index;
+   size_type node_index = get_node_index_(pos, index);
+
+   for (; node_index < static_chunks && count > 0; ++node_index) {
+      size_type n = std::min(count, chunk_size - index);
+      func(this->get_static_metanode_().nodes[node_index] + index, n);
+      count -= n;
+      index = 0;
+   }
+
+   if (count == 0) {
+      return;
+   }
+
+   size_type meta_index = node_index - static_chunks;
+   metanode* meta = this->get_static_metanode_().next;
+   while (meta_index >= chunks_per_metanode) {
+      assert(meta);
+      meta = meta->next;
+      meta_index -= chunks_per_metanode;
+   }
+
+   while (count > 0) {
+      assert(meta && meta->nodes[meta_index]);
+      size_type n = std::min(count, chunk_size - index);
+      func(meta->nodes[meta_index] + index, n);
+      count -= n;
+      index = 0;
+      if (++meta_index == chunks_per_metanode) {
+         meta = meta->next;
+         meta_index = 0;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes pointers to count consecutive data nodes, starting with
+///         first_node, to out.  The metanode chain is walked only once.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::get_nodes_(size_type first_node, size_type count, pointer* out) {
+   size_type node_index = first_node;
+   size_type end = first_node + count;
+
+   for (; node_index < static_chunks && node_index < end; ++node_index) {
+      *out++ = this->get_static_metanode_().nodes[node_index];
+   }
+
+   if (node_index == end) {
+      return;
+   }
+
+   size_type meta_index = node_index - static_chunks;
+   metanode* meta = this->get_static_metanode_().next;
+   while (meta_index >= chunks_per_metanode) {
+      assert(meta);
+      meta = meta->next;
+      meta_index -= chunks_per_metanode;
+   }
+
+   for (; node_index < end; ++node_index) {
+      assert(meta && meta->nodes[meta_index]);
+      *out++ = meta->nodes[meta_index];
+      if (++meta_index == chunks_per_metanode) {
+         meta = meta->next;
+         meta_index = 0;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Moves the elements in [src, src + count) to
+///         [dest, dest + count) using memmove, one contiguous run at a time.
+///
+/// \details Only valid for trivially copyable types.  The ranges may
+///         overlap; all positions must be within the container's capacity.
+///         Does not throw; if the temporary array of node pointers can't be
+///         allocated, nodes are looked up individually instead.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::relocate_(size_type dest, size_type src, size_type count) {
+   static_assert(std::is_trivially_copyable<value_type>::value, "relocate_() requires a trivially copyable type");
+
+   if (dest == src || count == 0) {
+      return;
+   }
+
+   size_type first_node = std::min(dest, src) / chunk_size;
+   size_type n_nodes = (std::max(dest, src) + count - 1) / chunk_size - first_node + 1;
+
+   constexpr size_type local_size = 32;
+   pointer local[local_size];
+   std::unique_ptr<pointer[]> heap;
+   pointer* nodes = nullptr;
+
+   if constexpr (!indexed) {
+      if (n_nodes <= local_size) {
+         nodes = local;
+      } else {
+         heap.reset(new (std::nothrow) pointer[n_nodes]);
+         nodes = heap.get();
+      }
+
+      if (nodes) {
+         get_nodes_(first_node, n_nodes, nodes);
+      }
+   }
+
+   auto node = [&](size_type node_index) {
+      return nodes ? nodes[node_index - first_node] : get_node_(node_index);
+   };
+
+   if (dest < src) {
+      while (count > 0) {
+         size_type src_index = src % chunk_size;
+         size_type dest_index = dest % chunk_size;
+         size_type n = std::min(count, chunk_size - std::max(src_index, dest_index));
+         std::memmove(node(dest / chunk_size) + dest_index,
+                      node(src / chunk_size) + src_index,
+                      n * sizeof(value_type));
+         src += n;
+         dest += n;
+         count -= n;
+      }
+   } else {
+      // work backwards from the end so that no element is overwritten before it is moved
+      size_type src_end = src + count;
+      size_type dest_end = dest + count;
+      while (count > 0) {
+         size_type src_index = (src_end - 1) % chunk_size;
+         size_type dest_index = (dest_end - 1) % chunk_size;
+         size_type n = std::min(count, std::min(src_index, dest_index) + 1);
+         std::memmove(node((dest_end - 1) / chunk_size) + dest_index + 1 - n,
+                      node((src_end - 1) / chunk_size) + src_index + 1 - n,
+                      n * sizeof(value_type));
+         src_end -= n;
+         dest_end -= n;
+         count -= n;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Rotates the elements in [old_size, size_) (which have just been
+///         appended) so that they begin at offset.
+///
+/// \details For trivially copyable types, the smaller of the two ranges is
+///         copied to a temporary buffer and the larger one is moved with
+///         relocate_().  Otherwise (or if a temporary buffer can't be
+///         allocated) std::rotate is used.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::rotate_back_(size_type offset, size_type old_size) {
+   if constexpr (std::is_trivially_copyable<value_type>::value) {
+      size_type n_new = size_ - old_size;
+      size_type n_old = old_size - offset;
+      if (n_new == 0 || n_old == 0) {
+         return;
+      }
+
+      constexpr size_type local_size = 256;
+      unsigned char local[local_size];
+      std::unique_ptr<unsigned char[]> heap;
+      unsigned char* buf = local;
+
+      size_type n_buf = std::min(n_new, n_old);
+      if (n_buf * sizeof(value_type) > local_size) {
+         heap.reset(new (std::nothrow) unsigned char[n_buf * sizeof(value_type)]);
+         buf = heap.get();
+      }
+
+      if (buf) {
+         auto copy_out = [&buf](pointer ptr, size_type n) {
+            std::memcpy(buf, ptr, n * sizeof(value_type));
+            buf += n * sizeof(value_type);
+         };
+         auto copy_in = [&buf](pointer ptr, size_type n) {
+            std::memcpy(ptr, buf, n * sizeof(value_type));
+            buf += n * sizeof(value_type);
+         };
+         unsigned char* buf_begin = buf;
+
+         if (n_new <= n_old) {
+            for_each_segment_(old_size, n_new, copy_out);
+            relocate_(offset + n_new, offset, n_old);
+            buf = buf_begin;
+            for_each_segment_(offset, n_new, copy_in);
+         } else {
+            for_each_segment_(offset, n_old, copy_out);
+            relocate_(offset, old_size, n_new);
+            buf = buf_begin;
+            for_each_segment_(offset + n_new, n_old, copy_in);
+         }
+         return;
+      }
+   }
+
+   std::rotate(iterator(this, difference_type(offset)), iterator(this, difference_type(old_size)), end());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::get_capacity_() const {
    size_type capacity = 0;
 
    for (size_type i = 0; i < static_chunks; ++i) {
@@ -1008,9 +1391,32 @@ ChunkedList<T, A, N, M, S>::get_capacity_() const {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::size_type
-ChunkedList<T, A, N, M, S>::get_capacity_(metanode*& last_meta) {
+/// \brief  Counts the allocated data nodes and metanodes (not including the
+///         static metanode).
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::count_nodes_(size_type& metanodes) const {
+   size_type nodes = 0;
+   metanodes = 0;
+
+   for (size_type i = 0; i < static_chunks && this->get_static_metanode_().nodes[i]; ++i) {
+      ++nodes;
+   }
+
+   for (const metanode* meta = this->get_static_metanode_().next; meta; meta = meta->next) {
+      ++metanodes;
+      for (size_type i = 0; i < chunks_per_metanode && meta->nodes[i]; ++i) {
+         ++nodes;
+      }
+   }
+
+   return nodes;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::get_capacity_(metanode*& last_meta) {
    size_type capacity = 0;
 
    for (size_type i = 0; i < static_chunks; ++i) {
@@ -1037,6 +1443,8 @@ ChunkedList<T, A, N, M, S>::get_capacity_(metanode*& last_meta) {
          if (meta->next == nullptr) {
             break;
          }
+
+         meta = meta->next;
       }
    }
 
@@ -1046,9 +1454,9 @@ ChunkedList<T, A, N, M, S>::get_capacity_(metanode*& last_meta) {
 
 ///////////////////////////////////////////////////////////////////////////////
 /// \return A pointer to the
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-typename ChunkedList<T, A, N, M, S>::size_type
-ChunkedList<T, A, N, M, S>::ensure_capacity_(size_type count) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::ensure_capacity_(size_type count) {
    if (size_ >= count) {
       return size_;
    }
@@ -1092,10 +1500,10 @@ ChunkedList<T, A, N, M, S>::ensure_capacity_(size_type count) {
 ///         could not be.
 ///
 /// \return The number of nodes requested which could not be allocated.
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename Metanode, std::size_t ChunksPerMetanode>
-typename ChunkedList<T, A, N, M, S>::size_type
-ChunkedList<T, A, N, M, S>::alloc_nodes_(Metanode* metanode, size_type count) {
+typename ChunkedList<T, A, N, M, S, X>::size_type
+ChunkedList<T, A, N, M, S, X>::alloc_nodes_(Metanode* metanode, size_type count) {
    for (size_type i = 0; count > 0 && i < ChunksPerMetanode; ++i)    {
       pointer& ptr = metanode->nodes[i];
       if (!ptr) {
@@ -1108,8 +1516,8 @@ ChunkedList<T, A, N, M, S>::alloc_nodes_(Metanode* metanode, size_type count) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::push_back_n_(size_type count) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::push_back_n_(size_type count) {
    if (count == 0) {
       return;
    }
@@ -1146,8 +1554,8 @@ void ChunkedList<T, A, N, M, S>::push_back_n_(size_type count) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::push_back_n_(size_type count, const value_type& value) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::push_back_n_(size_type count, const value_type& value) {
    if (count == 0) {
       return;
    }
@@ -1184,9 +1592,9 @@ void ChunkedList<T, A, N, M, S>::push_back_n_(size_type count, const value_type&
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename I>
-void ChunkedList<T, A, N, M, S>::insert_(const_iterator pos, I first, I last, std::input_iterator_tag) {
+void ChunkedList<T, A, N, M, S, X>::insert_(const_iterator pos, I first, I last, std::input_iterator_tag) {
    if (first != last) {
       size_type old_size = size_;
       size_type offset = pos - begin();
@@ -1200,14 +1608,14 @@ void ChunkedList<T, A, N, M, S>::insert_(const_iterator pos, I first, I last, st
          throw;
       }
 
-      std::rotate(iterator(this, difference_type(offset)), iterator(this, difference_type(old_size)), end());
+      rotate_back_(offset, old_size);
    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename I>
-void ChunkedList<T, A, N, M, S>::insert_(const_iterator pos, I first, I last, std::forward_iterator_tag) {
+void ChunkedList<T, A, N, M, S, X>::insert_(const_iterator pos, I first, I last, std::forward_iterator_tag) {
    size_type offset = pos - begin();
    size_type old_size = size_;
    size_type count = std::distance(first, last);
@@ -1218,42 +1626,16 @@ void ChunkedList<T, A, N, M, S>::insert_(const_iterator pos, I first, I last, st
    ensure_capacity_(size_ + count);
 
    // construct new entries at back
-   size_type node_index = size_ / chunk_size;
-   size_type index = size_ % chunk_size;
-
-   try {
-      pointer node = get_node_(node_index);
-      for (size_type i = 0;;) {
-         new (node + index) value_type(*first);
-         ++size_;
-         ++first;
-
-         ++i;
-         if (i == count) {
-            break;
-         }
-
-         if (index < chunk_size - 1) {
-            ++index;
-         } else {
-            ++node_index;
-            index = 0;
-            node = get_node_(node_index);
-         }
-      }
-   } catch (...) {
-      erase(iterator(this, difference_type(old_size)), end());
-      throw;
-   }
+   construct_back_(first, count);
 
    // place new entries correctly
-   std::rotate(iterator(this, difference_type(offset)), iterator(this, difference_type(old_size)), end());
+   rotate_back_(offset, old_size);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename I>
-void ChunkedList<T, A, N, M, S>::insert_back_(I first, I last, std::input_iterator_tag) {
+void ChunkedList<T, A, N, M, S, X>::insert_back_(I first, I last, std::input_iterator_tag) {
    if (first != last) {
       size_type old_size = size_;
       try {
@@ -1269,50 +1651,71 @@ void ChunkedList<T, A, N, M, S>::insert_back_(I first, I last, std::input_iterat
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename I>
-void ChunkedList<T, A, N, M, S>::insert_back_(I first, I last, std::forward_iterator_tag) {
-   size_type old_size = size_;
+void ChunkedList<T, A, N, M, S, X>::insert_back_(I first, I last, std::forward_iterator_tag) {
    size_type count = std::distance(first, last);
    if (count == 0)
       return;
 
    ensure_capacity_(size_ + count);
+   construct_back_(first, count);
+}
 
-   // construct new entries at back
-   size_type node_index = size_ / chunk_size;
-   size_type index = size_ % chunk_size;
-
-   try {
-      pointer node = get_node_(node_index);
-      for (size_type i = 0;;) {
-         new (node + index) value_type(*first);
-         ++size_;
-         ++first;
-
-         ++i;
-         if (i == count) {
-            break;
-         }
-
-         if (index < chunk_size - 1) {
-            ++index;
-         } else {
-            ++node_index;
-            index = 0;
-            node = get_node_(node_index);
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Copy-constructs count elements starting at first into the
+///         already-allocated space at the back of the container.
+///
+/// \details When value_type is trivially copyable and the source is a
+///         pointer or another ChunkedList iterator, whole runs are copied
+///         with memcpy.  Otherwise, if a constructor throws, the elements
+///         already appended are destroyed before rethrowing.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+template <typename I>
+void ChunkedList<T, A, N, M, S, X>::construct_back_(I first, size_type count) {
+   constexpr bool trivial = std::is_trivially_copyable<value_type>::value;
+   constexpr bool from_pointer = std::is_same<I, value_type*>::value || std::is_same<I, const value_type*>::value;
+   constexpr bool from_segments = std::is_same<I, iterator>::value || std::is_same<I, const_iterator>::value;
+
+   if constexpr (trivial && from_pointer) {
+      for_each_segment_(size_, count, [&](pointer ptr, size_type n) {
+         std::memcpy(ptr, first, n * sizeof(value_type));
+         first += n;
+      });
+      size_ += count;
+   } else if constexpr (trivial && from_segments) {
+      for_each_segment_(size_, count, [&](pointer ptr, size_type n) {
+         while (n > 0) {
+            auto segment = first.segment();
+            size_type run = std::min(n, size_type(segment.size()));
+            std::memcpy(ptr, segment.data(), run * sizeof(value_type));
+            ptr += run;
+            n -= run;
+            first += difference_type(run);
          }
+      });
+      size_ += count;
+   } else {
+      size_type old_size = size_;
+      try {
+         for_each_segment_(size_, count, [&](pointer ptr, size_type n) {
+            for (pointer last = ptr + n; ptr != last; ++ptr) {
+               new (ptr) value_type(*first);
+               ++size_;
+               ++first;
+            }
+         });
+      } catch (...) {
+         erase(iterator(this, difference_type(old_size)), end());
+         throw;
       }
-   } catch (...) {
-      erase(iterator(this, difference_type(old_size)), end());
-      throw;
    }
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename I>
-void ChunkedList<T, A, N, M, S>::assign_(I first, I last, std::input_iterator_tag) {
+void ChunkedList<T, A, N, M, S, X>::assign_(I first, I last, std::input_iterator_tag) {
    for (iterator i = begin(), e = end(); i != e; ++i) {
       (*i).~T();
    }
@@ -1323,9 +1726,9 @@ void ChunkedList<T, A, N, M, S>::assign_(I first, I last, std::input_iterator_ta
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
 template <typename I>
-void ChunkedList<T, A, N, M, S>::assign_(I first, I last, std::forward_iterator_tag) {
+void ChunkedList<T, A, N, M, S, X>::assign_(I first, I last, std::forward_iterator_tag) {
    for (iterator i = begin(), e = end(); i != e; ++i) {
       (*i).~T();
    }
@@ -1336,8 +1739,8 @@ void ChunkedList<T, A, N, M, S>::assign_(I first, I last, std::forward_iterator_
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::assign_(const_iterator first, const_iterator last, std::random_access_iterator_tag) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::assign_(const_iterator first, const_iterator last, std::random_access_iterator_tag) {
    if (first.container_ == this) {
       erase(last, end());
       erase(begin(), first);
@@ -1348,8 +1751,8 @@ void ChunkedList<T, A, N, M, S>::assign_(const_iterator first, const_iterator la
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::assign_(iterator first, iterator last, std::random_access_iterator_tag) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::assign_(iterator first, iterator last, std::random_access_iterator_tag) {
    if (first.container_ == this)    {
       erase(last, end());
       erase(begin(), first);
@@ -1360,8 +1763,8 @@ void ChunkedList<T, A, N, M, S>::assign_(iterator first, iterator last, std::ran
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-void ChunkedList<T, A, N, M, S>::move_assign_(const_iterator first, const_iterator last) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+void ChunkedList<T, A, N, M, S, X>::move_assign_(const_iterator first, const_iterator last) {
    for (iterator i = begin(), e = end(); i != e; ++i) {
       (*i).~T();
    }
@@ -1408,44 +1811,44 @@ void ChunkedList<T, A, N, M, S>::move_assign_(const_iterator first, const_iterat
 #pragma region comparison operators
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator==(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator==(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right) {
    return left.size() == right.size() && std::equal(left.begin(), left.end(), right.begin());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator!=(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator!=(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right) {
    return !(left == right);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator<(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator<(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right) {
    return std::lexicographical_compare(left.begin(), left.end(), right.begin(), right.end());
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator>(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator>(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right) {
    return right < left;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator<=(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator<=(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right) {
    return !(right < left);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-bool operator>=(ChunkedList<T, A, N, M, S>& left, ChunkedList<T, A, N, M, S>& right) {
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+bool operator>=(ChunkedList<T, A, N, M, S, X>& left, ChunkedList<T, A, N, M, S, X>& right) {
    return !(left < right);
 }
 
 /////////////////////////////////////////////////////////////////////////////////
-//template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
-//void PrintTraits<ChunkedList<T, A, N, M, S>>::name(std::ostream& os, const ChunkedList<T, A, N, M, S>&) const
+//template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X>
+//void PrintTraits<ChunkedList<T, A, N, M, S, X>>::name(std::ostream& os, const ChunkedList<T, A, N, M, S, X>&) const
 //{
 //   detail::containerName<T>(os, "ChunkedList");
 //}
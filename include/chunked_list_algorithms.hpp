@@ -0,0 +1,41 @@
+#pragma once
+#ifndef BE_UTIL_CHUNKED_LIST_ALGORITHMS_HPP_
+#define BE_UTIL_CHUNKED_LIST_ALGORITHMS_HPP_
+
+#include "chunked_list.hpp"
+
+///////////////////////////////////////////////////////////////////////////////
+/// \file   chunked_list_algorithms.hpp
+/// \brief  Segmented versions of common standard algorithms for ChunkedList.
+///
+/// \details Each algorithm processes one contiguous node at a time using
+///         ChunkedListConstIterator::segment(), so the inner loops operate
+///         on raw pointers which the compiler can vectorize (and which allow
+///         std::copy/std::fill to use memmove/memset for trivial types).
+///         Call these qualified (e.g. `util::copy(...)`) since unqualified
+///         calls may also find the std:: versions through ADL.
+namespace be::util {
+
+template <typename C, typename O>
+O copy(detail::ChunkedListConstIterator<C> first, detail::ChunkedListConstIterator<C> last, O out);
+
+template <typename C, typename V>
+void fill(detail::ChunkedListIterator<C> first, detail::ChunkedListIterator<C> last, const V& value);
+
+template <typename C, typename V>
+detail::ChunkedListConstIterator<C> find(detail::ChunkedListConstIterator<C> first, detail::ChunkedListConstIterator<C> last, const V& value);
+
+template <typename C, typename V>
+detail::ChunkedListIterator<C> find(detail::ChunkedListIterator<C> first, detail::ChunkedListIterator<C> last, const V& value);
+
+template <typename C, typename V>
+V accumulate(detail::ChunkedListConstIterator<C> first, detail::ChunkedListConstIterator<C> last, V init);
+
+template <typename C, typename V, typename F>
+V accumulate(detail::ChunkedListConstIterator<C> first, detail::ChunkedListConstIterator<C> last, V init, F op);
+
+} // be::util
+
+#include "chunked_list_algorithms.inl"
+
+#endif
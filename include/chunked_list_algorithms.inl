@@ -0,0 +1,97 @@
+#if !defined(BE_UTIL_CHUNKED_LIST_ALGORITHMS_HPP_) && !defined(DOXYGEN)
+#include "chunked_list_algorithms.hpp"
+#elif !defined(BE_UTIL_CHUNKED_LIST_ALGORITHMS_INL_)
+#define BE_UTIL_CHUNKED_LIST_ALGORITHMS_INL_
+
+#include <algorithm>
+#include <numeric>
+
+namespace be::util {
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C, typename O>
+O copy(detail::ChunkedListConstIterator<C> first, detail::ChunkedListConstIterator<C> last, O out) {
+   using difference_type = typename C::difference_type;
+   difference_type remaining = last - first;
+   while (remaining > 0) {
+      auto seg = first.segment();
+      difference_type count = std::min(difference_type(seg.size()), remaining);
+      out = std::copy(seg.data(), seg.data() + count, out);
+      first += count;
+      remaining -= count;
+   }
+   return out;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C, typename V>
+void fill(detail::ChunkedListIterator<C> first, detail::ChunkedListIterator<C> last, const V& value) {
+   using difference_type = typename C::difference_type;
+   difference_type remaining = last - first;
+   while (remaining > 0) {
+      auto seg = first.segment();
+      difference_type count = std::min(difference_type(seg.size()), remaining);
+      std::fill(seg.data(), seg.data() + count, value);
+      first += count;
+      remaining -= count;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C, typename V>
+detail::ChunkedListConstIterator<C> find(detail::ChunkedListConstIterator<C> first, detail::ChunkedListConstIterator<C> last, const V& value) {
+   using difference_type = typename C::difference_type;
+   difference_type remaining = last - first;
+   while (remaining > 0) {
+      auto seg = first.segment();
+      difference_type count = std::min(difference_type(seg.size()), remaining);
+      auto it = std::find(seg.data(), seg.data() + count, value);
+      if (it != seg.data() + count) {
+         return first + (it - seg.data());
+      }
+      first += count;
+      remaining -= count;
+   }
+   return last;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C, typename V>
+detail::ChunkedListIterator<C> find(detail::ChunkedListIterator<C> first, detail::ChunkedListIterator<C> last, const V& value) {
+   using const_iterator = detail::ChunkedListConstIterator<C>;
+   return first + (util::find(const_iterator(first), const_iterator(last), value) - first);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C, typename V>
+V accumulate(detail::ChunkedListConstIterator<C> first, detail::ChunkedListConstIterator<C> last, V init) {
+   using difference_type = typename C::difference_type;
+   difference_type remaining = last - first;
+   while (remaining > 0) {
+      auto seg = first.segment();
+      difference_type count = std::min(difference_type(seg.size()), remaining);
+      init = std::accumulate(seg.data(), seg.data() + count, std::move(init));
+      first += count;
+      remaining -= count;
+   }
+   return init;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C, typename V, typename F>
+V accumulate(detail::ChunkedListConstIterator<C> first, detail::ChunkedListConstIterator<C> last, V init, F op) {
+   using difference_type = typename C::difference_type;
+   difference_type remaining = last - first;
+   while (remaining > 0) {
+      auto seg = first.segment();
+      difference_type count = std::min(difference_type(seg.size()), remaining);
+      init = std::accumulate(seg.data(), seg.data() + count, std::move(init), op);
+      first += count;
+      remaining -= count;
+   }
+   return init;
+}
+
+} // be::util
+
+#endif
@@ -2,6 +2,8 @@
 #ifndef BE_UTIL_CHUNKED_LIST_CONST_ITERATOR_HPP_
 #define BE_UTIL_CHUNKED_LIST_CONST_ITERATOR_HPP_
 
+#include <gsl/span>
+#include <algorithm>
 #include <cassert>
 
 namespace be::util {
@@ -11,13 +13,14 @@ template <typename C>
 class ChunkedListConstIterator {
    using iterator = ChunkedListConstIterator<C>;
    using node_ptr = typename C::pointer;
-   friend typename C;
+   friend C;
 public:
    using iterator_category = std::random_access_iterator_tag;
    using value_type = typename C::value_type;
    using difference_type = typename C::difference_type;
    using pointer = typename C::const_pointer;
    using reference = typename C::const_reference;
+   using segment_type = gsl::span<const value_type>;
 
    ChunkedListConstIterator() { }
 
@@ -43,9 +46,13 @@ public:
    bool operator<=(const iterator& other) const;
    bool operator>=(const iterator& other) const;
 
+   segment_type segment() const;
+
 protected:
    ChunkedListConstIterator(const C* c, difference_type offset);
 
+   node_ptr get_segment_(difference_type& count) const;
+
    difference_type offset_;
    mutable difference_type node_index_;
    mutable node_ptr node_;
@@ -142,6 +142,22 @@ bool ChunkedListConstIterator<C>::operator>=(const iterator& other) const {
    return !(*this < other);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the contiguous run of elements starting at this
+///         iterator and extending to the end of its node (or the end of the
+///         container, whichever comes first).
+///
+/// \details The segment is empty if the iterator is not dereferenceable.
+///         Iterating over segments rather than individual elements allows
+///         the node lookup to be performed once per node instead of once
+///         per element.
+template <typename C>
+typename ChunkedListConstIterator<C>::segment_type ChunkedListConstIterator<C>::segment() const {
+   difference_type count;
+   node_ptr ptr = get_segment_(count);
+   return segment_type(ptr, count);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 template <typename C>
 ChunkedListConstIterator<C>::ChunkedListConstIterator(const C* c, difference_type offset)
@@ -151,6 +167,27 @@ ChunkedListConstIterator<C>::ChunkedListConstIterator(const C* c, difference_typ
      container_(const_cast<C*>(c))
 { }
 
+///////////////////////////////////////////////////////////////////////////////
+template <typename C>
+typename ChunkedListConstIterator<C>::node_ptr ChunkedListConstIterator<C>::get_segment_(difference_type& count) const {
+   difference_type remaining = difference_type(container_->size()) - offset_;
+   if (offset_ < 0 || remaining <= 0) {
+      count = 0;
+      return nullptr;
+   }
+
+   difference_type node_index = offset_ / C::chunk_size;
+   difference_type index = offset_ % C::chunk_size;
+
+   if (node_index_ != node_index) {
+      node_ = container_->get_node_(node_index);
+      node_index_ = node_index;
+   }
+
+   count = std::min(difference_type(C::chunk_size) - index, remaining);
+   return node_ + index;
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 template <typename C>
 ChunkedListConstIterator<C> operator+(typename ChunkedListConstIterator<C>::difference_type offset, ChunkedListConstIterator<C> iter) {
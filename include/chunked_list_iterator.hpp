@@ -11,13 +11,14 @@ template<typename C>
 class ChunkedListIterator : public ChunkedListConstIterator<C> {
    using iterator = ChunkedListIterator<C>;
    using const_iterator = ChunkedListConstIterator<C>;
-   friend typename C;
+   friend C;
 public:
    using iterator_category = std::random_access_iterator_tag;
    using value_type = typename C::value_type;
    using difference_type = typename C::difference_type;
    using pointer = typename C::pointer;
    using reference = typename C::reference;
+   using segment_type = gsl::span<value_type>;
 
    ChunkedListIterator() { }
 
@@ -36,6 +37,8 @@ public:
 
    reference operator[](difference_type offset) const;
 
+   segment_type segment() const;
+
 protected:
    ChunkedListIterator(C* c, difference_type offset);
 
@@ -103,6 +103,17 @@ typename ChunkedListIterator<C>::reference ChunkedListIterator<C>::operator[](di
    return *(*this + offset);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the contiguous run of elements starting at this
+///         iterator and extending to the end of its node (or the end of the
+///         container, whichever comes first).
+template <typename C>
+typename ChunkedListIterator<C>::segment_type ChunkedListIterator<C>::segment() const {
+   difference_type count;
+   pointer ptr = this->get_segment_(count);
+   return segment_type(ptr, count);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 template <typename C>
 ChunkedListIterator<C>::ChunkedListIterator(C* c, difference_type offset)
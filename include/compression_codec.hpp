@@ -0,0 +1,70 @@
+#pragma once
+#ifndef BE_UTIL_COMPRESSION_COMPRESSION_CODEC_HPP_
+#define BE_UTIL_COMPRESSION_COMPRESSION_CODEC_HPP_
+
+#include <be/core/buf.hpp>
+#include <limits>
+#include <system_error>
+
+namespace be::util {
+
+///////////////////////////////////////////////////////////////////////////////
+enum class CodecType : U8 {
+   zlib = 0,
+   lz4,
+   zstd
+};
+
+const char* codec_type_name(CodecType type) noexcept;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Requests the codec's own default compression level.
+constexpr I8 default_codec_level = std::numeric_limits<I8>::min();
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A block compression algorithm.
+///
+/// \details Codecs compress and decompress complete payloads with no framing
+///         of their own; the uncompressed size must be known in order to
+///         decompress.  compress_buf() and decompress_buf() add a frame which
+///         records the uncompressed size and which codec was used.
+///
+///         The meaning of level is codec-specific:
+///         - zlib: 0 (store) to 9 (smallest); default 7.
+///         - lz4: 1 and above all use the default fast compressor; negative
+///           levels trade ratio for speed (acceleration = -level).
+///         - zstd: 1 to ZSTD_maxCLevel(), or negative for faster modes;
+///           default 3.
+///
+///         Failures are reported using ZlibResultCode values so that all
+///         codecs share one error category: buffer_error if the output is
+///         too small, data_error if the input is corrupt, and
+///         not_enough_memory if working memory can't be allocated.  Codecs
+///         which were not enabled when the library was built (see
+///         codec_available()) fail with std::errc::not_supported instead.
+///
+///         All member functions are thread-safe.
+class Codec {
+public:
+   virtual ~Codec() = default;
+
+   virtual CodecType type() const noexcept = 0;
+   virtual I8 default_level() const noexcept = 0;
+   virtual std::size_t bound(std::size_t uncompressed_size) const noexcept = 0;
+   virtual std::size_t compress(const UC* data, std::size_t size, UC* output, std::size_t capacity, I8 level, std::error_code& ec) const noexcept = 0;
+   virtual std::size_t decompress(const UC* compressed, std::size_t size, UC* output, std::size_t uncompressed_size, std::error_code& ec) const noexcept = 0;
+};
+
+bool codec_available(CodecType type) noexcept;
+const Codec& codec(CodecType type) noexcept;
+
+std::size_t compress_bound(std::size_t uncompressed_size, CodecType type = CodecType::zlib) noexcept;
+Buf<UC> compress_buf(const Buf<const UC>& data, CodecType type = CodecType::zlib, I8 level = default_codec_level);
+Buf<UC> compress_buf(const Buf<const UC>& data, std::error_code& ec, CodecType type = CodecType::zlib, I8 level = default_codec_level) noexcept;
+Buf<UC> decompress_buf(const Buf<const UC>& frame);
+Buf<UC> decompress_buf(const Buf<const UC>& frame, std::error_code& ec) noexcept;
+CodecType frame_codec_type(const Buf<const UC>& frame);
+
+} // be::util
+
+#endif
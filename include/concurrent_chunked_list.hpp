@@ -0,0 +1,223 @@
+#pragma once
+#ifndef BE_UTIL_CONCURRENT_CHUNKED_LIST_HPP_
+#define BE_UTIL_CONCURRENT_CHUNKED_LIST_HPP_
+
+#include <be/core/be.hpp>
+#include <gsl/span>
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <type_traits>
+
+namespace be::util {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Data node for ConcurrentChunkedList.  Element storage is left
+///         uninitialized; each slot has a flag which is set once the element
+///         in it has been constructed.
+template <typename T, std::size_t N>
+struct ConcurrentChunkedListNode {
+   ConcurrentChunkedListNode() noexcept {
+      for (std::size_t i = 0; i < N; ++i) {
+         ready[i].store(0, std::memory_order_relaxed);
+      }
+   }
+
+   T* data() noexcept {
+      return reinterpret_cast<T*>(storage);
+   }
+
+   alignas(T) UC storage[sizeof(T) * N];
+   std::atomic<U8> ready[N];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Metanode for ConcurrentChunkedList.  Unlike ChunkedListMetanode,
+///         each metanode records the index of its first node and the
+///         metanode before it, so that a walk can start from any metanode
+///         (usually the tail) rather than the head of the chain.
+template <typename P, std::size_t M>
+struct ConcurrentChunkedListMetanode {
+   ConcurrentChunkedListMetanode(ConcurrentChunkedListMetanode* prev, std::size_t first_node) noexcept
+      : next(nullptr),
+        prev(prev),
+        first_node(first_node)
+   {
+      for (std::size_t i = 0; i < M; ++i) {
+         nodes[i].store(nullptr, std::memory_order_relaxed);
+      }
+   }
+
+   std::atomic<ConcurrentChunkedListMetanode*> next;
+   ConcurrentChunkedListMetanode* const prev;
+   const std::size_t first_node;
+   std::atomic<P> nodes[M];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C>
+class ConcurrentChunkedListIterator {
+   using iterator = ConcurrentChunkedListIterator<C>;
+   using node = typename C::node;
+   using metanode = typename C::metanode;
+   friend C;
+public:
+   using iterator_category = std::forward_iterator_tag;
+   using value_type = typename C::value_type;
+   using difference_type = typename C::difference_type;
+   using pointer = typename C::const_pointer;
+   using reference = typename C::const_reference;
+
+   ConcurrentChunkedListIterator() { }
+
+   reference operator*() const;
+   pointer operator->() const;
+
+   iterator& operator++();
+   iterator operator++(int);
+
+   bool operator==(const iterator& other) const;
+   bool operator!=(const iterator& other) const;
+
+private:
+   ConcurrentChunkedListIterator(const C* c, std::size_t offset);
+
+   const C* container_ = nullptr;
+   std::size_t offset_ = 0;
+   mutable std::size_t node_index_ = std::size_t(-1);
+   mutable node* node_ = nullptr;
+   mutable const metanode* meta_ = nullptr;
+};
+
+} // be::util::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  An append-only sequence container which supports any number of
+///         concurrent writers and readers without locking.
+///
+/// \details Uses the same layout as ChunkedList: fixed-size data nodes of N
+///         elements, S node pointers held directly by the container, and a
+///         chain of metanodes holding M node pointers each.  Since nodes
+///         never move, references to elements remain valid until the
+///         container is cleared or destroyed.
+///
+///         Writers claim a slot with an atomic fetch-add, find (or create
+///         and publish with a compare-exchange) the node holding it,
+///         construct the element, and then mark the slot ready.  Writers
+///         also advance size() past each contiguous run of ready slots, so
+///         elements become visible in order even though they may finish
+///         construction out of order.  No writer ever waits for another.
+///
+///         Readers may call size(), operator[], begin()/end(), and
+///         for_each_chunk() concurrently with writers.  Every element at a
+///         position below the size() a reader observed is fully constructed
+///         and visible to that reader.  Elements must not be modified once
+///         published unless the caller provides its own synchronization.
+///
+///         clear(), and the destructor, must not run concurrently with
+///         anything else.
+///
+///         A slot can't be given back once claimed, so if a new node can't
+///         be allocated or value_type's constructor throws while appending,
+///         std::terminate is called.  Use reserve() to allocate nodes ahead
+///         of time if allocation failure must be handled.
+///
+/// \tparam T The type of objects to store in the container.
+/// \tparam A An allocator for nodes and metanodes.
+/// \tparam N The number of objects per node.
+/// \tparam M The number of nodes tracked per metanode.
+/// \tparam S The number of nodes that can be tracked without allocating any
+///         metanodes.
+template <typename T, typename A = std::allocator<T>, std::size_t N = 16, std::size_t M = 7, std::size_t S = 2>
+class ConcurrentChunkedList {
+   using container = ConcurrentChunkedList<T, A, N, M, S>;
+   using node = detail::ConcurrentChunkedListNode<T, N>;
+   using metanode = detail::ConcurrentChunkedListMetanode<node*, M>;
+   using node_alloc = typename std::allocator_traits<A>::template rebind_alloc<node>;
+   using meta_alloc = typename std::allocator_traits<A>::template rebind_alloc<metanode>;
+
+   friend class detail::ConcurrentChunkedListIterator<container>;
+
+public:
+   using allocator_type = A;
+   using value_type = T;
+   using size_type = std::size_t;
+   using difference_type = std::ptrdiff_t;
+   using pointer = T*;
+   using const_pointer = const T*;
+   using reference = T&;
+   using const_reference = const T&;
+
+   static constexpr const std::size_t chunk_size = N;
+   static constexpr const std::size_t chunks_per_metanode = M;
+   static constexpr const std::size_t static_chunks = S;
+
+   using const_iterator = detail::ConcurrentChunkedListIterator<container>;
+   using iterator = const_iterator;
+   using const_chunk_type = gsl::span<const value_type>;
+
+   ConcurrentChunkedList();
+   explicit ConcurrentChunkedList(const allocator_type& alloc);
+   ConcurrentChunkedList(const container&) = delete;
+   container& operator=(const container&) = delete;
+   ~ConcurrentChunkedList();
+
+   allocator_type get_allocator() const;
+
+   const_reference at(size_type pos) const;
+   const_reference operator[](size_type pos) const;
+
+   const_iterator begin() const noexcept;
+   const_iterator cbegin() const noexcept;
+   const_iterator end() const noexcept;
+   const_iterator cend() const noexcept;
+
+   bool empty() const noexcept;
+   size_type size() const noexcept;
+   size_type max_size() const noexcept;
+
+   void reserve(size_type count);
+
+   reference push_back(const value_type& value);
+   reference push_back(value_type&& value);
+   template <typename... P>
+   reference emplace_back(P&&... args);
+
+   void clear() noexcept;
+
+   template <typename F>
+   void for_each_chunk(F&& func) const;
+
+private:
+   node* find_node_(size_type node_index, const metanode*& meta) const noexcept;
+   node* acquire_node_(size_type node_index);
+   metanode* acquire_meta_(std::atomic<metanode*>& link, metanode* prev);
+   void advance_tail_(metanode* meta) noexcept;
+   void publish_() noexcept;
+
+   node* new_node_();
+   void delete_node_(node* n) noexcept;
+   metanode* new_meta_(metanode* prev);
+   void delete_meta_(metanode* meta) noexcept;
+
+   node_alloc node_alloc_;
+   meta_alloc meta_alloc_;
+
+   alignas(64) std::atomic<size_type> claimed_;
+   alignas(64) std::atomic<size_type> published_;
+   alignas(64) std::atomic<node*> static_nodes_[S];
+   std::atomic<metanode*> head_;
+   std::atomic<metanode*> tail_;
+};
+
+} // be::util
+
+#include "concurrent_chunked_list.inl"
+
+#endif
@@ -0,0 +1,499 @@
+#if !defined(BE_UTIL_CONCURRENT_CHUNKED_LIST_HPP_) && !defined(DOXYGEN)
+#include "concurrent_chunked_list.hpp"
+#elif !defined(BE_UTIL_CONCURRENT_CHUNKED_LIST_INL_)
+#define BE_UTIL_CONCURRENT_CHUNKED_LIST_INL_
+
+namespace be::util {
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C>
+ConcurrentChunkedListIterator<C>::ConcurrentChunkedListIterator(const C* c, std::size_t offset)
+   : container_(c),
+     offset_(offset)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C>
+typename ConcurrentChunkedListIterator<C>::reference ConcurrentChunkedListIterator<C>::operator*() const {
+   std::size_t node_index = offset_ / C::chunk_size;
+   if (node_index_ != node_index) {
+      node_ = container_->find_node_(node_index, meta_);
+      node_index_ = node_index;
+      assert(node_);
+   }
+   return node_->data()[offset_ % C::chunk_size];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C>
+typename ConcurrentChunkedListIterator<C>::pointer ConcurrentChunkedListIterator<C>::operator->() const {
+   return &**this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C>
+ConcurrentChunkedListIterator<C>& ConcurrentChunkedListIterator<C>::operator++() {
+   ++offset_;
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C>
+ConcurrentChunkedListIterator<C> ConcurrentChunkedListIterator<C>::operator++(int) {
+   iterator tmp = *this;
+   ++*this;
+   return tmp;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C>
+bool ConcurrentChunkedListIterator<C>::operator==(const iterator& other) const {
+   assert(container_ == other.container_);
+   return offset_ == other.offset_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename C>
+bool ConcurrentChunkedListIterator<C>::operator!=(const iterator& other) const {
+   return !(*this == other);
+}
+
+} // be::util::detail
+
+#pragma region construction/destruction
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+ConcurrentChunkedList<T, A, N, M, S>::ConcurrentChunkedList()
+   : ConcurrentChunkedList(allocator_type())
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+ConcurrentChunkedList<T, A, N, M, S>::ConcurrentChunkedList(const allocator_type& alloc)
+   : node_alloc_(alloc),
+     meta_alloc_(alloc),
+     claimed_(0),
+     published_(0),
+     head_(nullptr),
+     tail_(nullptr)
+{
+   for (std::size_t i = 0; i < static_chunks; ++i) {
+      static_nodes_[i].store(nullptr, std::memory_order_relaxed);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+ConcurrentChunkedList<T, A, N, M, S>::~ConcurrentChunkedList() {
+   clear();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::allocator_type
+ConcurrentChunkedList<T, A, N, M, S>::get_allocator() const {
+   return allocator_type(node_alloc_);
+}
+
+#pragma endregion
+#pragma region random access
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::const_reference
+ConcurrentChunkedList<T, A, N, M, S>::at(size_type pos) const {
+   if (pos >= size()) {
+      throw std::out_of_range("ConcurrentChunkedList index out of range!");
+   }
+
+   return (*this)[pos];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \details pos must be less than a value previously returned by size().
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::const_reference
+ConcurrentChunkedList<T, A, N, M, S>::operator[](size_type pos) const {
+   const metanode* meta = nullptr;
+   node* n = find_node_(pos / chunk_size, meta);
+   assert(n);
+   return n->data()[pos % chunk_size];
+}
+
+#pragma endregion
+#pragma region iterators
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::const_iterator
+ConcurrentChunkedList<T, A, N, M, S>::begin() const noexcept {
+   return const_iterator(this, 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::const_iterator
+ConcurrentChunkedList<T, A, N, M, S>::cbegin() const noexcept {
+   return begin();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \details Returns an iterator to the position after the last element
+///         published at the time of the call.  Elements appended later are
+///         not visited by a range ending here.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::const_iterator
+ConcurrentChunkedList<T, A, N, M, S>::end() const noexcept {
+   return const_iterator(this, size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::const_iterator
+ConcurrentChunkedList<T, A, N, M, S>::cend() const noexcept {
+   return end();
+}
+
+#pragma endregion
+#pragma region size
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+bool ConcurrentChunkedList<T, A, N, M, S>::empty() const noexcept {
+   return size() == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the number of published elements.
+///
+/// \details All elements below the returned position are fully constructed
+///         and visible to the calling thread.  More elements may have been
+///         claimed by writers which haven't finished constructing them yet.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::size_type
+ConcurrentChunkedList<T, A, N, M, S>::size() const noexcept {
+   return published_.load(std::memory_order_acquire);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::size_type
+ConcurrentChunkedList<T, A, N, M, S>::max_size() const noexcept {
+   return std::numeric_limits<size_type>::max();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Allocates enough nodes and metanodes to hold at least count
+///         elements.
+///
+/// \details May be called concurrently with writers and readers.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+void ConcurrentChunkedList<T, A, N, M, S>::reserve(size_type count) {
+   size_type nodes = (count + chunk_size - 1) / chunk_size;
+   for (size_type i = 0; i < nodes; ++i) {
+      acquire_node_(i);
+   }
+}
+
+#pragma endregion
+#pragma region insertion
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::reference
+ConcurrentChunkedList<T, A, N, M, S>::push_back(const value_type& value) {
+   return emplace_back(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::reference
+ConcurrentChunkedList<T, A, N, M, S>::push_back(value_type&& value) {
+   return emplace_back(std::move(value));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Constructs a new element at the end of the container.
+///
+/// \details May be called concurrently with other writers and readers.  The
+///         element may not be visible to readers immediately after this
+///         returns if a writer which claimed an earlier slot hasn't
+///         finished yet.
+///
+///         The writer which claims the first slot of a node also allocates
+///         the following node, so that writers rarely have to allocate (or
+///         race each other to allocate) on the append path.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename... P>
+typename ConcurrentChunkedList<T, A, N, M, S>::reference
+ConcurrentChunkedList<T, A, N, M, S>::emplace_back(P&&... args) {
+   size_type pos = claimed_.fetch_add(1, std::memory_order_relaxed);
+   size_type node_index = pos / chunk_size;
+   size_type index = pos % chunk_size;
+
+   pointer ptr;
+
+   // a claimed slot can never be released, so there's no way to recover if
+   // this throws; the noexcept lambda ensures std::terminate is called.
+   [&]() noexcept {
+      node* n = acquire_node_(node_index);
+      ptr = new (n->data() + index) value_type(std::forward<P>(args)...);
+      n->ready[index].store(1);
+   }();
+
+   publish_();
+
+   if (index == 0) {
+      try {
+         acquire_node_(node_index + 1);
+      } catch (...) {
+         // not fatal; whoever claims the first slot there will try again
+      }
+   }
+
+   return *ptr;
+}
+
+#pragma endregion
+#pragma region removal
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Destroys all elements and deallocates all nodes and metanodes.
+///
+/// \details Must not be called concurrently with any other member function.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+void ConcurrentChunkedList<T, A, N, M, S>::clear() noexcept {
+   assert(claimed_.load(std::memory_order_relaxed) == published_.load(std::memory_order_relaxed));
+   size_type remaining = published_.load(std::memory_order_relaxed);
+
+   auto release = [&](node* n) {
+      if (n) {
+         size_type count = std::min(remaining, size_type(chunk_size));
+         std::destroy_n(n->data(), count);
+         remaining -= count;
+         delete_node_(n);
+      }
+   };
+
+   for (size_type i = 0; i < static_chunks; ++i) {
+      release(static_nodes_[i].exchange(nullptr, std::memory_order_relaxed));
+   }
+
+   metanode* meta = head_.exchange(nullptr, std::memory_order_relaxed);
+   while (meta) {
+      for (size_type i = 0; i < chunks_per_metanode; ++i) {
+         release(meta->nodes[i].load(std::memory_order_relaxed));
+      }
+
+      metanode* next = meta->next.load(std::memory_order_relaxed);
+      delete_meta_(meta);
+      meta = next;
+   }
+
+   tail_.store(nullptr, std::memory_order_relaxed);
+   claimed_.store(0, std::memory_order_relaxed);
+   published_.store(0, std::memory_order_relaxed);
+}
+
+#pragma endregion
+#pragma region misc
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Calls func once for each data node holding published elements,
+///         in order, passing a const_chunk_type span covering those
+///         elements.
+///
+/// \details Elements published after the call begins are not visited.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+template <typename F>
+void ConcurrentChunkedList<T, A, N, M, S>::for_each_chunk(F&& func) const {
+   size_type remaining = size();
+   const metanode* meta = nullptr;
+   for (size_type node_index = 0; remaining > 0; ++node_index) {
+      node* n = find_node_(node_index, meta);
+      assert(n);
+      size_type count = std::min(remaining, size_type(chunk_size));
+      func(const_chunk_type(n->data(), count));
+      remaining -= count;
+   }
+}
+
+#pragma endregion
+#pragma region private
+
+// Node and metanode pointers, ready flags, and published_ are all accessed
+// with sequentially consistent operations.  publish_() relies on this: if
+// two writers each mark a slot ready and then look for the other's slot
+// (and the node holding it), at least one of them is guaranteed to see it,
+// so no ready slot is ever left unpublished.
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Looks up a data node without allocating anything.
+///
+/// \details meta is used as a hint for where to start walking the metanode
+///         chain, and is updated to the metanode holding the node so that
+///         sequential lookups only walk each metanode once.  Without a hint
+///         the walk starts at the tail, since readers and writers are
+///         usually interested in recent elements.
+///
+/// \return The node, or nullptr if it hasn't been allocated yet.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::node*
+ConcurrentChunkedList<T, A, N, M, S>::find_node_(size_type node_index, const metanode*& meta) const noexcept {
+   if (node_index < static_chunks) {
+      return static_nodes_[node_index].load();
+   }
+
+   if (!meta) {
+      meta = tail_.load();
+   }
+
+   while (meta && meta->first_node > node_index) {
+      meta = meta->prev;
+   }
+
+   if (!meta) {
+      meta = head_.load();
+   }
+
+   while (meta && node_index >= meta->first_node + chunks_per_metanode) {
+      meta = meta->next.load();
+   }
+
+   if (!meta) {
+      return nullptr;
+   }
+
+   return meta->nodes[node_index - meta->first_node].load();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Looks up a data node, allocating it (and any metanodes needed to
+///         track it) if necessary.
+///
+/// \details If several threads race to allocate the same node or metanode,
+///         the first to install its pointer wins and the others deallocate
+///         theirs.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::node*
+ConcurrentChunkedList<T, A, N, M, S>::acquire_node_(size_type node_index) {
+   std::atomic<node*>* slot;
+   if (node_index < static_chunks) {
+      slot = &static_nodes_[node_index];
+   } else {
+      metanode* meta = tail_.load();
+      while (meta && meta->first_node > node_index) {
+         meta = meta->prev;
+      }
+
+      if (!meta) {
+         meta = acquire_meta_(head_, nullptr);
+      }
+
+      while (node_index >= meta->first_node + chunks_per_metanode) {
+         meta = acquire_meta_(meta->next, meta);
+      }
+
+      slot = &meta->nodes[node_index - meta->first_node];
+   }
+
+   node* n = slot->load();
+   if (!n) {
+      node* fresh = new_node_();
+      if (slot->compare_exchange_strong(n, fresh)) {
+         n = fresh;
+      } else {
+         delete_node_(fresh);
+      }
+   }
+
+   return n;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::metanode*
+ConcurrentChunkedList<T, A, N, M, S>::acquire_meta_(std::atomic<metanode*>& link, metanode* prev) {
+   metanode* meta = link.load();
+   if (!meta) {
+      metanode* fresh = new_meta_(prev);
+      if (link.compare_exchange_strong(meta, fresh)) {
+         meta = fresh;
+         advance_tail_(fresh);
+      } else {
+         delete_meta_(fresh);
+      }
+   }
+
+   return meta;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Updates the tail hint, unless another thread has already moved
+///         it further along the chain.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+void ConcurrentChunkedList<T, A, N, M, S>::advance_tail_(metanode* meta) noexcept {
+   metanode* tail = tail_.load();
+   while (!tail || tail->first_node < meta->first_node) {
+      if (tail_.compare_exchange_weak(tail, meta)) {
+         break;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Advances published_ past every consecutive ready slot.
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+void ConcurrentChunkedList<T, A, N, M, S>::publish_() noexcept {
+   size_type pos = published_.load();
+   const metanode* meta = nullptr;
+   for (;;) {
+      node* n = find_node_(pos / chunk_size, meta);
+      if (!n || !n->ready[pos % chunk_size].load()) {
+         return;
+      }
+
+      if (published_.compare_exchange_weak(pos, pos + 1)) {
+         ++pos;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::node*
+ConcurrentChunkedList<T, A, N, M, S>::new_node_() {
+   node* n = std::allocator_traits<node_alloc>::allocate(node_alloc_, 1);
+   return new (n) node();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+void ConcurrentChunkedList<T, A, N, M, S>::delete_node_(node* n) noexcept {
+   n->~node();
+   std::allocator_traits<node_alloc>::deallocate(node_alloc_, n, 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+typename ConcurrentChunkedList<T, A, N, M, S>::metanode*
+ConcurrentChunkedList<T, A, N, M, S>::new_meta_(metanode* prev) {
+   size_type first_node = prev ? prev->first_node + chunks_per_metanode : static_chunks;
+   metanode* meta = std::allocator_traits<meta_alloc>::allocate(meta_alloc_, 1);
+   return new (meta) metanode(prev, first_node);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S>
+void ConcurrentChunkedList<T, A, N, M, S>::delete_meta_(metanode* meta) noexcept {
+   meta->~metanode();
+   std::allocator_traits<meta_alloc>::deallocate(meta_alloc_, meta, 1);
+}
+
+#pragma endregion
+
+} // be::util
+
+#endif
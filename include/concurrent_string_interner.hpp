@@ -0,0 +1,80 @@
+#pragma once
+#ifndef BE_UTIL_STRING_CONCURRENT_STRING_INTERNER_HPP_
+#define BE_UTIL_STRING_CONCURRENT_STRING_INTERNER_HPP_
+
+#include "string_interner.hpp"
+#include <be/core/be.hpp>
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace be {
+namespace util {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A StringInterner which may be used from any number of threads at
+///         once.
+///
+/// \details Strings are divided between a fixed number of shards according to
+///         their hash.  Each shard has its own lookup table and its own bump
+///         arena to hold string data.  Looking up a string which has already
+///         been interned never locks.  Interning a new string locks only the
+///         mutex of the shard it belongs to.
+///
+///         As with StringInterner, the string views returned remain valid
+///         until the ConcurrentStringInterner is destroyed, and interning
+///         strings with equal content returns an identical view, regardless
+///         of which thread interned them.
+class ConcurrentStringInterner {
+   struct slot {
+      std::atomic<U64> hash;
+      const char* data;
+      std::size_t size;
+   };
+
+   struct table {
+      explicit table(std::size_t capacity);
+
+      std::size_t mask;
+      std::unique_ptr<slot[]> slots;
+   };
+
+   struct alignas(64) shard {
+      shard();
+
+      std::atomic<table*> current;
+      std::atomic<std::size_t> size;
+      std::mutex mutex;
+      std::vector<std::unique_ptr<table>> tables;
+      detail::StringArena arena;
+   };
+
+public:
+   explicit ConcurrentStringInterner(std::size_t shards = 64);
+
+   std::size_t shard_count() const noexcept;
+   std::size_t size() const noexcept;
+   StringInternerStats stats();
+
+   void reserve_strings(std::size_t count);
+
+   be::SV operator()(be::SV str);
+
+private:
+   static U64 hash_(be::SV str) noexcept;
+   static const slot* find_(const table& t, be::SV str, U64 hash) noexcept;
+   static void insert_(table& t, U64 hash, const char* data, std::size_t size) noexcept;
+
+   shard& shard_(U64 hash) noexcept;
+   table& grow_(shard& s, std::size_t count);
+
+   std::unique_ptr<shard[]> shards_;
+   std::size_t shard_count_;
+   U32 shard_shift_;
+};
+
+} // be::util
+} // be
+
+#endif
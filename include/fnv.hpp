@@ -3,7 +3,11 @@
 #define BE_UTIL_FNV_HPP_
 
 #include <be/core/be.hpp>
+#include <gsl/span>
 #include <gsl/string_span>
+#include <algorithm>
+#include <array>
+#include <cstring>
 
 namespace be::util {
 namespace detail {
@@ -30,7 +34,10 @@ struct ConstexprFnv {
    }
 
    constexpr T operator()(T v, const char* ptr) const {
-      return *ptr ? ConstexprFnv<T>()((v * M) ^ U8(*ptr), ptr + 1) : v;
+      for (; *ptr; ++ptr) {
+         v = (v * M) ^ U8(*ptr);
+      }
+      return v;
    }
 };
 
@@ -115,6 +122,175 @@ T fnv1a(T basis, I begin, I end) {
    return T(detail::Fnva<U>()(U(basis), begin, end));
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Computes an FNV-1 hash of a string.  Can be evaluated at compile
+///         time.
+template <typename T = U64>
+constexpr T fnv1(SV input) noexcept {
+   using U = std::make_unsigned_t<T>;
+   U v = detail::FnvBasis<U>::value;
+   for (char c : input) {
+      v = (v * detail::FnvMult<U>::value) ^ U8(c);
+   }
+   return T(v);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Computes an FNV-1a hash of a string.  Can be evaluated at compile
+///         time, and gives the same result as fnv1a(input.begin(),
+///         input.end()) at runtime.
+template <typename T = U64>
+constexpr T fnv1a(SV input) noexcept {
+   using U = std::make_unsigned_t<T>;
+   U v = detail::FnvBasis<U>::value;
+   for (char c : input) {
+      v = (v ^ U8(c)) * detail::FnvMult<U>::value;
+   }
+   return T(v);
+}
+
+inline namespace literals {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Computes the 64-bit FNV-1a hash of a string literal at compile
+///         time.
+///
+/// \details Allows dispatching on strings with a switch statement:
+///         \code
+///         switch (util::fnv1a(token)) {
+///            case "foo"_fnv: ...
+///         \endcode
+///         Different strings can have the same hash, so a case label should
+///         still check the string itself if unexpected input is possible.
+constexpr U64 operator""_fnv(const char* str, std::size_t size) noexcept {
+   return fnv1a<U64>(SV(str, size));
+}
+
+} // be::util::literals
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Computes an FNV-1a hash incrementally.
+///
+/// \details With Words = false, produces the same value as fnv1a() over the
+///         concatenation of all data passed to update().
+///
+///         With Words = true, data is folded in sizeof(T) bytes at a time
+///         (each word read in native byte order) and any remaining bytes are
+///         folded in individually, so only a fraction as many multiplies are
+///         needed.  This is not the same value as standard FNV-1a, but is
+///         still independent of how the data is split between update() calls.
+///         It's intended for hashing keys of in-memory hash tables, not for
+///         values which are persisted or exchanged between platforms.
+template <typename T = U64, bool Words = false>
+class FnvHasher {
+   using U = std::make_unsigned_t<T>;
+   static constexpr U prime = detail::FnvMult<U>::value;
+public:
+   FnvHasher() noexcept
+      : basis_(detail::FnvBasis<U>::value),
+        value_(basis_) { }
+
+   explicit FnvHasher(T basis) noexcept
+      : basis_(U(basis)),
+        value_(basis_) { }
+
+   FnvHasher& update(const void* data, std::size_t size) noexcept {
+      const UC* ptr = static_cast<const UC*>(data);
+      if constexpr (Words) {
+         update_words_(ptr, size);
+      } else {
+         U v = value_;
+         for (const UC* end = ptr + size; ptr != end; ++ptr) {
+            v = (v ^ *ptr) * prime;
+         }
+         value_ = v;
+      }
+      return *this;
+   }
+
+   FnvHasher& update(gsl::span<const UC> data) noexcept {
+      return update(data.data(), std::size_t(data.size()));
+   }
+
+   FnvHasher& update(SV data) noexcept {
+      return update(data.data(), data.size());
+   }
+
+   template <typename I>
+   FnvHasher& update(I begin, I end) {
+      for (; begin != end; ++begin) {
+         const UC c = UC(*begin);
+         update(&c, 1);
+      }
+      return *this;
+   }
+
+   T digest() const noexcept {
+      U v = value_;
+      if constexpr (Words) {
+         for (std::size_t i = 0; i < pending_size_; ++i) {
+            v = (v ^ pending_[i]) * prime;
+         }
+      }
+      return T(v);
+   }
+
+   void reset() noexcept {
+      value_ = basis_;
+      pending_size_ = 0;
+   }
+
+private:
+   void update_words_(const UC* ptr, std::size_t size) noexcept {
+      U v = value_;
+      if (pending_size_ > 0) {
+         const std::size_t n = std::min(size, sizeof(U) - pending_size_);
+         std::memcpy(pending_ + pending_size_, ptr, n);
+         pending_size_ += n;
+         ptr += n;
+         size -= n;
+         if (pending_size_ < sizeof(U)) {
+            return;
+         }
+         U word;
+         std::memcpy(&word, pending_, sizeof(U));
+         v = (v ^ word) * prime;
+         pending_size_ = 0;
+      }
+
+      for (; size >= sizeof(U); ptr += sizeof(U), size -= sizeof(U)) {
+         U word;
+         std::memcpy(&word, ptr, sizeof(U));
+         v = (v ^ word) * prime;
+      }
+
+      if (size > 0) {
+         std::memcpy(pending_, ptr, size);
+         pending_size_ = size;
+      }
+      value_ = v;
+   }
+
+   U basis_;
+   U value_;
+   std::size_t pending_size_ = 0;
+   UC pending_[sizeof(U)];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T = U64>
+using FnvWordHasher = FnvHasher<T, true>;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A 256-bit FNV hash, most significant byte first.
+using Fnv256Digest = std::array<UC, 32>;
+
+Fnv256Digest fnv256_0_digest(SV input) noexcept;
+Fnv256Digest fnv256_1_digest(SV input) noexcept;
+Fnv256Digest fnv256_1a_digest(SV input) noexcept;
+
+char* fnv256_hex(const Fnv256Digest& digest, char* out) noexcept;
+
 S fnv256_0(SV input);
 S fnv256_1(SV input);
 S fnv256_1a(SV input);
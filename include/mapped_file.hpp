@@ -0,0 +1,75 @@
+#pragma once
+#ifndef BE_UTIL_FS_MAPPED_FILE_HPP_
+#define BE_UTIL_FS_MAPPED_FILE_HPP_
+
+#include <be/core/filesystem.hpp>
+#include <be/core/buf.hpp>
+
+namespace be::util {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Tells the OS how a mapped file is going to be read, so that it can
+///         choose how much to read ahead of each page fault.
+enum class MappedFileAccess : U8 {
+   normal = 0,
+   sequential,
+   random,
+   will_need
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The smallest file get_file_contents_mapped() maps instead of
+///         reading.
+///
+/// \details Below this, the cost of setting up and tearing down the mapping
+///         is greater than the cost of copying the data.
+constexpr std::size_t min_mapped_file_size = 256 * 1024;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A read-only view of a file's contents, backed directly by the OS's
+///         page cache.
+///
+/// \details Opening a MappedFile takes constant time regardless of the size
+///         of the file; pages are read from disk the first time they are
+///         touched, and pages which are never touched are never read.  The
+///         file itself is closed as soon as it is mapped.
+///
+///         The file must not be truncated while it is mapped; reading a page
+///         past the new end of the file will crash the process.  Changes
+///         made to the file by other processes may or may not be visible.
+///         On Windows, the file can't be truncated or replaced until the
+///         mapping is released.
+///
+///         Empty files produce an empty view.
+class MappedFile final {
+public:
+   MappedFile() = default;
+   explicit MappedFile(const Path& path, MappedFileAccess access = MappedFileAccess::normal);
+   MappedFile(const Path& path, std::error_code& ec) noexcept;
+   MappedFile(const Path& path, MappedFileAccess access, std::error_code& ec) noexcept;
+
+   const UC* data() const noexcept;
+   std::size_t size() const noexcept;
+
+   Buf<const UC> buf() const noexcept;
+   Buf<const UC> release() noexcept;
+
+   void advise(MappedFileAccess access) noexcept;
+   void prefetch(std::size_t offset, std::size_t size) noexcept;
+
+private:
+   Buf<const UC> data_;
+};
+
+Buf<const UC> get_file_contents_mapped(const Path& path);
+Buf<const UC> get_file_contents_mapped(const Path& path, std::error_code& ec) noexcept;
+
+namespace detail {
+
+Buf<const UC> map_file(const Path& path, std::error_code& ec) noexcept;
+void advise_mapped_file(const UC* data, std::size_t size, MappedFileAccess access) noexcept;
+
+} // be::util::detail
+} // be::util
+
+#endif
@@ -4,12 +4,165 @@
 
 #include <be/core/be.hpp>
 #include <be/core/alg.hpp>
-#include <unordered_set>
+#include <be/core/buf.hpp>
 #include <functional>
+#include <memory>
+#include <vector>
 
 namespace be {
 namespace util {
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A dense 32-bit handle for a string interned by a StringInterner.
+///
+/// \details IDs are assigned sequentially from 0 in the order strings are
+///         first interned, so they can index flat arrays directly.  Two IDs
+///         from the same StringInterner are equal if and only if their
+///         strings are equal.  std::hash<InternedId> hashes the integer.
+enum class InternedId : U32 { };
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Memory usage statistics for a StringInterner.
+///
+/// \details bytes_reserved is the total size of all segments.  bytes_used is
+///         the total size of all interned strings.  bytes_wasted counts free
+///         space left behind in segments which will no longer be allocated
+///         from.  The remainder (bytes_reserved - bytes_used - bytes_wasted)
+///         is available for new strings without allocating a new segment.
+struct StringInternerStats {
+   std::size_t strings = 0;
+   std::size_t segments = 0;
+   std::size_t bytes_reserved = 0;
+   std::size_t bytes_used = 0;
+   std::size_t bytes_wasted = 0;
+};
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Bump-pointer arena holding the character data of interned
+///         strings.
+///
+/// \details Allocations are taken from the current segment whenever it has
+///         enough room, so allocation never searches.  When it doesn't, a new
+///         segment is allocated, and becomes the current segment only if it
+///         has more space left than the old one.  Unless a specific size is
+///         requested, each new segment is as large as all previous segments
+///         combined (clamped to [min_segment_size, max_segment_size]), so the
+///         number of segments grows logarithmically.
+class StringArena {
+public:
+   explicit StringArena(std::size_t min_segment_size = 4096, std::size_t max_segment_size = 1024 * 1024);
+
+   char* allocate(std::size_t bytes, std::size_t segment_size = 0);
+
+   void reserve(std::size_t bytes);
+
+   std::size_t available() const noexcept;
+   std::size_t segment_count() const noexcept;
+   std::size_t bytes_reserved() const noexcept;
+   std::size_t bytes_used() const noexcept;
+   std::size_t bytes_wasted() const noexcept;
+
+private:
+   char* allocate_segment_(std::size_t bytes, std::size_t segment_size);
+
+   std::vector<std::unique_ptr<char[]>> segments_;
+   char* next_ = nullptr;
+   std::size_t free_ = 0;
+   std::size_t reserved_ = 0;
+   std::size_t used_ = 0;
+   std::size_t wasted_ = 0;
+   std::size_t min_segment_size_;
+   std::size_t max_segment_size_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Flat open-addressing hash set of string views, used by
+///         StringInterner.
+///
+/// \details Slots are arranged in groups of 16, with a separate array of
+///         control bytes; each control byte either marks its slot as empty or
+///         holds 7 bits of the hash of the string in that slot.  Probing
+///         compares a whole group of control bytes at once (using SSE2 where
+///         available), so only slots with a matching 7-bit tag are examined,
+///         and the full hash stored in each slot rejects nearly all remaining
+///         mismatches without touching the string data.  Since the hash is
+///         stored, growing the table never rehashes string contents.
+///
+///         Strings are never removed, so there are no tombstones.  The table
+///         does not own the character data it refers to.
+class StringInternerTable {
+public:
+   struct entry {
+      U64 hash;
+      const char* data;
+      U32 size;
+      U32 id;
+   };
+
+   static constexpr const std::size_t group_size = 16;
+
+   static U64 hash(be::SV str) noexcept;
+
+   std::size_t size() const noexcept;
+   std::size_t capacity() const noexcept;
+
+   void reserve(std::size_t count);
+
+   const entry* find(be::SV str, U64 hash) const noexcept;
+   const entry& insert(be::SV str, U64 hash, U32 id);
+
+private:
+   void rehash_(std::size_t groups);
+   entry& insert_unique_(U64 hash) noexcept;
+
+   std::unique_ptr<U8[]> ctrl_;
+   std::unique_ptr<entry[]> slots_;
+   std::size_t groups_ = 0;
+   std::size_t size_ = 0;
+   std::size_t growth_left_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Read-only view of a StringInterner snapshot image.
+///
+/// \details The image holds a table with the same layout as
+///         StringInternerTable, except that slots refer to string data by
+///         offset rather than pointer, followed by a table of strings indexed
+///         by ID, and the string data itself.  Since it contains no pointers,
+///         it can be used in place wherever it is loaded or mapped, without
+///         rehashing or copying anything.  Images use the host byte order
+///         and are rejected if it doesn't match.
+class StringInternerSnapshot {
+   struct header;
+   struct slot;
+   struct string_ref;
+public:
+   StringInternerSnapshot() = default;
+   StringInternerSnapshot(const UC* data, std::size_t size);
+
+   static Buf<UC> write(const std::vector<be::SV>& strings);
+
+   std::size_t size() const noexcept;
+
+   bool find(be::SV str, U64 hash, be::SV& result, U32& id) const noexcept;
+   be::SV lookup(U32 id) const noexcept;
+
+private:
+   be::SV view_(U64 offset, U64 size) const noexcept;
+
+   const U8* ctrl_ = nullptr;
+   const slot* slots_ = nullptr;
+   const string_ref* strings_ = nullptr;
+   const char* data_ = nullptr;
+   std::size_t data_size_ = 0;
+   std::size_t groups_ = 0;
+   std::size_t size_ = 0;
+};
+
+} // be::util::detail
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \brief  Provides interned versions of string views passed in.
 ///
@@ -17,24 +170,49 @@ namespace util {
 ///         StringInterner is destroyed.  Interning string views with different
 ///         backing memory but equal content will result in an identical output
 ///         string view.
+///
+///         Each distinct string is also assigned an InternedId, which can be
+///         obtained with id() instead of the view, and converted back with
+///         lookup().
+///
+///         snapshot() serializes all interned strings into a position-
+///         independent image.  A new StringInterner can use that image
+///         directly (for instance, from a read-only memory-mapped file) as a
+///         base set of strings, with the same IDs they had before; strings
+///         not in the snapshot are interned into a writable overlay.
 class StringInterner {
-   struct segment {
-      std::size_t size;
-      std::size_t free;
-      std::unique_ptr<char[]> data;
+   struct interned {
+      be::SV str;
+      U32 id;
    };
 public:
+   StringInterner() = default;
+   explicit StringInterner(Buf<const UC> snapshot);
+
    void provisioning_policy(std::function<std::size_t(std::size_t)> func);
 
    void reserve(std::size_t bytes);
+   void reserve_strings(std::size_t count);
+
+   std::size_t size() const noexcept;
+   StringInternerStats stats() const noexcept;
 
    be::SV operator()(be::SV str);
 
+   InternedId id(be::SV str);
+   bool find_id(be::SV str, InternedId& id) const noexcept;
+   be::SV lookup(InternedId id) const noexcept;
+
+   Buf<UC> snapshot() const;
+
 private:
-   segment& reserve_(std::size_t bytes);
+   interned intern_(be::SV str);
 
-   std::unordered_set<be::SV> set_;
-   std::vector<segment> segments_;
+   Buf<const UC> snapshot_buf_;
+   detail::StringInternerSnapshot snapshot_;
+   detail::StringInternerTable table_;
+   detail::StringArena arena_;
+   std::vector<be::SV> strings_;
    std::function<std::size_t(std::size_t)> policy_;
 };
 
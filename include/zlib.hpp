@@ -3,13 +3,27 @@
 #define BE_UTIL_COMPRESSION_ZLIB_HPP_
 
 #include <be/core/buf.hpp>
+#include <gsl/span>
+#include <memory>
+
+struct z_stream_s;
 
 namespace be::util {
 
+std::size_t deflate_bound(std::size_t uncompressed_size, bool encode_length = true) noexcept;
+
 Buf<UC> deflate_string(const S& text, bool encode_length = true, I8 level = 7);
 Buf<UC> deflate_string(const S& text, std::error_code& ec, bool encode_length = true, I8 level = 7) noexcept;
 Buf<UC> deflate_buf(const Buf<const UC>& data, bool encode_length = true, I8 level = 7);
 Buf<UC> deflate_buf(const Buf<const UC>& data, std::error_code& ec, bool encode_length = true, I8 level = 7) noexcept;
+Buf<UC> deflate_buf(const Buf<const UC>& data, const Buf<const UC>& dictionary, bool encode_length = true, I8 level = 7);
+Buf<UC> deflate_buf(const Buf<const UC>& data, const Buf<const UC>& dictionary, std::error_code& ec, bool encode_length = true, I8 level = 7) noexcept;
+Buf<UC> deflate_buf_parallel(const Buf<const UC>& data, std::size_t threads = 0, bool encode_length = true, I8 level = 7);
+Buf<UC> deflate_buf_parallel(const Buf<const UC>& data, std::error_code& ec, std::size_t threads = 0, bool encode_length = true, I8 level = 7) noexcept;
+std::size_t deflate_into(const Buf<const UC>& data, gsl::span<UC> output, bool encode_length = true, I8 level = 7);
+std::size_t deflate_into(const Buf<const UC>& data, gsl::span<UC> output, std::error_code& ec, bool encode_length = true, I8 level = 7) noexcept;
+std::size_t deflate_into(const Buf<const UC>& data, Buf<UC>& output, bool encode_length = true, I8 level = 7);
+std::size_t deflate_into(const Buf<const UC>& data, Buf<UC>& output, std::error_code& ec, bool encode_length = true, I8 level = 7) noexcept;
 
 S inflate_string(const Buf<const UC>& compressed);
 S inflate_string(const Buf<const UC>& compressed, std::error_code& ec) noexcept;
@@ -19,7 +33,115 @@ Buf<UC> inflate_buf(const Buf<const UC>& compressed);
 Buf<UC> inflate_buf(const Buf<const UC>& compressed, std::error_code& ec) noexcept;
 Buf<UC> inflate_buf(const Buf<const UC>& compressed, std::size_t uncomressed_length);
 Buf<UC> inflate_buf(const Buf<const UC>& compressed, std::size_t uncomressed_length, std::error_code& ec) noexcept;
+Buf<UC> inflate_buf(const Buf<const UC>& compressed, const Buf<const UC>& dictionary);
+Buf<UC> inflate_buf(const Buf<const UC>& compressed, const Buf<const UC>& dictionary, std::error_code& ec) noexcept;
+std::size_t inflate_into(const Buf<const UC>& compressed, gsl::span<UC> output);
+std::size_t inflate_into(const Buf<const UC>& compressed, gsl::span<UC> output, std::error_code& ec) noexcept;
+std::size_t inflate_into(const Buf<const UC>& compressed, Buf<UC>& output);
+std::size_t inflate_into(const Buf<const UC>& compressed, Buf<UC>& output, std::error_code& ec) noexcept;
+std::size_t inflate_into(const Buf<const UC>& compressed, std::size_t uncompressed_length, gsl::span<UC> output);
+std::size_t inflate_into(const Buf<const UC>& compressed, std::size_t uncompressed_length, gsl::span<UC> output, std::error_code& ec) noexcept;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses a sequence of zlib streams, reusing the same
+///         compressor state for each one.
+///
+/// \details Input is pushed in chunks and compressed data is pulled out into
+///         caller-provided buffers, so neither needs to be held in memory
+///         all at once:
+///         \code
+///         for (auto chunk : chunks) {
+///            deflater.push(chunk);
+///            while (!deflater.needs_input()) {
+///               write(buf, deflater.pull(buf));
+///            }
+///         }
+///         deflater.finish();
+///         while (!deflater.done()) {
+///            write(buf, deflater.pull(buf));
+///         }
+///         deflater.reset();
+///         \endcode
+///         Pushed data is not copied; it must remain valid until
+///         needs_input() returns true.
+///
+///         reset() starts a new stream without reallocating the compressor
+///         state, which is much cheaper than creating a new deflater when
+///         compressing many small messages.
+class ZlibDeflater final {
+public:
+   explicit ZlibDeflater(I8 level = 7);
+   ZlibDeflater(ZlibDeflater&& other) noexcept;
+   ZlibDeflater& operator=(ZlibDeflater&& other) noexcept;
+   ~ZlibDeflater();
+
+   I8 level() const noexcept;
+   const Buf<const UC>& dictionary() const noexcept;
+   void dictionary(Buf<const UC> dictionary);
+
+   void reset();
+   void push(gsl::span<const UC> input) noexcept;
+   void finish() noexcept;
+   std::size_t pull(gsl::span<UC> output);
+
+   bool needs_input() const noexcept;
+   bool done() const noexcept;
+
+   Buf<UC> deflate_buf(const Buf<const UC>& data, bool encode_length = true);
+   std::size_t deflate_into(const Buf<const UC>& data, gsl::span<UC> output, bool encode_length = true);
+
+private:
+   std::unique_ptr<::z_stream_s> stream_;
+   const UC* input_ = nullptr;
+   std::size_t input_remaining_ = 0;
+   I8 level_;
+   bool finishing_ = false;
+   bool done_ = false;
+   Buf<const UC> dictionary_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses a sequence of zlib streams, reusing the same
+///         decompressor state for each one.
+///
+/// \details Works like ZlibDeflater, except that the end of the stream is
+///         determined by the compressed data itself, so there is no finish().
+///         If the input ends before done() returns true, the stream was
+///         truncated.  Any input following the end of the stream is left
+///         unconsumed.
+class ZlibInflater final {
+public:
+   ZlibInflater();
+   ZlibInflater(ZlibInflater&& other) noexcept;
+   ZlibInflater& operator=(ZlibInflater&& other) noexcept;
+   ~ZlibInflater();
+
+   const Buf<const UC>& dictionary() const noexcept;
+   void dictionary(Buf<const UC> dictionary) noexcept;
+
+   void reset();
+   void push(gsl::span<const UC> input) noexcept;
+   std::size_t pull(gsl::span<UC> output);
+
+   bool needs_input() const noexcept;
+   bool done() const noexcept;
+
+   Buf<UC> inflate_buf(const Buf<const UC>& compressed);
+   std::size_t inflate_into(const Buf<const UC>& compressed, gsl::span<UC> output);
+
+private:
+   std::unique_ptr<::z_stream_s> stream_;
+   const UC* input_ = nullptr;
+   std::size_t input_remaining_ = 0;
+   bool done_ = false;
+   Buf<const UC> dictionary_;
+};
+
+namespace detail {
+
+void trim_buf(Buf<UC>& buf, std::size_t size) noexcept;
 
+} // be::util::detail
 } // be::util
 
 #endif
@@ -0,0 +1,61 @@
+#pragma once
+#ifndef BE_UTIL_COMPRESSION_ZLIB_ALLOCATOR_HPP_
+#define BE_UTIL_COMPRESSION_ZLIB_ALLOCATOR_HPP_
+
+#include <be/core/be.hpp>
+
+namespace be::util {
+
+///////////////////////////////////////////////////////////////////////////////
+enum class ZlibAllocatorMode : U8 {
+   system = 0,
+   thread_cache
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Controls how zlib stream state (windows, hash tables, and pending
+///         output) is allocated by every deflate and inflate function.
+///
+/// \details In thread_cache mode, memory freed when a stream ends is kept in
+///         a small per-thread cache and handed back to the next stream on
+///         that thread which asks for a block of the same size.  A level 7
+///         deflate stream allocates about 256 KiB, so with the default limit
+///         a thread can keep the state for a few streams warm.  Blocks beyond
+///         max_cached_bytes are returned to the system immediately, and each
+///         thread's cache is released when the thread exits.
+struct ZlibAllocatorConfig {
+   ZlibAllocatorMode mode = ZlibAllocatorMode::thread_cache;
+   std::size_t max_cached_bytes = 1024 * 1024; // per thread
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Process-wide counters for memory allocated by zlib.
+///
+/// \details allocations counts every request made by zlib, while
+///         system_allocations counts only those which couldn't be satisfied
+///         from a thread's cache.  bytes_in_use does not include cached
+///         blocks.
+struct ZlibAllocatorStats {
+   U64 allocations = 0;
+   U64 system_allocations = 0;
+   std::size_t bytes_in_use = 0;
+   std::size_t peak_bytes_in_use = 0;
+};
+
+ZlibAllocatorConfig zlib_allocator_config() noexcept;
+void zlib_allocator_config(const ZlibAllocatorConfig& config) noexcept;
+
+ZlibAllocatorStats zlib_allocator_stats() noexcept;
+void reset_zlib_allocator_stats() noexcept;
+
+void release_zlib_allocator_cache() noexcept;
+
+namespace detail {
+
+void* zlib_alloc(void* opaque, unsigned items, unsigned size) noexcept;
+void zlib_free(void* opaque, void* ptr) noexcept;
+
+} // be::util::detail
+} // be::util
+
+#endif
@@ -0,0 +1,31 @@
+#pragma once
+#ifndef BE_UTIL_COMPRESSION_ZLIB_DICTIONARY_HPP_
+#define BE_UTIL_COMPRESSION_ZLIB_DICTIONARY_HPP_
+
+#include "zlib.hpp"
+
+namespace be::util {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The largest dictionary deflate can make use of; only the last
+///         32 KiB of a longer dictionary is ever referenced.
+constexpr std::size_t max_zlib_dictionary_size = 32 * 1024;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The dictionary size train_zlib_dictionary() targets by default.
+///
+/// \details deflate hashes the whole dictionary at the start of every
+///         stream, so for small messages a large dictionary costs more time
+///         than it saves.  On ~200 byte structured messages, 1 KiB gets
+///         nearly the full ratio improvement while still being faster than
+///         using no dictionary at all.
+constexpr std::size_t default_zlib_dictionary_size = 1024;
+
+Buf<UC> train_zlib_dictionary(gsl::span<const Buf<const UC>> samples, std::size_t max_size = default_zlib_dictionary_size);
+
+U32 zlib_dictionary_id(const Buf<const UC>& dictionary) noexcept;
+bool zlib_stream_dictionary_id(const Buf<const UC>& compressed, U32& id, bool encoded_length = true) noexcept;
+
+} // be::util
+
+#endif
@@ -0,0 +1,64 @@
+#pragma once
+#ifndef BE_UTIL_COMPRESSION_ZLIB_SEEKABLE_HPP_
+#define BE_UTIL_COMPRESSION_ZLIB_SEEKABLE_HPP_
+
+#include "zlib.hpp"
+
+namespace be::util {
+
+Buf<UC> deflate_seekable_buf(const Buf<const UC>& data, std::size_t frame_size = 64 * 1024, I8 level = 7);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Provides random access to data compressed with
+///         deflate_seekable_buf(), decompressing only the frames that are
+///         actually read.
+///
+/// \details The container is a sequence of independently deflated frames,
+///         each holding frame_size() bytes of the original data (except the
+///         last, which may be shorter), followed by an index of the
+///         compressed end offset of each frame and a footer.  All integers
+///         are big-endian:
+///         \code
+///         frame 0 .. frame N-1    zlib streams
+///         U64 x N                 end offset of each frame
+///         U64                     uncompressed size
+///         U32                     frame size
+///         U32                     magic ('BZsk')
+///         \endcode
+///
+///         The most recently decompressed frame is cached, so many small
+///         sequential reads only decompress each frame once.  Frames that are
+///         entirely covered by a read are decompressed directly into the
+///         caller's buffer.
+///
+///         Not thread-safe; use one reader per thread.  The readers can share
+///         the same compressed data.
+class SeekableZlibReader final {
+public:
+   explicit SeekableZlibReader(Buf<const UC> compressed);
+
+   std::size_t size() const noexcept;
+   std::size_t frame_size() const noexcept;
+   std::size_t frame_count() const noexcept;
+
+   std::size_t read(std::size_t offset, gsl::span<UC> output);
+   Buf<UC> read(std::size_t offset, std::size_t size);
+
+private:
+   std::size_t frame_begin_(std::size_t frame) const noexcept;
+   std::size_t frame_end_(std::size_t frame) const noexcept;
+   void inflate_frame_(std::size_t frame, UC* output, std::size_t size);
+
+   Buf<const UC> data_;
+   const UC* index_;
+   std::size_t size_;
+   std::size_t frame_size_;
+   std::size_t frame_count_;
+   ZlibInflater inflater_;
+   Buf<UC> cache_;
+   std::size_t cached_frame_;
+};
+
+} // be::util
+
+#endif
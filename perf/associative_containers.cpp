@@ -0,0 +1,255 @@
+#ifdef BE_TEST_PERF
+
+#include "benchmark.hpp"
+#include "concurrent_string_interner.hpp"
+#include "string_interner.hpp"
+#include <catch/catch.hpp>
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#define BE_CATCH_TAGS "[util][util:string][perf]"
+
+using namespace be;
+using namespace be::util::bench;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The node-based std::unordered_set approach StringInterner used
+///         before it had its own table; kept as a baseline.
+class UnorderedSetInterner {
+public:
+   void reserve_strings(std::size_t count) {
+      set_.reserve(count);
+   }
+
+   SV operator()(SV str) {
+      auto it = set_.find(str);
+      if (it != set_.end()) {
+         return *it;
+      }
+      storage_.push_back(std::make_unique<char[]>(str.size()));
+      std::copy(str.begin(), str.end(), storage_.back().get());
+      SV value(storage_.back().get(), str.size());
+      set_.insert(value);
+      return value;
+   }
+
+private:
+   std::unordered_set<SV> set_;
+   std::vector<std::unique_ptr<char[]>> storage_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A StringInterner shared between threads by serializing all calls
+///         on a mutex.
+class LockedStringInterner {
+public:
+   SV operator()(SV str) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return interner_(str);
+   }
+
+private:
+   std::mutex mutex_;
+   util::StringInterner interner_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+std::vector<S> make_identifiers(std::size_t vocabulary, std::size_t count, U64 seed) {
+   std::mt19937_64 prng(seed);
+   std::uniform_int_distribution<std::size_t> len_dist(4, 24);
+   std::uniform_int_distribution<int> char_dist(0, 36);
+   std::vector<S> words;
+   for (std::size_t i = 0; i < vocabulary; ++i) {
+      S str = "id_";
+      for (std::size_t n = len_dist(prng); n > 0; --n) {
+         int c = char_dist(prng);
+         str.push_back(c < 26 ? char('a' + c) : c < 36 ? char('0' + c - 26) : '_');
+      }
+      words.push_back(std::move(str));
+   }
+
+   std::vector<S> result;
+   std::uniform_int_distribution<std::size_t> pick(0, vocabulary - 1);
+   for (std::size_t i = 0; i < count; ++i) {
+      result.push_back(words[pick(prng)]);
+   }
+   return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Interns a stream of identifiers drawn from a fixed vocabulary, as
+///         a parser would while reading asset or config files.  Most calls
+///         are lookups of strings which have already been interned.
+template <typename T, std::size_t Vocabulary, std::size_t Lookups, bool Reserve = false>
+class InternTest {
+public:
+   InternTest()
+      : input_(make_identifiers(Vocabulary, Lookups, Vocabulary))
+   { }
+
+   F64 test() {
+      sw_.start();
+      T interner;
+      if (Reserve) {
+         interner.reserve_strings(Vocabulary);
+      }
+      std::size_t check = 0;
+      for (const S& str : input_) {
+         check += interner(str).size();
+      }
+      sw_.stop();
+
+      out_ = check;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<S> input_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t Vocabulary, std::size_t Lookups>
+void add_interners(BenchmarkSuite& suite) {
+   suite.add<InternTest<UnorderedSetInterner, Vocabulary, Lookups>>("std::unordered_set");
+   suite.add<InternTest<UnorderedSetInterner, Vocabulary, Lookups, true>>("std::unordered_set (reserved)");
+   suite.add<InternTest<util::StringInterner, Vocabulary, Lookups>>("util::StringInterner");
+   suite.add<InternTest<util::StringInterner, Vocabulary, Lookups, true>>("util::StringInterner (reserved)");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Simulates startup: builds an interner holding a catalog of
+///         identifiers, either by interning each one or by adopting a
+///         snapshot image in place (as if it had been memory-mapped), then
+///         interns a stream of identifiers from the catalog.
+template <std::size_t Vocabulary, std::size_t Lookups, bool Snapshot>
+class StartupTest {
+public:
+   StartupTest()
+      : catalog_(make_identifiers(Vocabulary, Vocabulary * 2, Vocabulary)),
+        input_(make_identifiers(Vocabulary, Lookups, Vocabulary))
+   {
+      util::StringInterner interner;
+      for (const S& str : catalog_) {
+         interner(str);
+      }
+      image_ = interner.snapshot();
+   }
+
+   F64 test() {
+      sw_.start();
+      std::unique_ptr<util::StringInterner> interner;
+      if (Snapshot) {
+         interner = std::make_unique<util::StringInterner>(Buf<const UC>(image_.get(), image_.size()));
+      } else {
+         interner = std::make_unique<util::StringInterner>();
+         for (const S& str : catalog_) {
+            (*interner)(str);
+         }
+      }
+      std::size_t check = 0;
+      for (const S& str : input_) {
+         check += (*interner)(str).size();
+      }
+      sw_.stop();
+
+      out_ = check;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<S> catalog_;
+   std::vector<S> input_;
+   Buf<UC> image_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Several threads interning identifiers from the same vocabulary
+///         into one shared interner.
+template <typename T, std::size_t Threads, std::size_t Vocabulary, std::size_t Lookups>
+class SharedInternTest {
+public:
+   SharedInternTest() {
+      for (std::size_t t = 0; t < Threads; ++t) {
+         input_.push_back(make_identifiers(Vocabulary, Lookups, Vocabulary));
+         std::rotate(input_.back().begin(), input_.back().begin() + t * Lookups / Threads, input_.back().end());
+      }
+   }
+
+   F64 test() {
+      auto interner = std::make_unique<T>();
+
+      sw_.start();
+      std::vector<std::thread> threads;
+      for (std::size_t t = 0; t < Threads; ++t) {
+         threads.emplace_back([this, &interner, t]() {
+            for (const S& str : input_[t]) {
+               (*interner)(str);
+            }
+         });
+      }
+      for (auto& t : threads) {
+         t.join();
+      }
+      sw_.stop();
+
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<std::vector<S>> input_;
+};
+
+} // ()
+
+TEST_CASE("util::StringInterner performance comparison", BE_CATCH_TAGS) {
+   SECTION("1000 distinct strings") {
+      BenchmarkSuite suite("intern", "1000 distinct strings");
+      add_interners<1000, 100000>(suite);
+      SUCCEED(suite.run());
+   }
+
+   SECTION("100000 distinct strings") {
+      BenchmarkSuite suite("intern", "100000 distinct strings");
+      add_interners<100000, 400000>(suite);
+      SUCCEED(suite.run());
+   }
+}
+
+TEST_CASE("util::StringInterner snapshot startup performance comparison", BE_CATCH_TAGS) {
+   SECTION("50000 catalog strings, 10000 lookups") {
+      BenchmarkSuite suite("intern startup", "50000 catalog strings, 10000 lookups");
+      suite.add<StartupTest<50000, 10000, false>>("intern catalog");
+      suite.add<StartupTest<50000, 10000, true>>("adopt snapshot");
+      SUCCEED(suite.run());
+   }
+}
+
+TEST_CASE("util::ConcurrentStringInterner performance comparison", BE_CATCH_TAGS) {
+   SECTION("1 thread") {
+      BenchmarkSuite suite("shared intern", "1 thread");
+      suite.add<SharedInternTest<LockedStringInterner, 1, 10000, 100000>>("std::mutex + util::StringInterner");
+      suite.add<SharedInternTest<util::ConcurrentStringInterner, 1, 10000, 100000>>("util::ConcurrentStringInterner");
+      SUCCEED(suite.run());
+   }
+
+   SECTION("4 threads") {
+      BenchmarkSuite suite("shared intern", "4 threads");
+      suite.add<SharedInternTest<LockedStringInterner, 4, 10000, 100000>>("std::mutex + util::StringInterner");
+      suite.add<SharedInternTest<util::ConcurrentStringInterner, 4, 10000, 100000>>("util::ConcurrentStringInterner");
+      SUCCEED(suite.run());
+   }
+}
+
+#endif
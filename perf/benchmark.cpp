@@ -0,0 +1,274 @@
+#ifdef BE_TEST_PERF
+
+#include "benchmark.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <numeric>
+#include <sstream>
+
+namespace be::util::bench {
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+S csv_escape(const S& str) {
+   if (str.find_first_of(",\"\n") == S::npos) {
+      return str;
+   }
+
+   S escaped = "\"";
+   for (char c : str) {
+      if (c == '"') {
+         escaped += '"';
+      }
+      escaped += c;
+   }
+   escaped += '"';
+   return escaped;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+S json_escape(const S& str) {
+   S escaped = "\"";
+   for (char c : str) {
+      switch (c) {
+         case '"':  escaped += "\\\""; break;
+         case '\\': escaped += "\\\\"; break;
+         case '\n': escaped += "\\n"; break;
+         case '\t': escaped += "\\t"; break;
+         default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+               std::ostringstream oss;
+               oss << "\\u" << std::hex << std::setw(4) << std::setfill('0') << int(c);
+               escaped += oss.str();
+            } else {
+               escaped += c;
+            }
+            break;
+      }
+   }
+   escaped += '"';
+   return escaped;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+struct Duration {
+   F64 us;
+};
+
+std::ostream& operator<<(std::ostream& os, Duration d) {
+   std::ostringstream oss;
+   oss << std::fixed << std::setprecision(3) << d.us << " us";
+   return os << std::setw(14) << oss.str();
+}
+
+} // be::util::bench::()
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Computes the p-th percentile (0 <= p <= 1) of a sorted sample set
+///         using linear interpolation between closest ranks.
+F64 percentile(const std::vector<F64>& sorted, F64 p) {
+   if (sorted.empty()) {
+      return 0;
+   }
+
+   F64 rank = p * F64(sorted.size() - 1);
+   std::size_t lower = std::size_t(std::floor(rank));
+   std::size_t upper = std::size_t(std::ceil(rank));
+   F64 fraction = rank - F64(lower);
+   return sorted[lower] + (sorted[upper] - sorted[lower]) * fraction;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+BenchmarkStats summarize(std::vector<F64> samples, F64 outlier_k) {
+   BenchmarkStats stats;
+   if (samples.empty()) {
+      return stats;
+   }
+
+   std::sort(samples.begin(), samples.end());
+
+   if (outlier_k > 0 && samples.size() >= 4) {
+      F64 q1 = percentile(samples, 0.25);
+      F64 q3 = percentile(samples, 0.75);
+      F64 iqr = q3 - q1;
+      F64 low = q1 - outlier_k * iqr;
+      F64 high = q3 + outlier_k * iqr;
+
+      auto first = std::lower_bound(samples.begin(), samples.end(), low);
+      auto last = std::upper_bound(first, samples.end(), high);
+      stats.rejected = samples.size() - std::size_t(last - first);
+      samples = std::vector<F64>(first, last);
+   }
+
+   stats.samples = samples.size();
+   stats.min = samples.front();
+   stats.max = samples.back();
+   stats.p50 = percentile(samples, 0.5);
+   stats.p90 = percentile(samples, 0.9);
+   stats.p99 = percentile(samples, 0.99);
+   stats.mean = std::accumulate(samples.begin(), samples.end(), 0.0) / F64(samples.size());
+
+   if (samples.size() > 1) {
+      F64 u = stats.mean;
+      F64 v = std::accumulate(samples.begin(), samples.end(), 0.0, [u](F64 v, F64 x) { F64 delta = x - u; return v + delta * delta; });
+      stats.stddev = std::sqrt(v / F64(samples.size() - 1));
+   }
+
+   return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the median throughput in megabytes (10^6 bytes) per
+///         second, or 0 if the amount of data processed is unknown.
+F64 BenchmarkResult::p50_mb_per_s() const noexcept {
+   return bytes > 0 && stats.p50 > 0 ? bytes / stats.p50 : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void BenchmarkReport::add(BenchmarkResult result) {
+   results_.push_back(std::move(result));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const std::vector<BenchmarkResult>& BenchmarkReport::results() const noexcept {
+   return results_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+S BenchmarkReport::csv() const {
+   std::ostringstream oss;
+   oss << std::setprecision(6);
+   oss << "suite,section,name,samples,rejected,mean_us,stddev_us,min_us,p50_us,p90_us,p99_us,max_us,p50_mb_s\n";
+   for (auto& r : results_) {
+      const BenchmarkStats& s = r.stats;
+      oss << csv_escape(r.suite) << ','
+          << csv_escape(r.section) << ','
+          << csv_escape(r.name) << ','
+          << s.samples << ','
+          << s.rejected << ','
+          << s.mean << ','
+          << s.stddev << ','
+          << s.min << ','
+          << s.p50 << ','
+          << s.p90 << ','
+          << s.p99 << ','
+          << s.max << ','
+          << r.p50_mb_per_s() << '\n';
+   }
+   return oss.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+S BenchmarkReport::json() const {
+   std::ostringstream oss;
+   oss << std::setprecision(6);
+   oss << "[\n";
+   for (std::size_t i = 0; i < results_.size(); ++i) {
+      const BenchmarkResult& r = results_[i];
+      const BenchmarkStats& s = r.stats;
+      oss << "   { \"suite\": " << json_escape(r.suite)
+          << ", \"section\": " << json_escape(r.section)
+          << ", \"name\": " << json_escape(r.name)
+          << ", \"samples\": " << s.samples
+          << ", \"rejected\": " << s.rejected
+          << ", \"mean_us\": " << s.mean
+          << ", \"stddev_us\": " << s.stddev
+          << ", \"min_us\": " << s.min
+          << ", \"p50_us\": " << s.p50
+          << ", \"p90_us\": " << s.p90
+          << ", \"p99_us\": " << s.p99
+          << ", \"max_us\": " << s.max
+          << ", \"p50_mb_s\": " << r.p50_mb_per_s()
+          << (i + 1 < results_.size() ? " },\n" : " }\n");
+   }
+   oss << "]\n";
+   return oss.str();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes the report to a file.  If the path ends with ".json", JSON
+///         is written; otherwise CSV.
+bool BenchmarkReport::write(const S& path) const {
+   std::ofstream ofs(path, std::ios::binary);
+   if (!ofs) {
+      return false;
+   }
+
+   const S ext = ".json";
+   bool is_json = path.size() >= ext.size() && path.compare(path.size() - ext.size(), ext.size(), ext) == 0;
+   ofs << (is_json ? json() : csv());
+   return bool(ofs);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+BenchmarkReport& benchmark_report() {
+   static BenchmarkReport report;
+   return report;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+BenchmarkSuite::BenchmarkSuite(S suite, S section, BenchmarkConfig config)
+   : suite_(std::move(suite)),
+     section_(std::move(section)),
+     config_(config)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+void BenchmarkSuite::add(S name, std::function<F64()> func, F64 bytes) {
+   benchmarks_.push_back(Benchmark { std::move(name), std::move(func), bytes });
+}
+
+///////////////////////////////////////////////////////////////////////////////
+S BenchmarkSuite::run() {
+   const std::size_t n = benchmarks_.size();
+
+   for (std::size_t i = 0; i < config_.warmup_runs; ++i) {
+      for (auto& b : benchmarks_) {
+         b.func();
+      }
+   }
+
+   std::vector<std::vector<F64>> data(n);
+   for (auto& d : data) {
+      d.reserve(config_.runs);
+   }
+
+   for (std::size_t i = 0; i < config_.runs; ++i) {
+      for (std::size_t b = 0; b < n; ++b) {
+         data[b].push_back(benchmarks_[b].func());
+      }
+   }
+
+   std::ostringstream oss;
+   oss << suite_ << ": " << section_ << " (N = " << config_.runs << " runs, " << config_.warmup_runs << " warmup)\n";
+
+   for (std::size_t b = 0; b < n; ++b) {
+      BenchmarkResult result { suite_, section_, benchmarks_[b].name, summarize(std::move(data[b]), config_.outlier_k), benchmarks_[b].bytes };
+      const BenchmarkStats& s = result.stats;
+
+      oss << std::left
+          << "  p50 = " << Duration { s.p50 }
+          << "  p99 = " << Duration { s.p99 }
+          << "  u = " << Duration { s.mean }
+          << "  s = " << Duration { s.stddev }
+          << "  (" << s.rejected << " rejected)  ";
+
+      if (result.bytes > 0) {
+         std::ostringstream mbps;
+         mbps << std::fixed << std::setprecision(1) << result.p50_mb_per_s() << " MB/s";
+         oss << std::right << std::setw(14) << mbps.str() << std::left << "  ";
+      }
+
+      oss << result.name << '\n';
+
+      benchmark_report().add(std::move(result));
+   }
+
+   return oss.str();
+}
+
+} // be::util::bench
+
+#endif
@@ -0,0 +1,140 @@
+#pragma once
+#ifndef BE_UTIL_PERF_BENCHMARK_HPP_
+#define BE_UTIL_PERF_BENCHMARK_HPP_
+
+#include <be/core/be.hpp>
+#include <chrono>
+#include <functional>
+#include <memory>
+#include <vector>
+
+namespace be::util::bench {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Measures elapsed wall time using std::chrono::steady_clock.
+class Stopwatch {
+public:
+   using clock = std::chrono::steady_clock;
+
+   void start() noexcept {
+      start_ = clock::now();
+      stop_ = start_;
+   }
+
+   void stop() noexcept {
+      stop_ = clock::now();
+   }
+
+   F64 micros() const noexcept {
+      return std::chrono::duration<F64, std::micro>(stop_ - start_).count();
+   }
+
+private:
+   clock::time_point start_;
+   clock::time_point stop_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+struct BenchmarkConfig {
+   std::size_t warmup_runs = 3;
+   std::size_t runs = 40;
+
+   /// Samples further than outlier_k interquartile ranges outside of the
+   /// first or third quartile are discarded before computing statistics.
+   /// Set to 0 to keep all samples.
+   F64 outlier_k = 1.5;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Summary of a set of timing samples.  All times are in
+///         microseconds.
+struct BenchmarkStats {
+   std::size_t samples = 0;
+   std::size_t rejected = 0;
+   F64 mean = 0;
+   F64 stddev = 0;
+   F64 min = 0;
+   F64 p50 = 0;
+   F64 p90 = 0;
+   F64 p99 = 0;
+   F64 max = 0;
+};
+
+F64 percentile(const std::vector<F64>& sorted, F64 p);
+BenchmarkStats summarize(std::vector<F64> samples, F64 outlier_k);
+
+///////////////////////////////////////////////////////////////////////////////
+struct BenchmarkResult {
+   S suite;
+   S section;
+   S name;
+   BenchmarkStats stats;
+
+   /// The amount of data processed by each run, if applicable.  Used to
+   /// report throughput.
+   F64 bytes = 0;
+
+   F64 p50_mb_per_s() const noexcept;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Collects results from all benchmarks run by the perf app so that
+///         they can be written out in a machine-readable format once all
+///         tests have completed.
+class BenchmarkReport {
+public:
+   void add(BenchmarkResult result);
+   const std::vector<BenchmarkResult>& results() const noexcept;
+
+   S csv() const;
+   S json() const;
+
+   bool write(const S& path) const;
+
+private:
+   std::vector<BenchmarkResult> results_;
+};
+
+BenchmarkReport& benchmark_report();
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A group of benchmarks which are compared against each other.
+///
+/// \details Each benchmark is a callable that performs one timed run and
+///         returns the elapsed time in microseconds.  If the number of bytes
+///         processed per run is provided, throughput is reported as well.  Runs are interleaved
+///         across all benchmarks in the suite so that transient system noise
+///         is spread evenly rather than penalizing a single entry.
+class BenchmarkSuite {
+public:
+   BenchmarkSuite(S suite, S section, BenchmarkConfig config = BenchmarkConfig());
+
+   void add(S name, std::function<F64()> func, F64 bytes = 0);
+
+   /// Constructs a T on the heap and adds a benchmark which calls T::test().
+   template <typename T>
+   void add(S name, F64 bytes = 0) {
+      auto ptr = std::make_shared<T>();
+      add(std::move(name), [ptr]() { return ptr->test(); }, bytes);
+   }
+
+   /// Runs all benchmarks, records the results in benchmark_report(), and
+   /// returns a human-readable summary.
+   S run();
+
+private:
+   S suite_;
+   S section_;
+   BenchmarkConfig config_;
+   struct Benchmark {
+      S name;
+      std::function<F64()> func;
+      F64 bytes;
+   };
+
+   std::vector<Benchmark> benchmarks_;
+};
+
+} // be::util::bench
+
+#endif
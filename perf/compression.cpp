@@ -0,0 +1,505 @@
+#ifdef BE_TEST_PERF
+
+#include "benchmark.hpp"
+#include "compression_codec.hpp"
+#include "zlib.hpp"
+#include "zlib_allocator.hpp"
+#include "zlib_dictionary.hpp"
+#include "zlib_seekable.hpp"
+#include <catch/catch.hpp>
+#include <random>
+#include <thread>
+#include <vector>
+
+#define BE_CATCH_TAGS "[util][util:compression][perf]"
+
+using namespace be;
+using namespace be::util::bench;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Generates compressible messages that look vaguely like text.
+std::vector<UC> make_messages(std::size_t size, std::size_t count) {
+   std::mt19937 prng(static_cast<std::mt19937::result_type>(size));
+   std::uniform_int_distribution<int> letter(0, 25);
+   std::uniform_int_distribution<int> length(1, 9);
+
+   std::vector<S> words(200);
+   for (S& word : words) {
+      word.resize(std::size_t(length(prng)));
+      for (char& c : word) {
+         c = char('a' + letter(prng));
+      }
+   }
+
+   std::uniform_int_distribution<std::size_t> pick(0, words.size() - 1);
+   std::vector<UC> data;
+   data.reserve(size * count);
+   while (data.size() < size * count) {
+      const S& word = words[pick(prng)];
+      data.insert(data.end(), word.begin(), word.end());
+      data.push_back(' ');
+   }
+   data.resize(size * count);
+   return data;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t Size, std::size_t Count>
+class DeflateBufTest {
+public:
+   DeflateBufTest()
+      : data_(make_messages(Size, Count))
+   { }
+
+   F64 test() {
+      std::size_t total = 0;
+      sw_.start();
+      for (std::size_t i = 0; i < Count; ++i) {
+         total += util::deflate_buf(make_buf<const UC>(data_.data() + i * Size, Size)).size();
+      }
+      sw_.stop();
+
+      out_ = total;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<UC> data_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t Size, std::size_t Count>
+class ZlibDeflaterTest {
+public:
+   ZlibDeflaterTest()
+      : data_(make_messages(Size, Count))
+   { }
+
+   F64 test() {
+      std::size_t total = 0;
+      sw_.start();
+      for (std::size_t i = 0; i < Count; ++i) {
+         total += deflater_.deflate_buf(make_buf<const UC>(data_.data() + i * Size, Size)).size();
+      }
+      sw_.stop();
+
+      out_ = total;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<UC> data_;
+   util::ZlibDeflater deflater_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <bool Reuse, std::size_t Size, std::size_t Count>
+class InflateTest {
+public:
+   InflateTest() {
+      std::vector<UC> data = make_messages(Size, Count);
+      for (std::size_t i = 0; i < Count; ++i) {
+         compressed_.push_back(util::deflate_buf(make_buf<const UC>(data.data() + i * Size, Size)));
+      }
+   }
+
+   F64 test() {
+      std::size_t total = 0;
+      sw_.start();
+      for (auto& buf : compressed_) {
+         Buf<const UC> in = make_buf<const UC>(buf.get(), buf.size());
+         if (Reuse) {
+            total += inflater_.inflate_buf(std::move(in)).size();
+         } else {
+            total += util::inflate_buf(std::move(in)).size();
+         }
+      }
+      sw_.stop();
+
+      out_ = total;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<Buf<UC>> compressed_;
+   util::ZlibInflater inflater_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses and then decompresses each message using deflate_into()
+///         and inflate_into() with reused output buffers.
+template <std::size_t Size, std::size_t Count>
+class IntoTest {
+public:
+   IntoTest()
+      : data_(make_messages(Size, Count))
+   { }
+
+   F64 test() {
+      std::size_t total = 0;
+      sw_.start();
+      for (std::size_t i = 0; i < Count; ++i) {
+         std::size_t size = util::deflate_into(make_buf<const UC>(data_.data() + i * Size, Size), compressed_);
+         total += util::inflate_into(make_buf<const UC>(compressed_.get(), size), uncompressed_);
+      }
+      sw_.stop();
+
+      out_ = total;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<UC> data_;
+   Buf<UC> compressed_;
+   Buf<UC> uncompressed_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses and then decompresses each message using deflate_buf()
+///         and inflate_buf(), for comparison with IntoTest.
+template <std::size_t Size, std::size_t Count>
+class RoundTripTest {
+public:
+   RoundTripTest()
+      : data_(make_messages(Size, Count))
+   { }
+
+   F64 test() {
+      std::size_t total = 0;
+      sw_.start();
+      for (std::size_t i = 0; i < Count; ++i) {
+         Buf<UC> compressed = util::deflate_buf(make_buf<const UC>(data_.data() + i * Size, Size));
+         total += util::inflate_buf(std::move(compressed)).size();
+      }
+      sw_.stop();
+
+      out_ = total;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<UC> data_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses and decompresses each message with deflate_buf() and
+///         inflate_buf() using the given zlib allocator mode.
+template <util::ZlibAllocatorMode Mode, std::size_t Size, std::size_t Count>
+class AllocatorTest {
+public:
+   AllocatorTest()
+      : data_(make_messages(Size, Count))
+   { }
+
+   F64 test() {
+      const util::ZlibAllocatorConfig original = util::zlib_allocator_config();
+      util::ZlibAllocatorConfig config = original;
+      config.mode = Mode;
+      util::zlib_allocator_config(config);
+
+      std::size_t total = 0;
+      sw_.start();
+      for (std::size_t i = 0; i < Count; ++i) {
+         Buf<UC> compressed = util::deflate_buf(make_buf<const UC>(data_.data() + i * Size, Size));
+         total += util::inflate_buf(std::move(compressed)).size();
+      }
+      sw_.stop();
+
+      util::zlib_allocator_config(original);
+      out_ = total;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<UC> data_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses one large buffer with deflate_buf_parallel(), or with
+///         deflate_buf() if threads is 0.
+class ParallelDeflateTest {
+public:
+   ParallelDeflateTest(const std::vector<UC>& data, std::size_t threads)
+      : data_(data),
+        threads_(threads)
+   { }
+
+   F64 test() {
+      Buf<const UC> in = make_buf<const UC>(data_.data(), data_.size());
+      sw_.start();
+      std::size_t size = threads_ == 0 ? util::deflate_buf(std::move(in)).size()
+                                       : util::deflate_buf_parallel(std::move(in), threads_).size();
+      sw_.stop();
+
+      out_ = size;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   const std::vector<UC>& data_;
+   std::size_t threads_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Reads Count bytes from a random offset within a compressed buffer
+///         of Size bytes, either by inflating the whole buffer or by using
+///         SeekableZlibReader.
+template <bool Seekable, std::size_t Size, std::size_t Count>
+class RandomReadTest {
+public:
+   RandomReadTest()
+      : prng_(Size)
+   {
+      std::vector<UC> data = make_messages(Size, 1);
+      Buf<const UC> in = make_buf<const UC>(data.data(), data.size());
+      if (Seekable) {
+         reader_ = std::make_unique<util::SeekableZlibReader>(util::deflate_seekable_buf(std::move(in)));
+      } else {
+         compressed_ = util::deflate_buf(std::move(in));
+      }
+   }
+
+   F64 test() {
+      std::uniform_int_distribution<std::size_t> dist(0, Size - Count);
+      const std::size_t offset = dist(prng_);
+      UC buf[Count];
+
+      sw_.start();
+      if (Seekable) {
+         reader_->read(offset, buf);
+      } else {
+         Buf<UC> all = util::inflate_buf(make_buf<const UC>(compressed_.get(), compressed_.size()));
+         memcpy(buf, all.get() + offset, Count);
+      }
+      sw_.stop();
+
+      out_ = buf[0];
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::mt19937_64 prng_;
+   Buf<UC> compressed_;
+   std::unique_ptr<util::SeekableZlibReader> reader_;
+   UC out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Generates small structured messages which share most of their
+///         text, like serialized network or log records.
+std::vector<S> make_records(std::size_t count) {
+   std::mt19937 prng(static_cast<std::mt19937::result_type>(count));
+   std::uniform_int_distribution<int> dist(0, 99999);
+
+   std::vector<S> records;
+   for (std::size_t i = 0; i < count; ++i) {
+      records.push_back("{\"type\":\"position_update\",\"entity\":" + std::to_string(dist(prng)) +
+                        ",\"position\":{\"x\":" + std::to_string(dist(prng)) + ",\"y\":" + std::to_string(dist(prng)) +
+                        "},\"velocity\":{\"x\":" + std::to_string(dist(prng) % 10) + ",\"y\":0}" +
+                        ",\"flags\":[\"visible\",\"solid\"],\"name\":\"entity_" + std::to_string(dist(prng) % 50) +
+                        "\",\"zone\":\"overworld_" + std::to_string(dist(prng) % 8) + "\"}");
+   }
+   return records;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses and decompresses each record with a ZlibDeflater and
+///         ZlibInflater, optionally using a dictionary trained on a separate
+///         set of records.
+template <bool Dictionary, std::size_t Count>
+class DictionaryRoundTripTest {
+public:
+   DictionaryRoundTripTest()
+      : records_(make_records(Count * 2))
+   {
+      if (Dictionary) {
+         std::vector<Buf<const UC>> samples;
+         for (std::size_t i = Count; i < Count * 2; ++i) {
+            samples.push_back(make_buf(records_[i].c_str(), records_[i].size()));
+         }
+         dictionary_ = util::train_zlib_dictionary(samples);
+         deflater_.dictionary(make_buf<const UC>(dictionary_.get(), dictionary_.size()));
+         inflater_.dictionary(make_buf<const UC>(dictionary_.get(), dictionary_.size()));
+      }
+   }
+
+   F64 test() {
+      std::size_t total = 0;
+      sw_.start();
+      for (std::size_t i = 0; i < Count; ++i) {
+         Buf<UC> compressed = deflater_.deflate_buf(make_buf(records_[i].c_str(), records_[i].size()));
+         total += inflater_.inflate_buf(std::move(compressed)).size();
+      }
+      sw_.stop();
+
+      out_ = total;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<S> records_;
+   Buf<UC> dictionary_;
+   util::ZlibDeflater deflater_;
+   util::ZlibInflater inflater_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses each message with compress_buf() and decompresses it
+///         again with decompress_buf().
+template <std::size_t Size, std::size_t Count>
+class CodecRoundTripTest {
+public:
+   CodecRoundTripTest(util::CodecType type)
+      : type_(type),
+        data_(make_messages(Size, Count))
+   { }
+
+   F64 test() {
+      std::size_t compressed = 0;
+      sw_.start();
+      for (std::size_t i = 0; i < Count; ++i) {
+         Buf<UC> frame = util::compress_buf(make_buf<const UC>(data_.data() + i * Size, Size), type_);
+         compressed += frame.size();
+         util::decompress_buf(std::move(frame));
+      }
+      sw_.stop();
+
+      out_ = compressed;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   util::CodecType type_;
+   std::vector<UC> data_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t Size, std::size_t Count>
+void add_codec_tests(BenchmarkSuite& suite) {
+   for (util::CodecType type : { util::CodecType::zlib, util::CodecType::lz4, util::CodecType::zstd }) {
+      if (!util::codec_available(type)) {
+         continue;
+      }
+      auto ptr = std::make_shared<CodecRoundTripTest<Size, Count>>(type);
+      suite.add(S("util::compress_buf + decompress_buf (") + util::codec_type_name(type) + ")", [ptr]() { return ptr->test(); }, F64(Size * Count));
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t Size, std::size_t Count>
+void add_message_tests(BenchmarkSuite& suite) {
+   suite.add<DeflateBufTest<Size, Count>>("util::deflate_buf");
+   suite.add<ZlibDeflaterTest<Size, Count>>("util::ZlibDeflater");
+   suite.add<InflateTest<false, Size, Count>>("util::inflate_buf");
+   suite.add<InflateTest<true, Size, Count>>("util::ZlibInflater");
+   suite.add<RoundTripTest<Size, Count>>("util::deflate_buf + inflate_buf");
+   suite.add<IntoTest<Size, Count>>("util::deflate_into + inflate_into");
+}
+
+} // ()
+
+TEST_CASE("util::deflate_buf_parallel performance scaling", BE_CATCH_TAGS) {
+   const std::size_t size = 16 * 1024 * 1024;
+   auto data = std::make_shared<std::vector<UC>>(make_messages(size, 1));
+
+   BenchmarkConfig config;
+   config.warmup_runs = 1;
+   config.runs = 8;
+   BenchmarkSuite suite("zlib", "1 x 16 MiB", config);
+
+   auto add = [&](S name, std::size_t threads) {
+      auto ptr = std::make_shared<ParallelDeflateTest>(*data, threads);
+      suite.add(std::move(name), [ptr, data]() { return ptr->test(); }, F64(size));
+   };
+
+   add("util::deflate_buf", 0);
+
+   const std::size_t cores = std::max(std::size_t(std::thread::hardware_concurrency()), std::size_t(1));
+   for (std::size_t threads = 1; threads < cores; threads *= 2) {
+      add("util::deflate_buf_parallel (" + std::to_string(threads) + (threads == 1 ? " thread)" : " threads)"), threads);
+   }
+   add("util::deflate_buf_parallel (" + std::to_string(cores) + (cores == 1 ? " thread)" : " threads)"), cores);
+
+   SUCCEED(suite.run());
+}
+
+TEST_CASE("util::SeekableZlibReader performance comparison", BE_CATCH_TAGS) {
+   BenchmarkSuite suite("zlib", "4 KiB random reads from 8 MiB");
+   suite.add<RandomReadTest<false, 8 * 1024 * 1024, 4096>>("util::inflate_buf");
+   suite.add<RandomReadTest<true, 8 * 1024 * 1024, 4096>>("util::SeekableZlibReader");
+   SUCCEED(suite.run());
+}
+
+TEST_CASE("util::ZlibDeflater performance comparison", BE_CATCH_TAGS) {
+   SECTION("100 byte messages") {
+      BenchmarkSuite suite("zlib", "1000 x 100 bytes");
+      add_message_tests<100, 1000>(suite);
+      SUCCEED(suite.run());
+   }
+
+   SECTION("4 KiB messages") {
+      BenchmarkSuite suite("zlib", "100 x 4 KiB");
+      add_message_tests<4096, 100>(suite);
+      SUCCEED(suite.run());
+   }
+}
+
+TEST_CASE("util::ZlibAllocatorConfig performance comparison", BE_CATCH_TAGS) {
+   SECTION("100 byte messages") {
+      BenchmarkSuite suite("zlib", "1000 x 100 bytes");
+      suite.add<AllocatorTest<util::ZlibAllocatorMode::system, 100, 1000>>("util::ZlibAllocatorMode::system", 100 * 1000);
+      suite.add<AllocatorTest<util::ZlibAllocatorMode::thread_cache, 100, 1000>>("util::ZlibAllocatorMode::thread_cache", 100 * 1000);
+      SUCCEED(suite.run());
+   }
+
+   SECTION("4 KiB messages") {
+      BenchmarkSuite suite("zlib", "100 x 4 KiB");
+      suite.add<AllocatorTest<util::ZlibAllocatorMode::system, 4096, 100>>("util::ZlibAllocatorMode::system", 4096 * 100);
+      suite.add<AllocatorTest<util::ZlibAllocatorMode::thread_cache, 4096, 100>>("util::ZlibAllocatorMode::thread_cache", 4096 * 100);
+      SUCCEED(suite.run());
+   }
+}
+
+TEST_CASE("util::train_zlib_dictionary performance comparison", BE_CATCH_TAGS) {
+   BenchmarkSuite suite("zlib", "1000 structured records");
+   suite.add<DictionaryRoundTripTest<false, 1000>>("util::ZlibDeflater + ZlibInflater");
+   suite.add<DictionaryRoundTripTest<true, 1000>>("util::ZlibDeflater + ZlibInflater (dictionary)");
+   SUCCEED(suite.run());
+}
+
+TEST_CASE("util::Codec performance comparison", BE_CATCH_TAGS) {
+   SECTION("4 KiB messages") {
+      BenchmarkSuite suite("compression", "100 x 4 KiB");
+      add_codec_tests<4096, 100>(suite);
+      SUCCEED(suite.run());
+   }
+
+   SECTION("4 MiB buffer") {
+      BenchmarkSuite suite("compression", "1 x 4 MiB");
+      add_codec_tests<4 * 1024 * 1024, 1>(suite);
+      SUCCEED(suite.run());
+   }
+}
+
+#endif
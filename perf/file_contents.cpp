@@ -0,0 +1,140 @@
+#ifdef BE_TEST_PERF
+
+#include "benchmark.hpp"
+#include "get_file_contents.hpp"
+#include "mapped_file.hpp"
+#include <catch/catch.hpp>
+#include <cstdio>
+#include <fstream>
+#include <vector>
+
+#define BE_CATCH_TAGS "[util][util:fs][perf]"
+
+using namespace be;
+using namespace be::util::bench;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+enum class LoadMethod {
+   file_ptr,
+   path,
+   path_mapped,
+   mapped_file
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a file in the temp directory which is removed when the
+///         test case ends.
+class TempFile {
+public:
+   explicit TempFile(std::size_t size)
+      : path_(fs::temp_directory_path() / "be_util_perf_file_contents.bin")
+   {
+      std::vector<UC> data(size);
+      for (std::size_t i = 0; i < size; ++i) {
+         data[i] = UC(i * 31 + (i >> 12));
+      }
+      std::ofstream ofs(path_.native(), std::ios::binary | std::ios::trunc);
+      ofs.write(reinterpret_cast<const char*>(data.data()), std::streamsize(size));
+   }
+
+   ~TempFile() {
+      std::error_code ec;
+      fs::remove(path_, ec);
+   }
+
+   const Path& path() const noexcept {
+      return path_;
+   }
+
+private:
+   Path path_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Loads the whole file, then optionally reads one byte from every
+///         page, since a mapping defers the cost of reading until then.
+template <LoadMethod Method, bool Touch>
+class LoadTest {
+public:
+   explicit LoadTest(const Path& path)
+      : path_(path)
+   { }
+
+   F64 test() {
+      sw_.start();
+      std::size_t sum = 0;
+      if (Method == LoadMethod::file_ptr) {
+         FILE* fd = std::fopen(path_.string().c_str(), "rb");
+         Buf<UC> data = util::get_file_contents_buf(fd);
+         std::fclose(fd);
+         sum = touch(data.get(), data.size());
+      } else if (Method == LoadMethod::path) {
+         Buf<UC> data = util::get_file_contents_buf(path_);
+         sum = touch(data.get(), data.size());
+      } else if (Method == LoadMethod::path_mapped) {
+         Buf<const UC> data = util::get_file_contents_mapped(path_);
+         sum = touch(data.get(), data.size());
+      } else {
+         util::MappedFile file(path_, util::MappedFileAccess::sequential);
+         sum = touch(file.data(), file.size());
+      }
+      sw_.stop();
+
+      out_ += sum;
+      return sw_.micros();
+   }
+
+private:
+   static std::size_t touch(const UC* data, std::size_t size) noexcept {
+      std::size_t sum = size;
+      if (Touch) {
+         for (std::size_t i = 0; i < size; i += 4096) {
+            sum += data[i];
+         }
+      }
+      return sum;
+   }
+
+   Stopwatch sw_;
+   Path path_;
+   std::size_t out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <bool Touch>
+void add_load_tests(BenchmarkSuite& suite, const Path& path, std::size_t size) {
+   auto add = [&](S name, auto ptr) {
+      suite.add(std::move(name), [ptr]() { return ptr->test(); }, F64(size));
+   };
+   add("util::get_file_contents_buf(FILE*)", std::make_shared<LoadTest<LoadMethod::file_ptr, Touch>>(path));
+   add("util::get_file_contents_buf(const Path&)", std::make_shared<LoadTest<LoadMethod::path, Touch>>(path));
+   add("util::get_file_contents_mapped", std::make_shared<LoadTest<LoadMethod::path_mapped, Touch>>(path));
+   add("util::MappedFile", std::make_shared<LoadTest<LoadMethod::mapped_file, Touch>>(path));
+}
+
+} // ()
+
+TEST_CASE("util::MappedFile performance comparison", BE_CATCH_TAGS) {
+   const std::size_t size = 64 * 1024 * 1024;
+   TempFile file(size);
+
+   BenchmarkConfig config;
+   config.warmup_runs = 1;
+   config.runs = 10;
+
+   SECTION("load") {
+      BenchmarkSuite suite("fs", "1 x 64 MiB", config);
+      add_load_tests<false>(suite, file.path(), size);
+      SUCCEED(suite.run());
+   }
+
+   SECTION("load and read every page") {
+      BenchmarkSuite suite("fs", "1 x 64 MiB", config);
+      add_load_tests<true>(suite, file.path(), size);
+      SUCCEED(suite.run());
+   }
+}
+
+#endif
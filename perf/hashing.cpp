@@ -0,0 +1,140 @@
+#ifdef BE_TEST_PERF
+
+#include "benchmark.hpp"
+#include "fnv.hpp"
+#include <catch/catch.hpp>
+#include <functional>
+#include <random>
+#include <vector>
+
+#define BE_CATCH_TAGS "[util][util:fnv][perf]"
+
+using namespace be;
+using namespace be::util::bench;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+struct Fnv1aIterators {
+   U64 operator()(SV data) const {
+      return util::fnv1a<U64>(data.begin(), data.end());
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+struct Fnv1aHasher {
+   U64 operator()(SV data) const {
+      return util::FnvHasher<U64>().update(data).digest();
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+struct Fnv1aWordHasher {
+   U64 operator()(SV data) const {
+      return util::FnvWordHasher<U64>().update(data).digest();
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+struct StdHash {
+   U64 operator()(SV data) const {
+      return std::hash<SV>()(data);
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+struct Fnv256Digest {
+   U64 operator()(SV data) const {
+      return util::fnv256_1a_digest(data)[31];
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+struct Fnv256Hex {
+   U64 operator()(SV data) const {
+      return U64(util::fnv256_1a(data).back());
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Hashes Count separate buffers of Size random bytes each.
+template <typename H, std::size_t Size, std::size_t Count>
+class HashTest {
+public:
+   HashTest()
+      : data_(Size * Count)
+   {
+      std::mt19937_64 prng(Size);
+      std::uniform_int_distribution<int> dist(0, 255);
+      for (char& c : data_) {
+         c = char(dist(prng));
+      }
+   }
+
+   F64 test() {
+      U64 check = 0;
+      sw_.start();
+      for (std::size_t i = 0; i < Count; ++i) {
+         check ^= H()(SV(data_.data() + i * Size, Size));
+      }
+      sw_.stop();
+
+      out_ = check;
+      return sw_.micros();
+   }
+
+private:
+   Stopwatch sw_;
+   std::vector<char> data_;
+   U64 out_ = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t Size, std::size_t Count>
+void add_hashers(BenchmarkSuite& suite) {
+   suite.add<HashTest<Fnv1aIterators, Size, Count>>("util::fnv1a");
+   suite.add<HashTest<Fnv1aHasher, Size, Count>>("util::FnvHasher");
+   suite.add<HashTest<Fnv1aWordHasher, Size, Count>>("util::FnvWordHasher");
+   suite.add<HashTest<StdHash, Size, Count>>("std::hash<SV>");
+}
+
+} // ()
+
+TEST_CASE("util::FnvHasher performance comparison", BE_CATCH_TAGS) {
+   SECTION("16 byte keys") {
+      BenchmarkSuite suite("hash", "100000 x 16 bytes");
+      add_hashers<16, 100000>(suite);
+      SUCCEED(suite.run());
+   }
+
+   SECTION("64 byte keys") {
+      BenchmarkSuite suite("hash", "25000 x 64 bytes");
+      add_hashers<64, 25000>(suite);
+      SUCCEED(suite.run());
+   }
+
+   SECTION("1 MiB buffer") {
+      BenchmarkSuite suite("hash", "1 x 1 MiB");
+      add_hashers<1024 * 1024, 1>(suite);
+      SUCCEED(suite.run());
+   }
+}
+
+
+TEST_CASE("util::fnv256 performance comparison", BE_CATCH_TAGS) {
+   SECTION("64 byte keys") {
+      BenchmarkSuite suite("fnv256", "25000 x 64 bytes");
+      suite.add<HashTest<Fnv256Digest, 64, 25000>>("util::fnv256_1a_digest");
+      suite.add<HashTest<Fnv256Hex, 64, 25000>>("util::fnv256_1a");
+      SUCCEED(suite.run());
+   }
+
+   SECTION("1 MiB buffer") {
+      BenchmarkSuite suite("fnv256", "1 x 1 MiB");
+      suite.add<HashTest<Fnv256Digest, 1024 * 1024, 1>>("util::fnv256_1a_digest");
+      suite.add<HashTest<Fnv256Hex, 1024 * 1024, 1>>("util::fnv256_1a");
+      SUCCEED(suite.run());
+   }
+}
+
+#endif
@@ -1,5 +1,28 @@
 #ifdef BE_TEST_PERF
-#define CATCH_CONFIG_MAIN
+#define CATCH_CONFIG_RUNNER
 #define CATCH_CONFIG_CONSOLE_WIDTH 160
 #include <catch/catch.hpp>
+#include "benchmark.hpp"
+#include <cstdlib>
+#include <iostream>
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Runs all perf tests.  If the BE_PERF_OUTPUT environment variable
+///         is set, the collected benchmark results are written to the file it
+///         names (JSON if it ends in ".json", otherwise CSV).
+int main(int argc, char* argv[]) {
+   int result = Catch::Session().run(argc, argv);
+
+   const char* output = std::getenv("BE_PERF_OUTPUT");
+   if (output && *output) {
+      if (!be::util::bench::benchmark_report().write(output)) {
+         std::cerr << "Failed to write benchmark results to " << output << std::endl;
+         if (result == 0) {
+            result = 1;
+         }
+      }
+   }
+
+   return result;
+}
 #endif
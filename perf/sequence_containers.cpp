@@ -1,39 +1,63 @@
-#if false // WIP
-
+#ifdef BE_TEST_PERF
+
+#include "benchmark.hpp"
+#include "block_pool.hpp"
+#include "chunked_list.hpp"
+#include "chunked_list_algorithms.hpp"
+#include "concurrent_chunked_list.hpp"
+#include <catch/catch.hpp>
+#include <algorithm>
+#include <deque>
+#include <iterator>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <random>
+#include <thread>
+#include <vector>
+
+#define BE_CATCH_TAGS "[util][util:ChunkedList][perf]"
+
+using namespace be;
+using namespace be::util::bench;
 
 namespace {
 
-#pragma region perf util
-
-template <class T, size_t N>
-class perf_test
-{
-public:
-   using t_type = T;
-   using X = typename T::value_type;
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A trivially copyable element type of arbitrary size.
+template <std::size_t Bytes>
+struct Blob {
+   Blob(U32 v = 0) {
+      std::fill(std::begin(data), std::end(data), v);
+   }
 
-private:
-   be::U32 hexdig(char ch)
-   {
-      ch = (char)tolower(ch);
-      if (ch >= '0' && ch <= '9')
-         return ch - '0';
+   Blob& operator+=(const Blob& other) {
+      data[0] += other.data[0];
+      return *this;
+   }
 
-      return ch - 'a';
+   bool operator<(const Blob& other) const {
+      return data[0] < other.data[0];
    }
 
+   U32 data[Bytes / sizeof(U32)];
+};
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, std::size_t N>
+class PerfTest {
+public:
+   using X = typename T::value_type;
+
 protected:
-   perf_test()
-   {
-      std::string seq = "65670EA23AA24A0A3EB7178BBB188474CB89137472F8D5ECF709324778732F32AF0EDF940785F509859263CC909CB76ED7B596A5B1D1B7FAEED0D3456816F105";
+   PerfTest() {
+      const char* seq = "65670EA23AA24A0A3EB7178BBB188474CB89137472F8D5ECF709324778732F32AF0EDF940785F509859263CC909CB76ED7B596A5B1D1B7FAEED0D3456816F105";
 
-      be::U32 ssdata[16] = { };
-      for (int i = 0; i < 16; ++i)
-      {
-         for (int j = 0; j < 8; ++j)
-         {
+      U32 ssdata[16] = { };
+      for (std::size_t i = 0; i < 16; ++i) {
+         for (std::size_t j = 0; j < 8; ++j) {
             ssdata[i] <<= 4;
-            ssdata[i] |= hexdig(seq[i * 8 + j]);
+            ssdata[i] |= hexdig_(seq[i * 8 + j]);
          }
       }
 
@@ -41,1019 +65,827 @@ protected:
       prng_.seed(ss);
    }
 
-   void init_(int index, size_t size)
-   {
+   void init_(std::size_t index, std::size_t size) {
       tcon_[index] = T();
 
-      for (size_t i = 0; i < size; ++i)
-         tcon_[index].push_back(prng_());
+      for (std::size_t i = 0; i < size; ++i) {
+         tcon_[index].push_back(X(prng_()));
+      }
    }
 
    T tcon_[N];
-
+   X out_ = X();
    std::mt19937 prng_;
+   Stopwatch sw_;
 
-#ifdef _MSC_VER
-   void start_()
-   {
-      QueryPerformanceFrequency(&freq_);
-      QueryPerformanceCounter(&st_);
+private:
+   static U32 hexdig_(char c) {
+      if (c >= '0' && c <= '9') {
+         return U32(c - '0');
+      }
+      return U32(c - 'A' + 10);
    }
+};
 
-   void stop_()
-   {
-      QueryPerformanceCounter(&et_);
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class IterTest : public PerfTest<T, N> {
+   using base = PerfTest<T, N>;
+public:
+   IterTest() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, Size);
+      }
    }
 
-   double micro_() const
-   {
-      double micro = 1000000.0 * (et_.QuadPart - st_.QuadPart);
-      micro /= freq_.QuadPart;
+   F64 test() {
+      typename base::X xsum = 0;
 
-      return micro;
-   }
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         for (auto it(this->tcon_[i].begin()), end(this->tcon_[i].end()); it != end; ++it) {
+            xsum += *it;
+         }
+      }
+      this->sw_.stop();
 
-   LARGE_INTEGER st_, et_, freq_;
-#endif
+      this->out_ = xsum;
+      return this->sw_.micros();
+   }
 };
 
-template <class I>
-double mean(I begin, I end)
-{
-   // sample size
-   int n = std::distance(begin, end);
-
-   // mean
-   double u = std::accumulate(begin, end, 0.0);
-   u /= n;
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class ChunkIterTest : public PerfTest<T, N> {
+   using base = PerfTest<T, N>;
+public:
+   ChunkIterTest() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, Size);
+      }
+   }
 
-   return u;
-}
+   F64 test() {
+      typename base::X xsum = 0;
 
-template <class I>
-double sstddev(I begin, I end)
-{
-   // sample size
-   int n = std::distance(begin, end);
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         this->tcon_[i].for_each_chunk([&xsum](typename T::const_chunk_type chunk) {
+            for (auto x : chunk) {
+               xsum += x;
+            }
+         });
+      }
+      this->sw_.stop();
 
-   // mean
-   double u = std::accumulate(begin, end, 0.0);
-   u /= n;
+      this->out_ = xsum;
+      return this->sw_.micros();
+   }
+};
 
-   // sample variance
-   double v = std::accumulate(begin, end, 0.0, [u](double v, double x) { double delta = x - u; return v + delta * delta; });
-   v /= n - 1;
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class AccumulateTest : public PerfTest<T, N> {
+   using base = PerfTest<T, N>;
+public:
+   AccumulateTest() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, Size);
+      }
+   }
 
-   // sample deviation
-   return sqrt(v);
-}
+   F64 test() {
+      typename base::X xsum = 0;
 
-#pragma warning(push)
-#pragma warning(disable: 4127) // constant conditional
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         const T& con = this->tcon_[i];
+         xsum = util::accumulate(con.begin(), con.end(), xsum);
+      }
+      this->sw_.stop();
 
-template <size_t N>
-struct run_test_helper
-{
-   template <class... T>
-   double operator()(size_t n, std::tuple<T...>& tests)
-   {
-      return n == N ? std::get<N>(tests).test() : run_test_helper<N - 1>()(n, tests);
-   }
-};
-template <>
-struct run_test_helper<0>
-{
-   template <class... T>
-   double operator()(size_t n, std::tuple<T...>& tests)
-   {
-      return n == 0 ? std::get<0>(tests).test() : 0.0;
+      this->out_ = xsum;
+      return this->sw_.micros();
    }
 };
 
-template <size_t N>
-struct test_name_helper
-{
-   template <class... T>
-   std::string operator()(size_t n, std::tuple<T...>& tests)
-   {
-      return n == N ? typeid(std::get<N>(tests)).name() : test_name_helper<N - 1>()(n, tests);
-   }
-};
-template <>
-struct test_name_helper<0>
-{
-   template <class... T>
-   std::string operator()(size_t n, std::tuple<T...>&)
-   {
-      return n == 0 ? typeid(std::get<0>(std::tuple<T...>())).name() : "[TEST NOT FOUND]";
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class RndAccessTest : public PerfTest<T, 1> {
+   using base = PerfTest<T, 1>;
+public:
+   RndAccessTest() {
+      this->init_(0, Size);
    }
-};
-
-#pragma warning(pop)
 
-struct ptduration
-{
-   ptduration(double t) : us(t) { }
-   double us;
-};
+   F64 test() {
+      typename base::X xsum = 0;
 
-std::ostream& operator<<(std::ostream& os, const ptduration& duration)
-{
-   double t = duration.us;
-
-   std::ostringstream oss;
-   oss << std::setprecision(4);
-   //if (t > 1000.0)
-   //{
-   //   oss << (t / 1000.0) << " ms";
-   //}
-   //else if (t < 1.0)
-   //{
-   //   oss << (t * 1000.0) << " ns";
-   //}
-   //else
-   //{
-   oss << t << " us";
-   //}
-   return (os << std::setw(10) << oss.str());
-}
+      std::vector<std::size_t> indices(N);
+      for (std::size_t i = 0; i < N; ++i) {
+         indices[i] = this->prng_() % Size;
+      }
 
-template <class... T>
-std::string run_tests(const std::string& info, int n, std::tuple<T...>&& tests)
-{
-   std::vector<std::vector<double>> data;
+      auto& con = this->tcon_[0];
 
-   size_t ntypes = sizeof...(T);
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         xsum += con[indices[i]];
+      }
+      this->sw_.stop();
 
-   for (size_t t = 0; t < ntypes; ++t)
-   {
-      data.emplace_back();
+      this->out_ = xsum;
+      return this->sw_.micros();
    }
+};
 
-   for (int i = 0; i < n; ++i)
-   {
-      for (size_t t = 0; t < ntypes; ++t)
-      {
-         data[t].push_back(run_test_helper<sizeof...(T) - 1>()(t, tests));
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class PushTest : public PerfTest<T, N> {
+public:
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, 0);
+      }
+
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         for (std::size_t j = 0; j < Size; ++j) {
+            this->tcon_[i].emplace_back();
+         }
       }
+      this->sw_.stop();
+
+      return this->sw_.micros();
    }
+};
 
-   std::ostringstream oss;
-   oss << info << " (N = " << n << " tests)\n";
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class PushNTest : public PerfTest<T, N> {
+   using base = PerfTest<T, N>;
+public:
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, 0);
+      }
 
-   for (size_t t = 0; t < ntypes; ++t)
-   {
-      double u = mean(data[t].begin(), data[t].end());
-      double sd = sstddev(data[t].begin(), data[t].end());
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         auto& con = this->tcon_[i];
+         con.insert(con.begin(), Size, typename base::X());
+      }
+      this->sw_.stop();
 
-      oss << std::left
-         << "  u = " << ptduration(u)
-         << " s = " << ptduration(sd)
-         << "  " << test_name_helper<sizeof...(T)-1>()(t, tests)
-         << std::endl;
+      return this->sw_.micros();
    }
-   return oss.str();
-}
+};
 
-template <typename T>
-std::unique_ptr<T> make_unique(T* ptr)
-{
-   return std::unique_ptr<T>(ptr);
+///////////////////////////////////////////////////////////////////////////////
+template <typename C, typename B>
+void append_buffer(C& con, const B& buf) {
+   con.insert(con.end(), buf.begin(), buf.end());
 }
 
-#pragma endregion
+///////////////////////////////////////////////////////////////////////////////
+template <typename T, typename A, std::size_t N, std::size_t M, std::size_t S, bool X, typename B>
+void append_buffer(util::ChunkedList<T, A, N, M, S, X>& con, const B& buf) {
+   con.append_range(buf);
+}
 
-template <size_t N, size_t S, class T>
-class iter_test : public perf_test<T, N>
-{
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a decoded buffer one element at a time.
+template <std::size_t N, std::size_t Size, typename T, bool Reserve = false>
+class AppendLoopTest : public PerfTest<T, N> {
+   using base = PerfTest<T, N>;
 public:
-   iter_test()
-   {
-      for (int i = 0; i < N; ++i)
-      {
-         init_(i, S);
+   AppendLoopTest() {
+      for (std::size_t i = 0; i < Size; ++i) {
+         buf_.push_back(typename base::X(this->prng_()));
       }
    }
 
-   double test()
-   {
-      X x;
-      return test(&x);
-   }
-
-   double test(X* xout)
-   {
-      X xsum = 0;
-      double xtime;
-
-      start_();
-      for (int i = 0; i < N; ++i)
-      {
-         for (auto iter(tcon_[i].begin()), end(tcon_[i].end()); iter != end; ++iter)
-            xsum += *iter;
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, 0);
       }
-      stop_();
-      xtime = micro_();
 
-      if (xout)
-         *xout = xsum;
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         auto& con = this->tcon_[i];
+         if constexpr (Reserve) {
+            con.reserve(Size);
+         }
+         for (const auto& x : buf_) {
+            con.push_back(x);
+         }
+      }
+      this->sw_.stop();
 
-      return xtime;
+      return this->sw_.micros();
    }
 
+private:
+   std::vector<typename base::X> buf_;
 };
 
-template <size_t N, size_t S, class T>
-class rnd_access_test : public perf_test<T, 1>
-{
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends a decoded buffer with a single bulk call.
+template <std::size_t N, std::size_t Size, typename T>
+class AppendRangeTest : public PerfTest<T, N> {
+   using base = PerfTest<T, N>;
 public:
-   rnd_access_test()
-   {
-      init_(0, S);
+   AppendRangeTest() {
+      for (std::size_t i = 0; i < Size; ++i) {
+         buf_.push_back(typename base::X(this->prng_()));
+      }
    }
 
-   double test()
-   {
-      X x;
-      return test(&x);
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, 0);
+      }
+
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         append_buffer(this->tcon_[i], buf_);
+      }
+      this->sw_.stop();
+
+      return this->sw_.micros();
    }
 
-   double test(X* xout)
-   {
-      X xsum = 0;
-      double xtime;
+private:
+   std::vector<typename base::X> buf_;
+};
 
-      size_t indices[N];
-      for (int i = 0; i < N; ++i)
-      {
-         indices[i] = prng_() % S;
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class InsertTest : public PerfTest<T, N> {
+   using base = PerfTest<T, N>;
+public:
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, Size);
       }
 
-      start_();
-      for (int i = 0; i < N; ++i)
-      {
-         xsum += tcon_[0][indices[i]];
+      std::vector<std::size_t> indices(Size);
+      for (std::size_t i = 0; i < Size; ++i) {
+         indices[i] = this->prng_();
       }
-      stop_();
-      xtime = micro_();
 
-      if (xout)
-         *xout = xsum;
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         auto& con = this->tcon_[i];
 
-      return xtime;
-   }
+         for (std::size_t j = 0; j < Size; ++j) {
+            auto it = con.begin();
+            std::advance(it, indices[j] % con.size());
+            con.insert(it, typename base::X());
+         }
+      }
+      this->sw_.stop();
 
+      return this->sw_.micros();
+   }
 };
 
-template <size_t N, size_t S, class T>
-class push_test : public perf_test<T, N>
-{
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class EraseTest : public PerfTest<T, N> {
+   using base = PerfTest<T, N>;
 public:
-   double test()
-   {
-      X x;
-      return test(&x);
-   }
-
-   double test(X* xout)
-   {
-      double xtime;
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, Size * 2);
+      }
 
-      for (int i = 0; i < N; ++i)
-      {
-         init_(i, 0);
+      std::vector<std::size_t> indices(Size);
+      for (std::size_t i = 0; i < Size; ++i) {
+         indices[i] = this->prng_();
       }
 
-      start_();
-      for (int i = 0; i < N; ++i)
-      {
-         for (int j = 0; j < S; ++j)
-         {
-            tcon_[i].emplace_back();
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         auto& con = this->tcon_[i];
+
+         for (std::size_t j = 0; j < Size; ++j) {
+            auto it = con.begin();
+            std::advance(it, indices[j] % con.size());
+            con.erase(it);
          }
       }
-      stop_();
-      xtime = micro_();
+      this->sw_.stop();
 
-      if (xout)
-         *xout = X();
-
-      return xtime;
+      return this->sw_.micros();
    }
-
 };
 
-template <size_t N, size_t S, class T>
-class push_n_test : public perf_test<T, N>
-{
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class PopBackTest : public PerfTest<T, N> {
 public:
-   double test()
-   {
-      X x;
-      return test(&x);
-   }
-
-   double test(X* xout)
-   {
-      double xtime;
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, Size);
+      }
 
-      for (int i = 0; i < N; ++i)
-      {
-         init_(i, 0);
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         auto& con = this->tcon_[i];
+         while (!con.empty()) {
+            con.pop_back();
+         }
       }
+      this->sw_.stop();
+
+      return this->sw_.micros();
+   }
+};
 
-      start_();
-      for (int i = 0; i < N; ++i)
-      {
-         auto& con = tcon_[i];
-         con.insert(con.begin(), S, int());
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class SortTest : public PerfTest<T, N> {
+public:
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, Size);
       }
-      stop_();
-      xtime = micro_();
 
-      if (xout)
-         *xout = X();
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         auto& con = this->tcon_[i];
+         std::sort(con.begin(), con.end());
+      }
+      this->sw_.stop();
 
-      return xtime;
+      return this->sw_.micros();
    }
-
 };
 
-template <size_t N, size_t S, class T>
-class insert_test : public perf_test<T, N>
-{
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class ListSortTest : public PerfTest<T, N> {
 public:
-   double test()
-   {
-      X x;
-      return test(&x);
-   }
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, Size);
+      }
 
-   double test(X* xout)
-   {
-      double xtime;
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         this->tcon_[i].sort();
+      }
+      this->sw_.stop();
+
+      return this->sw_.micros();
+   }
+};
 
-      for (int i = 0; i < N; ++i)
-      {
-         init_(i, S);
+///////////////////////////////////////////////////////////////////////////////
+template <std::size_t N, std::size_t Size, typename T>
+class StableSortTest : public PerfTest<T, N> {
+public:
+   F64 test() {
+      for (std::size_t i = 0; i < N; ++i) {
+         this->init_(i, Size);
       }
 
-      size_t indices[S];
-      for (int i = 0; i < S; ++i)
-      {
-         indices[i] = prng_();
+      this->sw_.start();
+      for (std::size_t i = 0; i < N; ++i) {
+         auto& con = this->tcon_[i];
+         std::stable_sort(con.begin(), con.end());
       }
+      this->sw_.stop();
 
-      start_();
-      for (int i = 0; i < N; ++i)
-      {
-         auto& con = tcon_[i];
+      return this->sw_.micros();
+   }
+};
 
-         for (int j = 0; j < S; ++j)
-         {
-            auto iter = con.begin();
-            std::advance(iter, (indices[j] % con.size()));
-            con.insert(iter, int());
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Builds N containers of Size elements on each of Threads threads,
+///         then destroys them all from the calling thread.
+template <std::size_t N, std::size_t Size, typename T, std::size_t Threads = 1>
+class ChurnTest {
+public:
+   F64 test() {
+      std::vector<std::vector<T>> cons(Threads);
+
+      sw_.start();
+      if (Threads == 1) {
+         build_(cons[0]);
+      } else {
+         std::vector<std::thread> threads;
+         for (auto& c : cons) {
+            threads.emplace_back([&c]() { build_(c); });
+         }
+         for (auto& t : threads) {
+            t.join();
          }
       }
-      stop_();
-      xtime = micro_();
+      cons.clear();
+      sw_.stop();
+
+      return sw_.micros();
+   }
 
-      if (xout)
-         *xout = X();
+private:
+   static void build_(std::vector<T>& cons) {
+      cons.resize(N);
+      for (std::size_t i = 0; i < N; ++i) {
+         for (std::size_t j = 0; j < Size; ++j) {
+            cons[i].push_back(int(j));
+         }
+      }
 
-      return xtime;
+      // interleave frees and allocations
+      for (std::size_t i = 0; i < N; i += 2) {
+         cons[i] = T();
+      }
+      for (std::size_t i = 0; i < N; i += 2) {
+         for (std::size_t j = 0; j < Size; ++j) {
+            cons[i].push_back(int(j));
+         }
+      }
    }
 
+   Stopwatch sw_;
 };
 
-template <size_t N, size_t S, class T>
-class pop_back_test : public perf_test<T, N>
-{
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  A ChunkedList shared between threads by guarding it with a mutex.
+template <typename T>
+class LockedChunkedList {
 public:
-   double test()
-   {
-      X x;
-      return test(&x);
+   void push_back(const T& value) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      con_.push_back(value);
    }
 
-   double test(X* xout)
-   {
-      double xtime;
-
-      for (int i = 0; i < N; ++i)
-      {
-         init_(i, S);
-      }
+   std::size_t size() {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return con_.size();
+   }
 
-      start_();
-      for (int i = 0; i < N; ++i)
-      {
-         auto& con = tcon_[i];
+private:
+   std::mutex mutex_;
+   util::ChunkedList<T> con_;
+};
 
-         while (!con.empty())
-            con.pop_back();
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Appends Size elements to a single shared container from each of
+///         Threads threads.
+template <std::size_t Size, typename T, std::size_t Threads>
+class SharedAppendTest {
+public:
+   F64 test() {
+      auto con = std::make_unique<T>();
+
+      sw_.start();
+      std::vector<std::thread> threads;
+      for (std::size_t t = 0; t < Threads; ++t) {
+         threads.emplace_back([&con, t]() {
+            for (std::size_t i = 0; i < Size; ++i) {
+               con->push_back(U64(t) << 32 | U64(i));
+            }
+         });
       }
-      stop_();
-      xtime = micro_();
-
-      if (xout)
-         *xout = X();
+      for (auto& t : threads) {
+         t.join();
+      }
+      sw_.stop();
 
-      return xtime;
+      out_ = con->size();
+      return sw_.micros();
    }
 
+private:
+   Stopwatch sw_;
+   std::size_t out_ = 0;
 };
 
-template <size_t N, size_t S, class T>
-class sort_test : public perf_test<T, N>
-{
-public:
-   double test()
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Adds the ChunkedList configurations and random-access standard
+///         containers to a suite.
+template <template <std::size_t, std::size_t, typename> class Test, std::size_t N, std::size_t Size>
+void add_random_access_containers(BenchmarkSuite& suite) {
+   suite.add<Test<N, Size, util::ChunkedList<int>>>("ChunkedList<int>");
+   suite.add<Test<N, Size, util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>>("ChunkedList<int, std::allocator<int>, 8, 3, 2>");
+   suite.add<Test<N, Size, util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>>("ChunkedList<int, std::allocator<int>, 4, 4, 1>");
+   suite.add<Test<N, Size, util::ChunkedList<int, std::allocator<int>, 16, 7, 2, true>>>("ChunkedList<int, std::allocator<int>, 16, 7, 2, true>");
+   suite.add<Test<N, Size, std::vector<int>>>("std::vector<int>");
+   suite.add<Test<N, Size, std::deque<int>>>("std::deque<int>");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Adds ChunkedList layouts with various node sizes, including the
+///         one chosen by ChunkedListAutoLayout, for element type T.
+template <template <std::size_t, std::size_t, typename> class Test, std::size_t N, std::size_t Size, typename T>
+void add_layouts(BenchmarkSuite& suite, const S& name) {
+   using alloc = std::allocator<T>;
+   using layout = util::ChunkedListAutoLayout<T>;
+   suite.add<Test<N, Size, util::ChunkedList<T>>>("ChunkedList<" + name + "> (N = 16, M = 7, S = 2)");
+   suite.add<Test<N, Size, util::AutoChunkedList<T>>>("AutoChunkedList<" + name + "> (N = " + std::to_string(layout::chunk_size) +
+                                                         ", M = " + std::to_string(layout::chunks_per_metanode) +
+                                                         ", S = " + std::to_string(layout::static_chunks) + ")");
+   suite.add<Test<N, Size, util::ChunkedList<T, alloc, 4, 7, 6>>>("ChunkedList<" + name + "> (N = 4, M = 7, S = 6)");
+   suite.add<Test<N, Size, util::ChunkedList<T, alloc, 64, 7, 6>>>("ChunkedList<" + name + "> (N = 64, M = 7, S = 6)");
+   suite.add<Test<N, Size, util::ChunkedList<T, alloc, 512, 7, 6>>>("ChunkedList<" + name + "> (N = 512, M = 7, S = 6)");
+   suite.add<Test<N, Size, std::vector<T>>>("std::vector<" + name + ">");
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <template <std::size_t, std::size_t, typename> class Test, std::size_t N, std::size_t Size>
+void run_layout_sweep(const S& suite_name) {
    {
-      X x;
-      return test(&x);
+      BenchmarkSuite suite(suite_name, "U8, con.size() == " + std::to_string(Size));
+      add_layouts<Test, N, Size, U8>(suite, "U8");
+      SUCCEED(suite.run());
    }
-
-   double test(X* xout)
    {
-      double xtime;
+      BenchmarkSuite suite(suite_name, "int, con.size() == " + std::to_string(Size));
+      add_layouts<Test, N, Size, int>(suite, "int");
+      SUCCEED(suite.run());
+   }
+   {
+      BenchmarkSuite suite(suite_name, "Blob<200>, con.size() == " + std::to_string(Size));
+      add_layouts<Test, N, Size, Blob<200>>(suite, "Blob<200>");
+      SUCCEED(suite.run());
+   }
+}
 
-      for (int i = 0; i < N; ++i)
-      {
-         init_(i, S);
-      }
+} // ()
 
-      start_();
-      for (int i = 0; i < N; ++i)
-      {
-         auto& con = tcon_[i];
-         std::sort(con.begin(), con.end());
-      }
-      stop_();
-      xtime = micro_();
+TEST_CASE("util::ChunkedList iteration performance comparison", BE_CATCH_TAGS) {
+   SECTION("con.size() == 10") {
+      BenchmarkSuite suite("iteration", "con.size() == 10");
+      add_random_access_containers<IterTest, 1000, 10>(suite);
+      suite.add<IterTest<1000, 10, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
+   }
 
-      if (xout)
-         *xout = X();
+   SECTION("con.size() == 100") {
+      BenchmarkSuite suite("iteration", "con.size() == 100");
+      add_random_access_containers<IterTest, 100, 100>(suite);
+      suite.add<IterTest<100, 100, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
+   }
+}
 
-      return xtime;
+TEST_CASE("util::ChunkedList segmented iteration performance comparison", BE_CATCH_TAGS) {
+   using con_type = util::ChunkedList<int>;
+   using indexed_con_type = util::ChunkedList<int, std::allocator<int>, 16, 7, 2, true>;
+
+   SECTION("con.size() == 100") {
+      BenchmarkSuite suite("segmented iteration", "con.size() == 100");
+      suite.add<IterTest<100, 100, con_type>>("ChunkedList<int> iterator");
+      suite.add<ChunkIterTest<100, 100, con_type>>("ChunkedList<int> for_each_chunk");
+      suite.add<AccumulateTest<100, 100, con_type>>("ChunkedList<int> util::accumulate");
+      suite.add<IterTest<100, 100, indexed_con_type>>("ChunkedList<int, std::allocator<int>, 16, 7, 2, true> iterator");
+      suite.add<ChunkIterTest<100, 100, indexed_con_type>>("ChunkedList<int, std::allocator<int>, 16, 7, 2, true> for_each_chunk");
+      suite.add<IterTest<100, 100, std::vector<int>>>("std::vector<int> iterator");
+      SUCCEED(suite.run());
+   }
+
+   SECTION("con.size() == 5000") {
+      BenchmarkSuite suite("segmented iteration", "con.size() == 5000");
+      suite.add<IterTest<4, 5000, con_type>>("ChunkedList<int> iterator");
+      suite.add<ChunkIterTest<4, 5000, con_type>>("ChunkedList<int> for_each_chunk");
+      suite.add<AccumulateTest<4, 5000, con_type>>("ChunkedList<int> util::accumulate");
+      suite.add<IterTest<4, 5000, indexed_con_type>>("ChunkedList<int, std::allocator<int>, 16, 7, 2, true> iterator");
+      suite.add<ChunkIterTest<4, 5000, indexed_con_type>>("ChunkedList<int, std::allocator<int>, 16, 7, 2, true> for_each_chunk");
+      suite.add<IterTest<4, 5000, std::vector<int>>>("std::vector<int> iterator");
+      SUCCEED(suite.run());
    }
+}
 
-};
+TEST_CASE("util::ChunkedList layout sweep", BE_CATCH_TAGS) {
+   SECTION("emplace_back") {
+      run_layout_sweep<PushTest, 20, 1000>("layout sweep: emplace_back");
+   }
 
-template <size_t N, size_t S, class T>
-class list_sort_test : public perf_test<T, N>
-{
-public:
-   double test()
-   {
-      X x;
-      return test(&x);
+   SECTION("iteration") {
+      run_layout_sweep<IterTest, 20, 1000>("layout sweep: iteration");
    }
 
-   double test(X* xout)
-   {
-      double xtime;
+   SECTION("random access") {
+      run_layout_sweep<RndAccessTest, 5000, 1000>("layout sweep: random access");
+   }
+}
 
-      for (int i = 0; i < N; ++i)
-      {
-         init_(i, S);
-      }
+TEST_CASE("util::ChunkedList random access performance comparison", BE_CATCH_TAGS) {
+   SECTION("con.size() == 10, n_accesses == 100") {
+      BenchmarkSuite suite("random access", "con.size() == 10, n_accesses == 100");
+      add_random_access_containers<RndAccessTest, 100, 10>(suite);
+      SUCCEED(suite.run());
+   }
 
-      start_();
-      for (int i = 0; i < N; ++i)
-      {
-         auto& con = tcon_[i];
-         con.sort();
-      }
-      stop_();
-      xtime = micro_();
+   SECTION("con.size() == 100, n_accesses == 100") {
+      BenchmarkSuite suite("random access", "con.size() == 100, n_accesses == 100");
+      add_random_access_containers<RndAccessTest, 100, 100>(suite);
+      SUCCEED(suite.run());
+   }
 
-      if (xout)
-         *xout = X();
+   SECTION("con.size() == 10, n_accesses == 5000") {
+      BenchmarkSuite suite("random access", "con.size() == 10, n_accesses == 5000");
+      add_random_access_containers<RndAccessTest, 5000, 10>(suite);
+      SUCCEED(suite.run());
+   }
 
-      return xtime;
+   SECTION("con.size() == 100, n_accesses == 5000") {
+      BenchmarkSuite suite("random access", "con.size() == 100, n_accesses == 5000");
+      add_random_access_containers<RndAccessTest, 5000, 100>(suite);
+      SUCCEED(suite.run());
    }
 
-};
+   SECTION("con.size() == 5000, n_accesses == 5000") {
+      BenchmarkSuite suite("random access", "con.size() == 5000, n_accesses == 5000");
+      add_random_access_containers<RndAccessTest, 5000, 5000>(suite);
+      SUCCEED(suite.run());
+   }
+}
 
-template <size_t N, size_t S, class T>
-class stable_sort_test : public perf_test<T, N>
-{
-public:
-   double test()
-   {
-      X x;
-      return test(&x);
+TEST_CASE("util::ChunkedList emplace_back performance comparison", BE_CATCH_TAGS) {
+   SECTION("con.size() == 10") {
+      BenchmarkSuite suite("emplace_back", "con.size() == 10");
+      add_random_access_containers<PushTest, 1000, 10>(suite);
+      suite.add<PushTest<1000, 10, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
    }
 
-   double test(X* xout)
-   {
-      double xtime;
+   SECTION("con.size() == 100") {
+      BenchmarkSuite suite("emplace_back", "con.size() == 100");
+      add_random_access_containers<PushTest, 100, 100>(suite);
+      suite.add<PushTest<100, 100, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
+   }
+}
 
-      for (int i = 0; i < N; ++i)
-      {
-         init_(i, S);
-      }
+TEST_CASE("util::ChunkedList allocator performance comparison", BE_CATCH_TAGS) {
+   using std_con = util::ChunkedList<int>;
+   using pool_con = util::ChunkedList<int, util::PoolAllocator<int>>;
 
-      start_();
-      for (int i = 0; i < N; ++i)
-      {
-         auto& con = tcon_[i];
-         std::stable_sort(con.begin(), con.end());
-      }
-      stop_();
-      xtime = micro_();
+   SECTION("1 thread, 2000 x con.size() == 100") {
+      BenchmarkSuite suite("allocator churn", "1 thread, 2000 x con.size() == 100");
+      suite.add<ChurnTest<2000, 100, std_con>>("ChunkedList<int>");
+      suite.add<ChurnTest<2000, 100, pool_con>>("ChunkedList<int, PoolAllocator<int>>");
+      suite.add<ChurnTest<2000, 100, std::list<int>>>("std::list<int>");
+      suite.add<ChurnTest<2000, 100, std::list<int, util::PoolAllocator<int>>>>("std::list<int, PoolAllocator<int>>");
+      SUCCEED(suite.run());
+   }
 
-      if (xout)
-         *xout = X();
+   SECTION("4 threads, 2000 x con.size() == 100") {
+      BenchmarkSuite suite("allocator churn", "4 threads, 2000 x con.size() == 100");
+      suite.add<ChurnTest<2000, 100, std_con, 4>>("ChunkedList<int>");
+      suite.add<ChurnTest<2000, 100, pool_con, 4>>("ChunkedList<int, PoolAllocator<int>>");
+      suite.add<ChurnTest<2000, 100, std::list<int>, 4>>("std::list<int>");
+      suite.add<ChurnTest<2000, 100, std::list<int, util::PoolAllocator<int>>, 4>>("std::list<int, PoolAllocator<int>>");
+      SUCCEED(suite.run());
+   }
+}
 
-      return xtime;
+TEST_CASE("util::ConcurrentChunkedList shared append performance comparison", BE_CATCH_TAGS) {
+   SECTION("1 thread, 20000 appends") {
+      BenchmarkSuite suite("shared append", "1 thread, 20000 appends");
+      suite.add<SharedAppendTest<20000, LockedChunkedList<U64>, 1>>("std::mutex + ChunkedList<U64>");
+      suite.add<SharedAppendTest<20000, util::ConcurrentChunkedList<U64>, 1>>("ConcurrentChunkedList<U64>");
+      SUCCEED(suite.run());
    }
 
-};
+   SECTION("4 threads, 20000 appends each") {
+      BenchmarkSuite suite("shared append", "4 threads, 20000 appends each");
+      suite.add<SharedAppendTest<20000, LockedChunkedList<U64>, 4>>("std::mutex + ChunkedList<U64>");
+      suite.add<SharedAppendTest<20000, util::ConcurrentChunkedList<U64>, 4>>("ConcurrentChunkedList<U64>");
+      SUCCEED(suite.run());
+   }
+}
 
-} // ()
+TEST_CASE("util::ChunkedList push back N performance comparison", BE_CATCH_TAGS) {
+   SECTION("con.size() == 10") {
+      BenchmarkSuite suite("push back N", "con.size() == 10");
+      add_random_access_containers<PushNTest, 1000, 10>(suite);
+      suite.add<PushNTest<1000, 10, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
+   }
 
-TEST_CASE("be::util::ChunkedList iteration performance comparison", "[be][be::util::ChunkedList][perf]")
-{
-   SECTION("con.size() == 10")
-   {
-      std::string msg;
-      const size_t n_cons = 1000;
-      const size_t con_size = 10;
-
-      auto tuple = make_unique(new std::tuple<
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               iter_test<n_cons, con_size, std::vector<int>>,
-                               iter_test<n_cons, con_size, std::deque<int>>,
-                               iter_test<n_cons, con_size, std::list<int>>,
-                               iter_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               iter_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-   SECTION("con.size() == 100")
-   {
-      std::string msg;
-      const size_t n_cons = 100;
-      const size_t con_size = 100;
-
-      auto tuple = make_unique(new std::tuple<
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               iter_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               iter_test<n_cons, con_size, std::vector<int>>,
-                               iter_test<n_cons, con_size, std::deque<int>>,
-                               iter_test<n_cons, con_size, std::list<int>>,
-                               iter_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               iter_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
+   SECTION("con.size() == 100") {
+      BenchmarkSuite suite("push back N", "con.size() == 100");
+      add_random_access_containers<PushNTest, 100, 100>(suite);
+      suite.add<PushNTest<100, 100, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
    }
 }
 
-TEST_CASE("be::util::ChunkedList random access performance comparison", "[be][be::util::ChunkedList][perf]")
-{
-   SECTION("con.size() == 10, n_accesses == 100")
-   {
-      std::string msg;
-      const size_t con_size = 10;
-      const size_t n_accesses = 100;
-
-      auto tuple = make_unique(new std::tuple<
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               rnd_access_test<n_accesses, con_size, std::vector<int>>,
-                               rnd_access_test<n_accesses, con_size, std::deque<int>>,
-                               rnd_access_test<n_accesses, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-   SECTION("con.size() == 100, n_accesses == 100")
-   {
-      std::string msg;
-      const size_t con_size = 100;
-      const size_t n_accesses = 100;
-
-      auto tuple = make_unique(new std::tuple<
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               rnd_access_test<n_accesses, con_size, std::vector<int>>,
-                               rnd_access_test<n_accesses, con_size, std::deque<int>>,
-                               rnd_access_test<n_accesses, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-
-   SECTION("con.size() == 10, n_accesses == 5000")
-   {
-      std::string msg;
-      const size_t con_size = 10;
-      const size_t n_accesses = 5000;
-
-      auto tuple = make_unique(new std::tuple<
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               rnd_access_test<n_accesses, con_size, std::vector<int>>,
-                               rnd_access_test<n_accesses, con_size, std::deque<int>>,
-                               rnd_access_test<n_accesses, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-
-   SECTION("con.size() == 100, n_accesses == 5000")
-   {
-      std::string msg;
-      const size_t con_size = 100;
-      const size_t n_accesses = 5000;
-
-      auto tuple = make_unique(new std::tuple<
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               rnd_access_test<n_accesses, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               rnd_access_test<n_accesses, con_size, std::vector<int>>,
-                               rnd_access_test<n_accesses, con_size, std::deque<int>>,
-                               rnd_access_test<n_accesses, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
+TEST_CASE("util::ChunkedList bulk append performance comparison", BE_CATCH_TAGS) {
+   SECTION("U8, con.size() == 1500") {
+      using con_type = util::ChunkedList<U8>;
+      using auto_con_type = util::AutoChunkedList<U8>;
+      BenchmarkSuite suite("bulk append", "U8, con.size() == 1500");
+      suite.add<AppendLoopTest<100, 1500, con_type>>("ChunkedList<U8> push_back");
+      suite.add<AppendLoopTest<100, 1500, con_type, true>>("ChunkedList<U8> reserve + push_back");
+      suite.add<AppendRangeTest<100, 1500, con_type>>("ChunkedList<U8> append_range");
+      suite.add<AppendRangeTest<100, 1500, auto_con_type>>("AutoChunkedList<U8> append_range");
+      suite.add<AppendLoopTest<100, 1500, std::vector<U8>>>("std::vector<U8> push_back");
+      suite.add<AppendRangeTest<100, 1500, std::vector<U8>>>("std::vector<U8> insert");
+      SUCCEED(suite.run());
+   }
+
+   SECTION("int, con.size() == 5000") {
+      using con_type = util::ChunkedList<int>;
+      using indexed_con_type = util::ChunkedList<int, std::allocator<int>, 16, 7, 2, true>;
+      BenchmarkSuite suite("bulk append", "int, con.size() == 5000");
+      suite.add<AppendLoopTest<4, 5000, con_type>>("ChunkedList<int> push_back");
+      suite.add<AppendLoopTest<4, 5000, con_type, true>>("ChunkedList<int> reserve + push_back");
+      suite.add<AppendRangeTest<4, 5000, con_type>>("ChunkedList<int> append_range");
+      suite.add<AppendRangeTest<4, 5000, indexed_con_type>>("ChunkedList<int, std::allocator<int>, 16, 7, 2, true> append_range");
+      suite.add<AppendLoopTest<4, 5000, std::vector<int>>>("std::vector<int> push_back");
+      suite.add<AppendRangeTest<4, 5000, std::vector<int>>>("std::vector<int> insert");
+      SUCCEED(suite.run());
    }
 }
 
-TEST_CASE("be::util::ChunkedList emplace_back performance comparison", "[be][be::util::ChunkedList][perf]")
-{
-   SECTION("con.size() == 10")
-   {
-      std::string msg;
-      const size_t n_cons = 1000;
-      const size_t con_size = 10;
-
-      auto tuple = make_unique(new std::tuple<
-                               push_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               push_test<n_cons, con_size, std::vector<int>>,
-                               push_test<n_cons, con_size, std::deque<int>>,
-                               push_test<n_cons, con_size, std::list<int>>,
-                               push_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               push_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-   SECTION("con.size() == 100")
-   {
-      std::string msg;
-      const size_t n_cons = 100;
-      const size_t con_size = 100;
-
-      auto tuple = make_unique(new std::tuple<
-                               push_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               push_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               push_test<n_cons, con_size, std::vector<int>>,
-                               push_test<n_cons, con_size, std::deque<int>>,
-                               push_test<n_cons, con_size, std::list<int>>,
-                               push_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               push_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
+TEST_CASE("util::ChunkedList random insert performance comparison", BE_CATCH_TAGS) {
+   SECTION("con.size() == 10") {
+      BenchmarkSuite suite("random insert", "con.size() == 10");
+      add_random_access_containers<InsertTest, 1000, 10>(suite);
+      suite.add<InsertTest<1000, 10, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
    }
-}
 
-TEST_CASE("be::util::ChunkedList pushBackN performance comparison", "[be][be::util::ChunkedList][perf]")
-{
-   SECTION("con.size() == 10")
-   {
-      std::string msg;
-      const size_t n_cons = 1000;
-      const size_t con_size = 10;
-
-      auto tuple = make_unique(new std::tuple<
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               push_n_test<n_cons, con_size, std::vector<int>>,
-                               push_n_test<n_cons, con_size, std::deque<int>>,
-                               push_n_test<n_cons, con_size, std::list<int>>,
-                               push_n_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               push_n_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-   SECTION("con.size() == 100")
-   {
-      std::string msg;
-      const size_t n_cons = 100;
-      const size_t con_size = 100;
-
-      auto tuple = make_unique(new std::tuple<
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               push_n_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               push_n_test<n_cons, con_size, std::vector<int>>,
-                               push_n_test<n_cons, con_size, std::deque<int>>,
-                               push_n_test<n_cons, con_size, std::list<int>>,
-                               push_n_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               push_n_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
+   SECTION("con.size() == 100") {
+      BenchmarkSuite suite("random insert", "con.size() == 100");
+      add_random_access_containers<InsertTest, 100, 100>(suite);
+      suite.add<InsertTest<100, 100, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
+   }
+
+   SECTION("con.size() == 300") {
+      BenchmarkSuite suite("random insert", "con.size() == 300");
+      add_random_access_containers<InsertTest, 20, 300>(suite);
+      suite.add<InsertTest<20, 300, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
    }
 }
 
-TEST_CASE("be::util::ChunkedList random insert performance comparison", "[be][be::util::ChunkedList][perf]")
-{
-   SECTION("con.size() == 10")
-   {
-      std::string msg;
-      const size_t n_cons = 1000;
-      const size_t con_size = 10;
-
-      auto tuple = make_unique(new std::tuple<
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               insert_test<n_cons, con_size, std::vector<int>>,
-                               insert_test<n_cons, con_size, std::deque<int>>,
-                               insert_test<n_cons, con_size, std::list<int>>,
-                               insert_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               insert_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-   SECTION("con.size() == 100")
-   {
-      std::string msg;
-      const size_t n_cons = 100;
-      const size_t con_size = 100;
-
-      auto tuple = make_unique(new std::tuple<
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               insert_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               insert_test<n_cons, con_size, std::vector<int>>,
-                               insert_test<n_cons, con_size, std::deque<int>>,
-                               insert_test<n_cons, con_size, std::list<int>>,
-                               insert_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               insert_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
+TEST_CASE("util::ChunkedList random erase performance comparison", BE_CATCH_TAGS) {
+   SECTION("con.size() == 20 -> 10") {
+      BenchmarkSuite suite("random erase", "con.size() == 20 -> 10");
+      add_random_access_containers<EraseTest, 1000, 10>(suite);
+      suite.add<EraseTest<1000, 10, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
+   }
+
+   SECTION("con.size() == 600 -> 300") {
+      BenchmarkSuite suite("random erase", "con.size() == 600 -> 300");
+      add_random_access_containers<EraseTest, 20, 300>(suite);
+      suite.add<EraseTest<20, 300, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
    }
 }
 
-TEST_CASE("be::util::ChunkedList pop_back performance comparison", "[be][be::util::ChunkedList][perf]")
-{
-   SECTION("con.size() == 10")
-   {
-      std::string msg;
-      const size_t n_cons = 1000;
-      const size_t con_size = 10;
-
-      auto tuple = make_unique(new std::tuple<
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               pop_back_test<n_cons, con_size, std::vector<int>>,
-                               pop_back_test<n_cons, con_size, std::deque<int>>,
-                               pop_back_test<n_cons, con_size, std::list<int>>,
-                               pop_back_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               pop_back_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-   SECTION("con.size() == 100")
-   {
-      std::string msg;
-      const size_t n_cons = 100;
-      const size_t con_size = 100;
-
-      auto tuple = make_unique(new std::tuple<
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               pop_back_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               pop_back_test<n_cons, con_size, std::vector<int>>,
-                               pop_back_test<n_cons, con_size, std::deque<int>>,
-                               pop_back_test<n_cons, con_size, std::list<int>>,
-                               pop_back_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               pop_back_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
+TEST_CASE("util::ChunkedList pop_back performance comparison", BE_CATCH_TAGS) {
+   SECTION("con.size() == 10") {
+      BenchmarkSuite suite("pop_back", "con.size() == 10");
+      add_random_access_containers<PopBackTest, 1000, 10>(suite);
+      suite.add<PopBackTest<1000, 10, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
+   }
+
+   SECTION("con.size() == 100") {
+      BenchmarkSuite suite("pop_back", "con.size() == 100");
+      add_random_access_containers<PopBackTest, 100, 100>(suite);
+      suite.add<PopBackTest<100, 100, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
    }
 }
 
-TEST_CASE("be::util::ChunkedList sort performance comparison", "[be][be::util::ChunkedList][perf]")
-{
-   SECTION("con.size() == 10")
-   {
-      std::string msg;
-      const size_t n_cons = 1000;
-      const size_t con_size = 10;
-
-      auto tuple = make_unique(new std::tuple<
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               sort_test<n_cons, con_size, std::vector<int>>,
-                               sort_test<n_cons, con_size, std::deque<int>>,
-                               list_sort_test<n_cons, con_size, std::list<int>>,
-                               list_sort_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               sort_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-   SECTION("con.size() == 100")
-   {
-      std::string msg;
-      const size_t n_cons = 100;
-      const size_t con_size = 100;
-
-      auto tuple = make_unique(new std::tuple<
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               sort_test<n_cons, con_size, std::vector<int>>,
-                               sort_test<n_cons, con_size, std::deque<int>>,
-                               list_sort_test<n_cons, con_size, std::list<int>>,
-                               list_sort_test<n_cons, con_size, std::list<int, be::NodeAllocatorLarge<int>>>,
-                               sort_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
+TEST_CASE("util::ChunkedList sort performance comparison", BE_CATCH_TAGS) {
+   SECTION("con.size() == 10") {
+      BenchmarkSuite suite("sort", "con.size() == 10");
+      add_random_access_containers<SortTest, 1000, 10>(suite);
+      suite.add<ListSortTest<1000, 10, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
+   }
+
+   SECTION("con.size() == 100") {
+      BenchmarkSuite suite("sort", "con.size() == 100");
+      add_random_access_containers<SortTest, 100, 100>(suite);
+      suite.add<ListSortTest<100, 100, std::list<int>>>("std::list<int>");
+      SUCCEED(suite.run());
    }
 }
 
-TEST_CASE("be::util::ChunkedList stable_sort performance comparison", "[be][be::util::ChunkedList][perf]")
-{
-   SECTION("con.size() == 10")
-   {
-      std::string msg;
-      const size_t n_cons = 1000;
-      const size_t con_size = 10;
-
-      auto tuple = make_unique(new std::tuple<
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               stable_sort_test<n_cons, con_size, std::vector<int>>,
-                               stable_sort_test<n_cons, con_size, std::deque<int>>,
-                               stable_sort_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
-   }
-
-   SECTION("con.size() == 100")
-   {
-      std::string msg;
-      const size_t n_cons = 100;
-      const size_t con_size = 100;
-
-      auto tuple = make_unique(new std::tuple<
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 8, 3, 2>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, std::allocator<int>, 4, 4, 1>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::SharedNodeAllocator<int>>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::ThreadNodeAllocator<int>>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocatorLarge<int>>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 8, 3, 2>>,
-                               stable_sort_test<n_cons, con_size, be::util::ChunkedList<int, be::NodeAllocator<int>, 4, 4, 1>>,
-                               stable_sort_test<n_cons, con_size, std::vector<int>>,
-                               stable_sort_test<n_cons, con_size, std::deque<int>>,
-                               stable_sort_test<n_cons, con_size, boost::container::stable_vector<int>>
-      >());
-      msg = run_tests("", 40, std::move(*tuple));
-      SUCCEED(msg);
+TEST_CASE("util::ChunkedList stable_sort performance comparison", BE_CATCH_TAGS) {
+   SECTION("con.size() == 10") {
+      BenchmarkSuite suite("stable_sort", "con.size() == 10");
+      add_random_access_containers<StableSortTest, 1000, 10>(suite);
+      SUCCEED(suite.run());
+   }
+
+   SECTION("con.size() == 100") {
+      BenchmarkSuite suite("stable_sort", "con.size() == 100");
+      add_random_access_containers<StableSortTest, 100, 100>(suite);
+      SUCCEED(suite.run());
    }
 }
 
@@ -0,0 +1,455 @@
+#include "pch.hpp"
+#include "compression_codec.hpp"
+#include "zlib.hpp"
+#include "zlib_result_code.hpp"
+#include <be/core/byte_order.hpp>
+#include <be/core/exceptions.hpp>
+#include <memory>
+
+#ifdef BE_UTIL_COMPRESSION_LZ4
+#include <lz4/lz4.h>
+#endif
+
+#ifdef BE_UTIL_COMPRESSION_ZSTD
+#include <zstd/zstd.h>
+#include <zstd/zstd_errors.h>
+#endif
+
+namespace be::util {
+namespace {
+
+using L = U64;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Frames produced by the zlib codec are identical to those produced
+///         by deflate_buf() with encode_length = true.  Other codecs insert a
+///         tag byte after the length prefix.  A zlib stream's first byte
+///         always has 8 (deflate) in its low nibble, so tags must not.
+constexpr UC lz4_tag = 0x01;
+constexpr UC zstd_tag = 0x02;
+constexpr std::size_t frame_header_size = sizeof(L) + 1;
+
+///////////////////////////////////////////////////////////////////////////////
+bool is_zlib_tag(UC tag) noexcept {
+   return (tag & 0x0F) == 8;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+class ZlibCodec final : public Codec {
+public:
+   CodecType type() const noexcept override {
+      return CodecType::zlib;
+   }
+
+   I8 default_level() const noexcept override {
+      return 7;
+   }
+
+   std::size_t bound(std::size_t uncompressed_size) const noexcept override {
+      return deflate_bound(uncompressed_size, false);
+   }
+
+   std::size_t compress(const UC* data, std::size_t size, UC* output, std::size_t capacity, I8 level, std::error_code& ec) const noexcept override {
+      return deflate_into(make_buf(data, size), gsl::span<UC>(output, capacity), ec, false, level);
+   }
+
+   std::size_t decompress(const UC* compressed, std::size_t size, UC* output, std::size_t uncompressed_size, std::error_code& ec) const noexcept override {
+      std::size_t actual_size = inflate_into(make_buf(compressed, size), uncompressed_size, gsl::span<UC>(output, uncompressed_size), ec);
+      if (!ec && actual_size != uncompressed_size) {
+         ec = ZlibResultCode::data_error;
+      }
+      return actual_size;
+   }
+};
+
+#ifdef BE_UTIL_COMPRESSION_LZ4
+
+///////////////////////////////////////////////////////////////////////////////
+class Lz4Codec final : public Codec {
+public:
+   CodecType type() const noexcept override {
+      return CodecType::lz4;
+   }
+
+   I8 default_level() const noexcept override {
+      return 1;
+   }
+
+   std::size_t bound(std::size_t uncompressed_size) const noexcept override {
+      if (uncompressed_size > LZ4_MAX_INPUT_SIZE) {
+         return 0;
+      }
+      return static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(uncompressed_size)));
+   }
+
+   std::size_t compress(const UC* data, std::size_t size, UC* output, std::size_t capacity, I8 level, std::error_code& ec) const noexcept override {
+      if (size > LZ4_MAX_INPUT_SIZE) {
+         ec = ZlibResultCode::buffer_error;
+         return 0;
+      }
+
+      const int acceleration = level < 0 ? -level : 1;
+      const int dst_capacity = capacity > static_cast<std::size_t>(std::numeric_limits<int>::max()) ? std::numeric_limits<int>::max() : static_cast<int>(capacity);
+      int result = LZ4_compress_fast(reinterpret_cast<const char*>(data), reinterpret_cast<char*>(output), static_cast<int>(size), dst_capacity, acceleration);
+      if (result <= 0 && size > 0) {
+         ec = ZlibResultCode::buffer_error;
+         return 0;
+      }
+      return static_cast<std::size_t>(result);
+   }
+
+   std::size_t decompress(const UC* compressed, std::size_t size, UC* output, std::size_t uncompressed_size, std::error_code& ec) const noexcept override {
+      if (size > static_cast<std::size_t>(std::numeric_limits<int>::max()) || uncompressed_size > LZ4_MAX_INPUT_SIZE) {
+         ec = ZlibResultCode::data_error;
+         return 0;
+      }
+
+      int result = LZ4_decompress_safe(reinterpret_cast<const char*>(compressed), reinterpret_cast<char*>(output), static_cast<int>(size), static_cast<int>(uncompressed_size));
+      if (result < 0 || static_cast<std::size_t>(result) != uncompressed_size) {
+         ec = ZlibResultCode::data_error;
+         return 0;
+      }
+      return static_cast<std::size_t>(result);
+   }
+};
+
+#endif
+
+#ifdef BE_UTIL_COMPRESSION_ZSTD
+
+///////////////////////////////////////////////////////////////////////////////
+struct ZstdContextDeleter {
+   void operator()(ZSTD_CCtx* ctx) const noexcept {
+      ZSTD_freeCCtx(ctx);
+   }
+   void operator()(ZSTD_DCtx* ctx) const noexcept {
+      ZSTD_freeDCtx(ctx);
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibResultCode zstd_result_code(std::size_t result) noexcept {
+   switch (ZSTD_getErrorCode(result)) {
+      case ZSTD_error_memory_allocation: return ZlibResultCode::not_enough_memory;
+      case ZSTD_error_dstSize_tooSmall:  return ZlibResultCode::buffer_error;
+      default:                           return ZlibResultCode::data_error;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Uses one compression and one decompression context per thread, so
+///         that their working memory is only allocated once.
+class ZstdCodec final : public Codec {
+public:
+   CodecType type() const noexcept override {
+      return CodecType::zstd;
+   }
+
+   I8 default_level() const noexcept override {
+      return 3;
+   }
+
+   std::size_t bound(std::size_t uncompressed_size) const noexcept override {
+      return ZSTD_compressBound(uncompressed_size);
+   }
+
+   std::size_t compress(const UC* data, std::size_t size, UC* output, std::size_t capacity, I8 level, std::error_code& ec) const noexcept override {
+      thread_local std::unique_ptr<ZSTD_CCtx, ZstdContextDeleter> ctx;
+      if (!ctx) {
+         ctx.reset(ZSTD_createCCtx());
+         if (!ctx) {
+            ec = ZlibResultCode::not_enough_memory;
+            return 0;
+         }
+      }
+
+      std::size_t result = ZSTD_compressCCtx(ctx.get(), output, capacity, data, size, level);
+      if (ZSTD_isError(result)) {
+         ec = zstd_result_code(result);
+         return 0;
+      }
+      return result;
+   }
+
+   std::size_t decompress(const UC* compressed, std::size_t size, UC* output, std::size_t uncompressed_size, std::error_code& ec) const noexcept override {
+      thread_local std::unique_ptr<ZSTD_DCtx, ZstdContextDeleter> ctx;
+      if (!ctx) {
+         ctx.reset(ZSTD_createDCtx());
+         if (!ctx) {
+            ec = ZlibResultCode::not_enough_memory;
+            return 0;
+         }
+      }
+
+      std::size_t result = ZSTD_decompressDCtx(ctx.get(), output, uncompressed_size, compressed, size);
+      if (ZSTD_isError(result)) {
+         // a frame that decompresses to more than the recorded size is corrupt
+         ec = ZlibResultCode::data_error;
+         return 0;
+      }
+      if (result != uncompressed_size) {
+         ec = ZlibResultCode::data_error;
+      }
+      return result;
+   }
+};
+
+#endif
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Stands in for a codec which was not enabled when the library was
+///         built.  Every operation fails with std::errc::not_supported.
+class UnavailableCodec final : public Codec {
+public:
+   explicit UnavailableCodec(CodecType type) noexcept
+      : type_(type)
+   { }
+
+   CodecType type() const noexcept override {
+      return type_;
+   }
+
+   I8 default_level() const noexcept override {
+      return 0;
+   }
+
+   std::size_t bound(std::size_t) const noexcept override {
+      return 0;
+   }
+
+   std::size_t compress(const UC*, std::size_t, UC*, std::size_t, I8, std::error_code& ec) const noexcept override {
+      ec = std::make_error_code(std::errc::not_supported);
+      return 0;
+   }
+
+   std::size_t decompress(const UC*, std::size_t, UC*, std::size_t, std::error_code& ec) const noexcept override {
+      ec = std::make_error_code(std::errc::not_supported);
+      return 0;
+   }
+
+private:
+   CodecType type_;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t frame_header_length(CodecType type) noexcept {
+   return type == CodecType::zlib ? sizeof(L) : frame_header_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool read_frame_header(const Buf<const UC>& frame, CodecType& type, std::size_t& uncompressed_size) noexcept {
+   if (frame.size() < frame_header_size) {
+      return false;
+   }
+
+   L size;
+   memcpy(&size, frame.get(), sizeof(L));
+   uncompressed_size = static_cast<std::size_t>(bo::to_host(size));
+
+   const UC tag = frame.get()[sizeof(L)];
+   if (is_zlib_tag(tag)) {
+      type = CodecType::zlib;
+   } else if (tag == lz4_tag) {
+      type = CodecType::lz4;
+   } else if (tag == zstd_tag) {
+      type = CodecType::zstd;
+   } else {
+      return false;
+   }
+   return true;
+}
+
+} // be::util::()
+
+///////////////////////////////////////////////////////////////////////////////
+const char* codec_type_name(CodecType type) noexcept {
+   switch (type) {
+      case CodecType::zlib: return "zlib";
+      case CodecType::lz4:  return "lz4";
+      case CodecType::zstd: return "zstd";
+      default:              return "?";
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines whether a codec was enabled when the library was
+///         built.
+///
+/// \details zlib is always available.  The LZ4 and zstd codecs are only
+///         built if BE_UTIL_COMPRESSION_LZ4 or BE_UTIL_COMPRESSION_ZSTD
+///         (respectively) is defined, since they require the lz4 and zstd
+///         libraries.
+bool codec_available(CodecType type) noexcept {
+   switch (type) {
+      case CodecType::zlib: return true;
+#ifdef BE_UTIL_COMPRESSION_LZ4
+      case CodecType::lz4:  return true;
+#endif
+#ifdef BE_UTIL_COMPRESSION_ZSTD
+      case CodecType::zstd: return true;
+#endif
+      default:              return false;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the shared instance of a built-in codec.
+///
+/// \details If the codec is not available, returns a codec whose operations
+///         all fail with std::errc::not_supported.
+const Codec& codec(CodecType type) noexcept {
+   static const ZlibCodec zlib_codec;
+#ifdef BE_UTIL_COMPRESSION_LZ4
+   static const Lz4Codec lz4_codec;
+#else
+   static const UnavailableCodec lz4_codec(CodecType::lz4);
+#endif
+#ifdef BE_UTIL_COMPRESSION_ZSTD
+   static const ZstdCodec zstd_codec;
+#else
+   static const UnavailableCodec zstd_codec(CodecType::zstd);
+#endif
+
+   switch (type) {
+      case CodecType::lz4:  return lz4_codec;
+      case CodecType::zstd: return zstd_codec;
+      default:              return zlib_codec;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the largest frame compress_buf() can produce for an input
+///         of the given size, or 0 if the codec can't compress that much data
+///         at once.
+std::size_t compress_bound(std::size_t uncompressed_size, CodecType type) noexcept {
+   std::size_t payload_bound = codec(type).bound(uncompressed_size);
+   if (payload_bound == 0) {
+      return 0;
+   }
+   return payload_bound + frame_header_length(type);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data with the selected codec into a self-describing
+///         frame which can be decompressed with decompress_buf().
+///
+/// \details The frame begins with the uncompressed size as a big-endian U64.
+///         zlib frames continue directly with the zlib stream, so they are
+///         identical to deflate_buf() output and can also be read by
+///         inflate_buf().  Frames from other codecs have a one-byte codec tag
+///         before the compressed payload.
+///
+/// \note   The returned buffer may be allocated for a larger size than its
+///         size() accessor reports.
+Buf<UC> compress_buf(const Buf<const UC>& data, CodecType type, I8 level) {
+   Buf<UC> buf;
+   std::error_code ec;
+   buf = compress_buf(data, ec, type, level);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data with the selected codec into a self-describing
+///         frame which can be decompressed with decompress_buf().
+///
+/// \note   The returned buffer may be allocated for a larger size than its
+///         size() accessor reports.
+Buf<UC> compress_buf(const Buf<const UC>& data, std::error_code& ec, CodecType type, I8 level) noexcept {
+   if (!codec_available(type)) {
+      ec = std::make_error_code(std::errc::not_supported);
+      return Buf<UC>();
+   }
+
+   const Codec& c = codec(type);
+   if (level == default_codec_level) {
+      level = c.default_level();
+   }
+
+   const std::size_t bound = compress_bound(data.size(), type);
+   if (bound == 0) {
+      ec = ZlibResultCode::buffer_error;
+      return Buf<UC>();
+   }
+
+   Buf<UC> buf;
+   try {
+      buf = make_buf<UC>(bound);
+   } catch (const std::bad_alloc&) {
+      ec = ZlibResultCode::not_enough_memory;
+      return buf;
+   }
+
+   L size = bo::to_net(static_cast<L>(data.size()));
+   memcpy(buf.get(), &size, sizeof(L));
+
+   const std::size_t header_size = frame_header_length(type);
+   if (type == CodecType::lz4) {
+      buf.get()[sizeof(L)] = lz4_tag;
+   } else if (type == CodecType::zstd) {
+      buf.get()[sizeof(L)] = zstd_tag;
+   }
+
+   std::size_t payload_size = c.compress(data.get(), data.size(), buf.get() + header_size, buf.size() - header_size, level, ec);
+   if (ec) {
+      return Buf<UC>();
+   }
+
+   detail::trim_buf(buf, header_size + payload_size);
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses a frame produced by compress_buf() or by
+///         deflate_buf() with encode_length = true.
+Buf<UC> decompress_buf(const Buf<const UC>& frame) {
+   Buf<UC> buf;
+   std::error_code ec;
+   buf = decompress_buf(frame, ec);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses a frame produced by compress_buf() or by
+///         deflate_buf() with encode_length = true.
+Buf<UC> decompress_buf(const Buf<const UC>& frame, std::error_code& ec) noexcept {
+   CodecType type;
+   std::size_t uncompressed_size;
+   if (!read_frame_header(frame, type, uncompressed_size)) {
+      ec = ZlibResultCode::data_error;
+      return Buf<UC>();
+   }
+
+   Buf<UC> buf;
+   try {
+      buf = make_buf<UC>(uncompressed_size);
+   } catch (const std::bad_alloc&) {
+      ec = ZlibResultCode::not_enough_memory;
+      return buf;
+   }
+
+   Buf<const UC> payload = sub_buf(frame, frame_header_length(type));
+   codec(type).decompress(payload.get(), payload.size(), buf.get(), buf.size(), ec);
+   if (ec) {
+      return Buf<UC>();
+   }
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines which codec was used to compress a frame.
+CodecType frame_codec_type(const Buf<const UC>& frame) {
+   CodecType type;
+   std::size_t uncompressed_size;
+   if (!read_frame_header(frame, type, uncompressed_size)) {
+      throw RecoverableError(make_error_code(ZlibResultCode::data_error));
+   }
+   return type;
+}
+
+} // be::util
@@ -1,9 +1,13 @@
 #include "pch.hpp"
 #include "zlib.hpp"
+#include "zlib_allocator.hpp"
 #include "zlib_result_code.hpp"
 #include <be/core/byte_order.hpp>
 #include <be/core/exceptions.hpp>
 #include <zlib/zlib.h>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 namespace be::util {
 namespace {
@@ -13,60 +17,81 @@ namespace {
 using L = U64;
 
 ///////////////////////////////////////////////////////////////////////////////
-std::size_t deflate_bound(std::size_t uncompressed_size, bool encode_length) {
-   return uncompressed_size + (uncompressed_size >> 12) + (uncompressed_size >> 14) + (uncompressed_size >> 25) + 13 +
-      (encode_length ? sizeof(L) : 0);
+constexpr ::uInt max_bytes = static_cast<::uInt>(-1);
+
+///////////////////////////////////////////////////////////////////////////////
+void init_stream(::z_stream& stream) noexcept {
+   stream.zalloc = detail::zlib_alloc;
+   stream.zfree = detail::zlib_free;
+   stream.opaque = (::voidpf)0;
+   stream.next_in = nullptr;
+   stream.avail_in = 0;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void* zlib_alloc(void*, uInt items, uInt size) {
-   return std::malloc(std::size_t(items) * std::size_t(size));
+/// \brief  Primes a freshly initialized or reset stream with a preset
+///         dictionary.  Does nothing if the dictionary is empty.
+bool set_deflate_dictionary(::z_stream& stream, const Buf<const UC>& dictionary, std::error_code& ec) noexcept {
+   if (dictionary.size() == 0) {
+      return true;
+   }
+
+   if (dictionary.size() > max_bytes) {
+      ec = ZlibResultCode::buffer_error;
+      return false;
+   }
+
+   int result = ::deflateSetDictionary(&stream, (const ::Bytef*)dictionary.get(), static_cast<::uInt>(dictionary.size()));
+   if (result != Z_OK) {
+      ec = zlib_result_code(result);
+      return false;
+   }
+   return true;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void zlib_free(void*, void* ptr) {
-   std::free(ptr);
+/// \brief  Supplies the preset dictionary requested by an inflate stream.
+///
+/// \returns Z_OK if the dictionary was accepted, or Z_NEED_DICT if there is
+///         no dictionary or it isn't the one the stream was compressed with.
+int set_inflate_dictionary(::z_stream& stream, const Buf<const UC>& dictionary) noexcept {
+   if (dictionary.size() == 0 || dictionary.size() > max_bytes) {
+      return Z_NEED_DICT;
+   }
+
+   int result = ::inflateSetDictionary(&stream, (const ::Bytef*)dictionary.get(), static_cast<::uInt>(dictionary.size()));
+   return result == Z_OK ? Z_OK : Z_NEED_DICT;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-Buf<UC> deflate(const UC* uncompressed, std::size_t uncompressed_size, bool encode_length, I8 level, std::error_code& ec) noexcept {
-   Buf<UC> buffer;
-   try {
-      buffer = make_buf<UC>(deflate_bound(uncompressed_size, encode_length));
-   } catch (const std::bad_alloc&) {
-      ec = ZlibResultCode::not_enough_memory;
-      return buffer;
+/// \brief  Compresses data into the provided memory using a freshly
+///         initialized or reset stream.
+///
+/// \returns The number of bytes written, including the length prefix if
+///         requested.
+std::size_t deflate(::z_stream& stream, const UC* uncompressed, std::size_t uncompressed_size, UC* compressed, std::size_t compressed_capacity, bool encode_length, std::error_code& ec) noexcept {
+   if (encode_length && compressed_capacity < sizeof(L)) {
+      ec = ZlibResultCode::buffer_error;
+      return 0;
    }
 
    const UC* in = uncompressed;
    std::size_t in_remaining = uncompressed_size;
 
-   UC* out = buffer.get();
-   std::size_t out_remaining = buffer.size();
+   UC* out = compressed;
+   std::size_t out_remaining = compressed_capacity;
 
    if (encode_length) {
       out += sizeof(L);
       out_remaining -= sizeof(L);
    }
 
-   ::z_stream stream;
-   stream.zalloc = zlib_alloc;
-   stream.zfree = zlib_free;
-   stream.opaque = (::voidpf)0;
-
-   int result = deflateInit(&stream, level);
-   if (result != Z_OK) {
-      ec = zlib_result_code(result);
-      buffer = Buf<UC>();
-      return buffer;
-   }
-
    stream.next_out = (::Bytef*)out;
    stream.avail_out = 0;
    stream.next_in = (const ::Bytef*)in;
    stream.avail_in = 0;
 
-   constexpr ::uInt max_bytes = static_cast<::uInt>(-1);
+   int result;
    std::size_t compressed_size = 0;
 
    do {
@@ -84,7 +109,6 @@ Buf<UC> deflate(const UC* uncompressed, std::size_t uncompressed_size, bool enco
 
    } while (result == Z_OK);
 
-   ::deflateEnd(&stream);
    if (result != Z_STREAM_END) {
       ec = zlib_result_code(result);
    }
@@ -92,23 +116,247 @@ Buf<UC> deflate(const UC* uncompressed, std::size_t uncompressed_size, bool enco
    if (encode_length) {
       compressed_size += sizeof(L);
       L size = bo::to_net(static_cast<L>(uncompressed_size));
-      memcpy(buffer.get(), &size, sizeof(L));
+      memcpy(compressed, &size, sizeof(L));
+   }
+
+   return compressed_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data into a new buffer using a freshly initialized or
+///         reset stream.
+Buf<UC> deflate(::z_stream& stream, const UC* uncompressed, std::size_t uncompressed_size, bool encode_length, std::error_code& ec) noexcept {
+   Buf<UC> buffer;
+   try {
+      buffer = make_buf<UC>(deflate_bound(uncompressed_size, encode_length));
+   } catch (const std::bad_alloc&) {
+      ec = ZlibResultCode::not_enough_memory;
+      return buffer;
    }
 
-   if (buffer.size() > compressed_size + 100 && buffer.size() > (compressed_size / 8) * 9) {
+   std::size_t compressed_size = deflate(stream, uncompressed, uncompressed_size, buffer.get(), buffer.size(), encode_length, ec);
+   detail::trim_buf(buffer, compressed_size);
+   return buffer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t deflate(const UC* uncompressed, std::size_t uncompressed_size, UC* compressed, std::size_t compressed_capacity, bool encode_length, I8 level, std::error_code& ec) noexcept {
+   ::z_stream stream;
+   init_stream(stream);
+
+   int result = deflateInit(&stream, level);
+   if (result != Z_OK) {
+      ec = zlib_result_code(result);
+      return 0;
+   }
+
+   std::size_t compressed_size = deflate(stream, uncompressed, uncompressed_size, compressed, compressed_capacity, encode_length, ec);
+   ::deflateEnd(&stream);
+   return compressed_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Buf<UC> deflate(const UC* uncompressed, std::size_t uncompressed_size, bool encode_length, I8 level, const Buf<const UC>& dictionary, std::error_code& ec) noexcept {
+   ::z_stream stream;
+   init_stream(stream);
+
+   int result = deflateInit(&stream, level);
+   if (result != Z_OK) {
+      ec = zlib_result_code(result);
+      return Buf<UC>();
+   }
+
+   Buf<UC> buffer;
+   if (set_deflate_dictionary(stream, dictionary, ec)) {
+      buffer = deflate(stream, uncompressed, uncompressed_size, encode_length, ec);
+   }
+   ::deflateEnd(&stream);
+   return buffer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Buf<UC> deflate(const UC* uncompressed, std::size_t uncompressed_size, bool encode_length, I8 level, std::error_code& ec) noexcept {
+   return deflate(uncompressed, uncompressed_size, encode_length, level, Buf<const UC>(), ec);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Makes sure buf has room for at least size bytes, replacing it with
+///         a new buffer only if it is too small.
+bool ensure_capacity(Buf<UC>& buf, std::size_t size, std::error_code& ec) noexcept {
+   if (buf.size() < size) {
       try {
-         buffer = copy_buf(sub_buf(buffer, 0, compressed_size));
+         buf = make_buf<UC>(size);
       } catch (const std::bad_alloc&) {
-         if (buffer.size() != compressed_size) {
-            buffer.release();
-            buffer = Buf<UC>(buffer.get(), compressed_size, detail::delete_array);
+         ec = ZlibResultCode::not_enough_memory;
+         return false;
+      }
+   }
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// Amount of input compressed by each task in deflate_parallel().  Each block
+/// costs about 5 bytes of extra output for the flush marker that ends it.
+constexpr std::size_t parallel_block_size = 128 * 1024;
+
+///////////////////////////////////////////////////////////////////////////////
+/// Amount of the preceding input used to prime the dictionary of each block,
+/// so that matches can still reach back across block boundaries.
+constexpr std::size_t parallel_dictionary_size = 32 * 1024;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the 2-byte stream header deflateInit() writes for the
+///         given compression level.
+U16 zlib_header(I8 level) noexcept {
+   if (level == Z_DEFAULT_COMPRESSION) {
+      level = 6;
+   }
+
+   const U16 level_flags = level < 2 ? 0 : level < 6 ? 1 : level == 6 ? 2 : 3;
+   U16 header = U16((Z_DEFLATED + ((MAX_WBITS - 8) << 4)) << 8 | level_flags << 6);
+   header += 31 - (header % 31);
+   return header;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+struct ParallelBlock {
+   std::size_t compressed_size = 0;
+   ::uLong adler = 0;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data by splitting it into blocks and deflating them
+///         concurrently, producing the same format as deflate().
+///
+/// \details Each block is compressed as a raw deflate stream whose dictionary
+///         is primed with the end of the previous block and which ends with
+///         a sync flush (or Z_FINISH, for the last block), so the blocks can
+///         be concatenated between a normal zlib header and a combined
+///         Adler-32 trailer to form a single valid zlib stream.
+///
+///         Falls back to deflate() if only one thread would be used, or if
+///         any block doesn't fit in the space reserved for it.
+Buf<UC> deflate_parallel(const UC* uncompressed, std::size_t uncompressed_size, bool encode_length, I8 level, std::size_t threads, std::error_code& ec) noexcept {
+   const std::size_t block_count = (uncompressed_size + parallel_block_size - 1) / parallel_block_size;
+   if (threads == 0) {
+      threads = std::thread::hardware_concurrency();
+   }
+   threads = std::min(threads, block_count);
+   if (threads <= 1) {
+      return deflate(uncompressed, uncompressed_size, encode_length, level, ec);
+   }
+
+   const std::size_t slot_size = deflate_bound(parallel_block_size, false) + 16;
+   const std::size_t header_size = (encode_length ? sizeof(L) : 0) + sizeof(U16);
+
+   Buf<UC> buffer;
+   std::vector<ParallelBlock> blocks;
+   try {
+      buffer = make_buf<UC>(header_size + block_count * slot_size + sizeof(U32));
+      blocks.resize(block_count);
+   } catch (const std::bad_alloc&) {
+      ec = ZlibResultCode::not_enough_memory;
+      return Buf<UC>();
+   }
+
+   UC* const slots = buffer.get() + header_size;
+   std::atomic<std::size_t> next_block(0);
+   std::atomic<int> error(Z_OK);
+
+   auto worker = [&]() noexcept {
+      ::z_stream stream;
+      init_stream(stream);
+
+      int result = deflateInit2(&stream, level, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY);
+      if (result != Z_OK) {
+         int expected = Z_OK;
+         error.compare_exchange_strong(expected, result);
+         return;
+      }
+
+      for (std::size_t i = next_block++; i < block_count && error.load(std::memory_order_relaxed) == Z_OK; i = next_block++) {
+         const std::size_t begin = i * parallel_block_size;
+         const std::size_t size = std::min(parallel_block_size, uncompressed_size - begin);
+         const bool last = i + 1 == block_count;
+
+         result = ::deflateReset(&stream);
+         if (result == Z_OK && begin > 0) {
+            const std::size_t dictionary_size = std::min(parallel_dictionary_size, begin);
+            result = ::deflateSetDictionary(&stream, (const ::Bytef*)(uncompressed + begin - dictionary_size), static_cast<::uInt>(dictionary_size));
+         }
+
+         if (result == Z_OK) {
+            stream.next_in = (const ::Bytef*)(uncompressed + begin);
+            stream.avail_in = static_cast<::uInt>(size);
+            stream.next_out = (::Bytef*)(slots + i * slot_size);
+            stream.avail_out = static_cast<::uInt>(slot_size);
+            result = ::deflate(&stream, last ? Z_FINISH : Z_SYNC_FLUSH);
+
+            if (last ? result == Z_STREAM_END : result == Z_OK && stream.avail_in == 0 && stream.avail_out > 0) {
+               result = Z_OK;
+            } else if (result == Z_OK || result == Z_STREAM_END) {
+               result = Z_BUF_ERROR;
+            }
+         }
+
+         if (result != Z_OK) {
+            int expected = Z_OK;
+            error.compare_exchange_strong(expected, result);
+            break;
          }
+
+         blocks[i].compressed_size = slot_size - stream.avail_out;
+         blocks[i].adler = ::adler32(::adler32(0, nullptr, 0), (const ::Bytef*)(uncompressed + begin), static_cast<::uInt>(size));
       }
-   } else if (buffer.size() != compressed_size) {
-      buffer.release();
-      buffer = Buf<UC>(buffer.get(), compressed_size, detail::delete_array);
+
+      ::deflateEnd(&stream);
+   };
+
+   std::vector<std::thread> pool;
+   try {
+      pool.reserve(threads - 1);
+      while (pool.size() < threads - 1) {
+         pool.emplace_back(worker);
+      }
+   } catch (const std::exception&) {
+      // continue with however many threads could be started
+   }
+
+   worker();
+   for (auto& t : pool) {
+      t.join();
    }
 
+   if (error == Z_BUF_ERROR) {
+      return deflate(uncompressed, uncompressed_size, encode_length, level, ec);
+   } else if (error != Z_OK) {
+      ec = zlib_result_code(error);
+      return Buf<UC>();
+   }
+
+   UC* out = buffer.get();
+   if (encode_length) {
+      L size = bo::to_net(static_cast<L>(uncompressed_size));
+      memcpy(out, &size, sizeof(L));
+   }
+
+   const U16 header = bo::to_net(zlib_header(level));
+   memcpy(out + header_size - sizeof(U16), &header, sizeof(U16));
+
+   std::size_t compressed_size = header_size;
+   ::uLong adler = ::adler32(0, nullptr, 0);
+   for (std::size_t i = 0; i < block_count; ++i) {
+      const std::size_t size = std::min(parallel_block_size, uncompressed_size - i * parallel_block_size);
+      memmove(out + compressed_size, slots + i * slot_size, blocks[i].compressed_size);
+      compressed_size += blocks[i].compressed_size;
+      adler = ::adler32_combine(adler, blocks[i].adler, static_cast<::z_off_t>(size));
+   }
+
+   const U32 trailer = bo::to_net(static_cast<U32>(adler));
+   memcpy(out + compressed_size, &trailer, sizeof(U32));
+   compressed_size += sizeof(U32);
+
+   detail::trim_buf(buffer, compressed_size);
    return buffer;
 }
 
@@ -127,7 +375,8 @@ std::size_t get_uncompressed_length(const UC* compressed, std::size_t compressed
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-std::size_t inflate(const UC* compressed, std::size_t compressed_size, UC* uncompressed, std::size_t uncompressed_size, std::error_code& ec) noexcept {
+/// \brief  Decompresses data using a freshly initialized or reset stream.
+std::size_t inflate(::z_stream& stream, const UC* compressed, std::size_t compressed_size, UC* uncompressed, std::size_t uncompressed_size, const Buf<const UC>& dictionary, std::error_code& ec) noexcept {
    UC tmp[1];    /* for detection of incomplete stream when uncompressed_size == 0 */
 
    const UC* in = compressed;
@@ -141,23 +390,12 @@ std::size_t inflate(const UC* compressed, std::size_t compressed_size, UC* uncom
       out_remaining = sizeof(tmp);
    }
 
-   z_stream stream;
-   stream.zalloc = zlib_alloc;
-   stream.zfree = zlib_free;
-   stream.opaque = (voidpf)0;
    stream.next_in = (const Bytef*)in;
    stream.avail_in = 0;
-
-   int result = inflateInit(&stream);
-   if (result != Z_OK) {
-      ec = zlib_result_code(result);
-      return 0;
-   }
-
    stream.next_out = (Bytef*)out;
    stream.avail_out = 0;
 
-   constexpr ::uInt max_bytes = static_cast<::uInt>(-1);
+   int result;
    std::size_t actual_uncompressed_size = 0;
 
    do {
@@ -172,6 +410,9 @@ std::size_t inflate(const UC* compressed, std::size_t compressed_size, UC* uncom
       stream.total_out = 0;
       result = ::inflate(&stream, Z_NO_FLUSH);
       actual_uncompressed_size += stream.total_out;
+      if (result == Z_NEED_DICT) {
+         result = set_inflate_dictionary(stream, dictionary);
+      }
    } while (result == Z_OK);
 
    if (uncompressed_size == 0) {
@@ -181,8 +422,7 @@ std::size_t inflate(const UC* compressed, std::size_t compressed_size, UC* uncom
       actual_uncompressed_size = 0;
    }
 
-   ::inflateEnd(&stream);
-   if (result == Z_NEED_DICT || result == Z_BUF_ERROR && (out_remaining + stream.avail_out > 0)) {
+   if (result == Z_BUF_ERROR && (out_remaining + stream.avail_out > 0)) {
       ec = ZlibResultCode::data_error;
    } else if (result != Z_STREAM_END) {
       ec = zlib_result_code(result);
@@ -191,8 +431,72 @@ std::size_t inflate(const UC* compressed, std::size_t compressed_size, UC* uncom
    return actual_uncompressed_size;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+std::size_t inflate(const UC* compressed, std::size_t compressed_size, UC* uncompressed, std::size_t uncompressed_size, const Buf<const UC>& dictionary, std::error_code& ec) noexcept {
+   ::z_stream stream;
+   init_stream(stream);
+
+   int result = inflateInit(&stream);
+   if (result != Z_OK) {
+      ec = zlib_result_code(result);
+      return 0;
+   }
+
+   std::size_t actual_uncompressed_size = inflate(stream, compressed, compressed_size, uncompressed, uncompressed_size, dictionary, ec);
+   ::inflateEnd(&stream);
+   return actual_uncompressed_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t inflate(const UC* compressed, std::size_t compressed_size, UC* uncompressed, std::size_t uncompressed_size, std::error_code& ec) noexcept {
+   return inflate(compressed, compressed_size, uncompressed, uncompressed_size, Buf<const UC>(), ec);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Moves up to max_bytes of pending input into the stream once the
+///         stream has consumed what it had.
+void refill_input(::z_stream& stream, const UC*& input, std::size_t& input_remaining) noexcept {
+   if (stream.avail_in == 0 && input_remaining > 0) {
+      stream.next_in = (const ::Bytef*)input;
+      stream.avail_in = input_remaining > max_bytes ? max_bytes : static_cast<::uInt>(input_remaining);
+      input += stream.avail_in;
+      input_remaining -= stream.avail_in;
+   }
+}
+
 } // be::()
 
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Shrinks a buffer to the number of bytes actually used, copying it
+///         to a new allocation if a significant amount would be wasted.
+void trim_buf(Buf<UC>& buf, std::size_t size) noexcept {
+   if (buf.size() == size) {
+      return;
+   }
+
+   if (buf.size() > size + 100 && buf.size() > (size / 8) * 9) {
+      try {
+         buf = copy_buf(sub_buf(buf, 0, size));
+         return;
+      } catch (const std::bad_alloc&) { }
+   }
+
+   buf.release();
+   buf = Buf<UC>(buf.get(), size, be::detail::delete_array);
+}
+
+} // be::util::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the largest number of bytes deflate_buf() or
+///         deflate_into() can produce for an input of the given size.
+std::size_t deflate_bound(std::size_t uncompressed_size, bool encode_length) noexcept {
+   return uncompressed_size + (uncompressed_size >> 12) + (uncompressed_size >> 14) + (uncompressed_size >> 25) + 13 +
+      (encode_length ? sizeof(L) : 0);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 /// \note   The returned buffer may be allocated for a larger size than its
 ///         size() accessor reports.
@@ -235,6 +539,124 @@ Buf<UC> deflate_buf(const Buf<const UC>& data, std::error_code& ec, bool encode_
    return deflate(data.get(), data.size(), encode_length, level, ec);
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data using a preset dictionary.
+///
+/// \details The stream header records the dictionary's Adler-32 (see
+///         zlib_dictionary_id()), and the same dictionary must be provided to
+///         decompress it.  An empty dictionary is the same as none.
+///
+/// \note   The returned buffer may be allocated for a larger size than its
+///         size() accessor reports.
+Buf<UC> deflate_buf(const Buf<const UC>& data, const Buf<const UC>& dictionary, bool encode_length, I8 level) {
+   Buf<UC> buf;
+   std::error_code ec;
+   buf = deflate(data.get(), data.size(), encode_length, level, dictionary, ec);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data using a preset dictionary.
+///
+/// \note   The returned buffer may be allocated for a larger size than its
+///         size() accessor reports.
+Buf<UC> deflate_buf(const Buf<const UC>& data, const Buf<const UC>& dictionary, std::error_code& ec, bool encode_length, I8 level) noexcept {
+   return deflate(data.get(), data.size(), encode_length, level, dictionary, ec);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data into caller-provided memory, in the same format as
+///         deflate_buf().
+///
+/// \details Fails with ZlibResultCode::buffer_error if output is too small.
+///         An output of deflate_bound(data.size(), encode_length) bytes is
+///         always large enough.
+///
+/// \returns The number of bytes written to output.
+std::size_t deflate_into(const Buf<const UC>& data, gsl::span<UC> output, bool encode_length, I8 level) {
+   std::error_code ec;
+   std::size_t size = deflate_into(data, output, ec, encode_length, level);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data into caller-provided memory, in the same format as
+///         deflate_buf().
+///
+/// \returns The number of bytes written to output.
+std::size_t deflate_into(const Buf<const UC>& data, gsl::span<UC> output, std::error_code& ec, bool encode_length, I8 level) noexcept {
+   return deflate(data.get(), data.size(), output.data(), static_cast<std::size_t>(output.size()), encode_length, level, ec);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data into a reusable buffer, in the same format as
+///         deflate_buf().
+///
+/// \details If output is smaller than deflate_bound(data.size(),
+///         encode_length), it is replaced with a buffer of that size.
+///         Otherwise it is reused as-is; it is never shrunk or reallocated to
+///         fit the compressed data.
+///
+/// \returns The number of bytes written to output.
+std::size_t deflate_into(const Buf<const UC>& data, Buf<UC>& output, bool encode_length, I8 level) {
+   std::error_code ec;
+   std::size_t size = deflate_into(data, output, ec, encode_length, level);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data into a reusable buffer, in the same format as
+///         deflate_buf().
+///
+/// \returns The number of bytes written to output.
+std::size_t deflate_into(const Buf<const UC>& data, Buf<UC>& output, std::error_code& ec, bool encode_length, I8 level) noexcept {
+   if (!ensure_capacity(output, deflate_bound(data.size(), encode_length), ec)) {
+      return 0;
+   }
+   return deflate(data.get(), data.size(), output.get(), output.size(), encode_length, level, ec);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data using multiple threads.
+///
+/// \details The input is split into 128 KiB blocks which are compressed
+///         concurrently and joined into a single zlib stream, so the result
+///         can be decompressed by inflate_buf() like any other.  Compression
+///         is very slightly worse than deflate_buf().  Inputs no larger than
+///         one block are compressed on the calling thread.
+///
+/// \param  threads The maximum number of threads to use, including the
+///         calling thread.  If 0, std::thread::hardware_concurrency() is
+///         used.
+///
+/// \note   The returned buffer may be allocated for a larger size than its
+///         size() accessor reports.
+Buf<UC> deflate_buf_parallel(const Buf<const UC>& data, std::size_t threads, bool encode_length, I8 level) {
+   Buf<UC> buf;
+   std::error_code ec;
+   buf = deflate_parallel(data.get(), data.size(), encode_length, level, threads, ec);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \note   The returned buffer may be allocated for a larger size than its
+///         size() accessor reports.
+Buf<UC> deflate_buf_parallel(const Buf<const UC>& data, std::error_code& ec, std::size_t threads, bool encode_length, I8 level) noexcept {
+   return deflate_parallel(data.get(), data.size(), encode_length, level, threads, ec);
+}
+
 ///////////////////////////////////////////////////////////////////////////////
 S inflate_string(const Buf<const UC>& compressed) {
    S str;
@@ -317,22 +739,506 @@ Buf<UC> inflate_buf(const Buf<const UC>& compressed, std::size_t uncompressed_le
    }
 
    uncompressed_length = inflate(compressed.get(), compressed.size(), uncompressed.get(), uncompressed.size(), ec);
+   detail::trim_buf(uncompressed, uncompressed_length);
+   return uncompressed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses data produced by deflate_buf() with
+///         encode_length = true, supplying dictionary if the stream was
+///         compressed with a preset dictionary.
+///
+/// \details Fails with ZlibResultCode::need_dictionary if the stream
+///         requires a dictionary other than the one provided.
+Buf<UC> inflate_buf(const Buf<const UC>& compressed, const Buf<const UC>& dictionary) {
+   Buf<UC> buf;
+   std::error_code ec;
+   buf = inflate_buf(compressed, dictionary, ec);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses data produced by deflate_buf() with
+///         encode_length = true, supplying dictionary if the stream was
+///         compressed with a preset dictionary.
+Buf<UC> inflate_buf(const Buf<const UC>& compressed, const Buf<const UC>& dictionary, std::error_code& ec) noexcept {
+   std::size_t uncompressed_length = get_uncompressed_length(compressed.get(), compressed.size());
+   Buf<UC> uncompressed;
+   try {
+      uncompressed = make_buf<UC>(uncompressed_length);
+   } catch (const std::bad_alloc&) {
+      ec = ZlibResultCode::not_enough_memory;
+      return uncompressed;
+   }
+
+   Buf<const UC> data = sub_buf(compressed, sizeof(L));
+   uncompressed_length = inflate(data.get(), data.size(), uncompressed.get(), uncompressed.size(), dictionary, ec);
+   detail::trim_buf(uncompressed, uncompressed_length);
+   return uncompressed;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses data produced by deflate_buf() with
+///         encode_length = true into caller-provided memory.
+///
+/// \details Fails with ZlibResultCode::buffer_error if output is smaller
+///         than the uncompressed length recorded in the compressed data.
+///
+/// \returns The number of bytes written to output.
+std::size_t inflate_into(const Buf<const UC>& compressed, gsl::span<UC> output) {
+   std::error_code ec;
+   std::size_t size = inflate_into(compressed, output, ec);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return size;
+}
 
-   if (uncompressed.size() != uncompressed_length) {
-      if (uncompressed.size() > uncompressed_length + 100 && uncompressed.size() > (uncompressed_length / 8) * 9) {
-         try {
-            uncompressed = copy_buf(sub_buf(uncompressed, 0, uncompressed_length));
-         } catch (const std::bad_alloc&) {
-            uncompressed.release();
-            uncompressed = Buf<UC>(uncompressed.get(), uncompressed_length, detail::delete_array);
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses data produced by deflate_buf() with
+///         encode_length = true into caller-provided memory.
+///
+/// \returns The number of bytes written to output.
+std::size_t inflate_into(const Buf<const UC>& compressed, gsl::span<UC> output, std::error_code& ec) noexcept {
+   const std::size_t uncompressed_length = get_uncompressed_length(compressed.get(), compressed.size());
+   if (uncompressed_length > static_cast<std::size_t>(output.size())) {
+      ec = ZlibResultCode::buffer_error;
+      return 0;
+   }
+
+   Buf<const UC> data = sub_buf(compressed, sizeof(L));
+   return inflate(data.get(), data.size(), output.data(), uncompressed_length, ec);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses data produced by deflate_buf() with
+///         encode_length = true into a reusable buffer.
+///
+/// \details If output is smaller than the uncompressed data, it is replaced
+///         with a buffer of exactly the right size.  Otherwise it is reused
+///         as-is and its size() is not changed.
+///
+/// \returns The number of bytes written to output.
+std::size_t inflate_into(const Buf<const UC>& compressed, Buf<UC>& output) {
+   std::error_code ec;
+   std::size_t size = inflate_into(compressed, output, ec);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses data produced by deflate_buf() with
+///         encode_length = true into a reusable buffer.
+///
+/// \returns The number of bytes written to output.
+std::size_t inflate_into(const Buf<const UC>& compressed, Buf<UC>& output, std::error_code& ec) noexcept {
+   const std::size_t uncompressed_length = get_uncompressed_length(compressed.get(), compressed.size());
+   if (!ensure_capacity(output, uncompressed_length, ec)) {
+      return 0;
+   }
+
+   Buf<const UC> data = sub_buf(compressed, sizeof(L));
+   return inflate(data.get(), data.size(), output.get(), uncompressed_length, ec);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses data produced by deflate_buf() with
+///         encode_length = false into caller-provided memory.
+///
+/// \returns The number of bytes written to output.
+std::size_t inflate_into(const Buf<const UC>& compressed, std::size_t uncompressed_length, gsl::span<UC> output) {
+   std::error_code ec;
+   std::size_t size = inflate_into(compressed, uncompressed_length, output, ec);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses data produced by deflate_buf() with
+///         encode_length = false into caller-provided memory.
+///
+/// \returns The number of bytes written to output.
+std::size_t inflate_into(const Buf<const UC>& compressed, std::size_t uncompressed_length, gsl::span<UC> output, std::error_code& ec) noexcept {
+   if (uncompressed_length > static_cast<std::size_t>(output.size())) {
+      ec = ZlibResultCode::buffer_error;
+      return 0;
+   }
+   return inflate(compressed.get(), compressed.size(), output.data(), uncompressed_length, ec);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibDeflater::ZlibDeflater(I8 level)
+   : stream_(std::make_unique<::z_stream>()),
+     level_(level)
+{
+   init_stream(*stream_);
+   int result = deflateInit(stream_.get(), level);
+   if (result != Z_OK) {
+      throw RecoverableError(make_error_code(zlib_result_code(result)));
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibDeflater::ZlibDeflater(ZlibDeflater&& other) noexcept
+   : stream_(std::move(other.stream_)),
+     input_(other.input_),
+     input_remaining_(other.input_remaining_),
+     level_(other.level_),
+     finishing_(other.finishing_),
+     done_(other.done_),
+     dictionary_(std::move(other.dictionary_))
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibDeflater& ZlibDeflater::operator=(ZlibDeflater&& other) noexcept {
+   using std::swap;
+   swap(stream_, other.stream_);
+   swap(input_, other.input_);
+   swap(input_remaining_, other.input_remaining_);
+   swap(level_, other.level_);
+   swap(finishing_, other.finishing_);
+   swap(done_, other.done_);
+   swap(dictionary_, other.dictionary_);
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibDeflater::~ZlibDeflater() {
+   if (stream_) {
+      ::deflateEnd(stream_.get());
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+I8 ZlibDeflater::level() const noexcept {
+   return level_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const Buf<const UC>& ZlibDeflater::dictionary() const noexcept {
+   return dictionary_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Sets the preset dictionary used for every subsequent stream, or
+///         removes it if the dictionary is empty.  Also resets the deflater.
+///
+/// \details The dictionary is not copied; pass an owning Buf or make sure
+///         the memory outlives the deflater.
+void ZlibDeflater::dictionary(Buf<const UC> dictionary) {
+   dictionary_ = std::move(dictionary);
+   reset();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Discards any pending input or output and prepares to compress a
+///         new stream.
+void ZlibDeflater::reset() {
+   int result = ::deflateReset(stream_.get());
+   if (result != Z_OK) {
+      throw RecoverableError(make_error_code(zlib_result_code(result)));
+   }
+   std::error_code ec;
+   if (!set_deflate_dictionary(*stream_, dictionary_, ec)) {
+      throw RecoverableError(ec);
+   }
+   stream_->next_in = nullptr;
+   stream_->avail_in = 0;
+   input_ = nullptr;
+   input_remaining_ = 0;
+   finishing_ = false;
+   done_ = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Provides the next chunk of data to compress.
+///
+/// \details Must only be called when needs_input() is true and finish() has
+///         not been called since the last reset().
+void ZlibDeflater::push(gsl::span<const UC> input) noexcept {
+   assert(needs_input());
+   assert(!finishing_);
+   input_ = input.data();
+   input_remaining_ = static_cast<std::size_t>(input.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Indicates that all data has been pushed; subsequent calls to
+///         pull() will flush the remaining compressed data until done().
+void ZlibDeflater::finish() noexcept {
+   finishing_ = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses as much pushed data as possible into output.
+///
+/// \returns The number of bytes written to output.  This may be less than
+///         output.size() even if the stream is not done, for instance when
+///         more input is needed.
+std::size_t ZlibDeflater::pull(gsl::span<UC> output) {
+   ::z_stream& stream = *stream_;
+   UC* out = output.data();
+   std::size_t out_remaining = static_cast<std::size_t>(output.size());
+
+   while (!done_ && out_remaining > 0) {
+      refill_input(stream, input_, input_remaining_);
+      stream.next_out = (::Bytef*)out;
+      stream.avail_out = out_remaining > max_bytes ? max_bytes : static_cast<::uInt>(out_remaining);
+
+      const ::uInt avail_out = stream.avail_out;
+      int result = ::deflate(&stream, finishing_ && input_remaining_ == 0 ? Z_FINISH : Z_NO_FLUSH);
+      const std::size_t produced = avail_out - stream.avail_out;
+      out += produced;
+      out_remaining -= produced;
+
+      if (result == Z_STREAM_END) {
+         done_ = true;
+      } else if (result == Z_BUF_ERROR) {
+         break; // no progress possible until more input is pushed
+      } else if (result != Z_OK) {
+         throw RecoverableError(make_error_code(zlib_result_code(result)));
+      }
+   }
+
+   return static_cast<std::size_t>(output.size()) - out_remaining;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns true when all pushed data has been consumed.
+bool ZlibDeflater::needs_input() const noexcept {
+   return input_remaining_ == 0 && stream_->avail_in == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns true when the end of the stream has been written.
+bool ZlibDeflater::done() const noexcept {
+   return done_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses a complete message, in the same format as
+///         util::deflate_buf().
+///
+/// \details Resets the deflater first, discarding any stream in progress.
+///
+/// \note   The returned buffer may be allocated for a larger size than its
+///         size() accessor reports.
+Buf<UC> ZlibDeflater::deflate_buf(const Buf<const UC>& data, bool encode_length) {
+   reset();
+   std::error_code ec;
+   Buf<UC> buf = deflate(*stream_, data.get(), data.size(), encode_length, ec);
+   finishing_ = true;
+   done_ = true;
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses a complete message into caller-provided memory, in the
+///         same format as util::deflate_buf().
+///
+/// \details Resets the deflater first, discarding any stream in progress.
+///
+/// \returns The number of bytes written to output.
+std::size_t ZlibDeflater::deflate_into(const Buf<const UC>& data, gsl::span<UC> output, bool encode_length) {
+   reset();
+   std::error_code ec;
+   std::size_t size = deflate(*stream_, data.get(), data.size(), output.data(), static_cast<std::size_t>(output.size()), encode_length, ec);
+   finishing_ = true;
+   done_ = true;
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibInflater::ZlibInflater()
+   : stream_(std::make_unique<::z_stream>())
+{
+   init_stream(*stream_);
+   int result = inflateInit(stream_.get());
+   if (result != Z_OK) {
+      throw RecoverableError(make_error_code(zlib_result_code(result)));
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibInflater::ZlibInflater(ZlibInflater&& other) noexcept
+   : stream_(std::move(other.stream_)),
+     input_(other.input_),
+     input_remaining_(other.input_remaining_),
+     done_(other.done_),
+     dictionary_(std::move(other.dictionary_))
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibInflater& ZlibInflater::operator=(ZlibInflater&& other) noexcept {
+   using std::swap;
+   swap(stream_, other.stream_);
+   swap(input_, other.input_);
+   swap(input_remaining_, other.input_remaining_);
+   swap(done_, other.done_);
+   swap(dictionary_, other.dictionary_);
+   return *this;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibInflater::~ZlibInflater() {
+   if (stream_) {
+      ::inflateEnd(stream_.get());
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const Buf<const UC>& ZlibInflater::dictionary() const noexcept {
+   return dictionary_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Sets the dictionary supplied to streams which were compressed
+///         with a preset dictionary.
+///
+/// \details Streams which request a different dictionary fail with
+///         ZlibResultCode::need_dictionary.  The dictionary is not copied;
+///         pass an owning Buf or make sure the memory outlives the inflater.
+void ZlibInflater::dictionary(Buf<const UC> dictionary) noexcept {
+   dictionary_ = std::move(dictionary);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Discards any pending input or output and prepares to decompress
+///         a new stream.
+void ZlibInflater::reset() {
+   int result = ::inflateReset(stream_.get());
+   if (result != Z_OK) {
+      throw RecoverableError(make_error_code(zlib_result_code(result)));
+   }
+   stream_->next_in = nullptr;
+   stream_->avail_in = 0;
+   input_ = nullptr;
+   input_remaining_ = 0;
+   done_ = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Provides the next chunk of compressed data.
+///
+/// \details Must only be called when needs_input() is true.
+void ZlibInflater::push(gsl::span<const UC> input) noexcept {
+   assert(needs_input());
+   input_ = input.data();
+   input_remaining_ = static_cast<std::size_t>(input.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses as much pushed data as possible into output.
+///
+/// \returns The number of bytes written to output.
+std::size_t ZlibInflater::pull(gsl::span<UC> output) {
+   ::z_stream& stream = *stream_;
+   UC* out = output.data();
+   std::size_t out_remaining = static_cast<std::size_t>(output.size());
+
+   while (!done_ && out_remaining > 0) {
+      refill_input(stream, input_, input_remaining_);
+      stream.next_out = (::Bytef*)out;
+      stream.avail_out = out_remaining > max_bytes ? max_bytes : static_cast<::uInt>(out_remaining);
+
+      const ::uInt avail_out = stream.avail_out;
+      int result = ::inflate(&stream, Z_NO_FLUSH);
+      const std::size_t produced = avail_out - stream.avail_out;
+      out += produced;
+      out_remaining -= produced;
+
+      if (result == Z_STREAM_END) {
+         done_ = true;
+      } else if (result == Z_BUF_ERROR) {
+         break; // no progress possible until more input is pushed
+      } else if (result == Z_NEED_DICT) {
+         if (set_inflate_dictionary(stream, dictionary_) != Z_OK) {
+            throw RecoverableError(make_error_code(ZlibResultCode::need_dictionary));
          }
-      } else {
-         uncompressed.release();
-         uncompressed = Buf<UC>(uncompressed.get(), uncompressed_length, detail::delete_array);
+      } else if (result != Z_OK) {
+         throw RecoverableError(make_error_code(zlib_result_code(result)));
       }
    }
 
+   return static_cast<std::size_t>(output.size()) - out_remaining;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns true when all pushed data has been consumed.
+bool ZlibInflater::needs_input() const noexcept {
+   return input_remaining_ == 0 && stream_->avail_in == 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns true when the end of the stream has been reached.
+bool ZlibInflater::done() const noexcept {
+   return done_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses a complete message produced by util::deflate_buf()
+///         or ZlibDeflater::deflate_buf() with encode_length = true.
+///
+/// \details Resets the inflater first, discarding any stream in progress.
+Buf<UC> ZlibInflater::inflate_buf(const Buf<const UC>& compressed) {
+   reset();
+   std::size_t uncompressed_length = get_uncompressed_length(compressed.get(), compressed.size());
+   Buf<UC> uncompressed = make_buf<UC>(uncompressed_length);
+
+   std::error_code ec;
+   Buf<const UC> data = sub_buf(compressed, sizeof(L));
+   uncompressed_length = inflate(*stream_, data.get(), data.size(), uncompressed.get(), uncompressed.size(), dictionary_, ec);
+   input_ = nullptr;
+   input_remaining_ = 0;
+   stream_->avail_in = 0;
+   done_ = true;
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+
+   detail::trim_buf(uncompressed, uncompressed_length);
    return uncompressed;
 }
 
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Decompresses a complete message produced by util::deflate_buf()
+///         or ZlibDeflater::deflate_buf() with encode_length = true into
+///         caller-provided memory.
+///
+/// \details Resets the inflater first, discarding any stream in progress.
+///
+/// \returns The number of bytes written to output.
+std::size_t ZlibInflater::inflate_into(const Buf<const UC>& compressed, gsl::span<UC> output) {
+   reset();
+   const std::size_t uncompressed_length = get_uncompressed_length(compressed.get(), compressed.size());
+   if (uncompressed_length > static_cast<std::size_t>(output.size())) {
+      throw RecoverableError(make_error_code(ZlibResultCode::buffer_error));
+   }
+
+   std::error_code ec;
+   Buf<const UC> data = sub_buf(compressed, sizeof(L));
+   std::size_t size = inflate(*stream_, data.get(), data.size(), output.data(), uncompressed_length, dictionary_, ec);
+   input_ = nullptr;
+   input_remaining_ = 0;
+   stream_->avail_in = 0;
+   done_ = true;
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   return size;
+}
+
 } // be::util
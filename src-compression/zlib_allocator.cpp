@@ -0,0 +1,195 @@
+#include "pch.hpp"
+#include "zlib_allocator.hpp"
+#include <atomic>
+#include <cstdlib>
+
+namespace be::util {
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Precedes every block given to zlib, so that zlib_free() knows how
+///         large it is.
+struct alignas(std::max_align_t) BlockHeader {
+   std::size_t size;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+constexpr std::size_t max_cached_blocks = 16;
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Free blocks kept by one thread.
+///
+/// \details Trivially destructible so that it remains usable while other
+///         thread_local objects (which may own zlib streams) are destroyed;
+///         ThreadCacheGuard releases the blocks and disables the cache
+///         instead.
+struct ThreadCache {
+   BlockHeader* blocks[max_cached_blocks];
+   std::size_t count;
+   std::size_t bytes;
+   bool initialized;
+   bool disabled;
+};
+
+thread_local ThreadCache cache;
+
+///////////////////////////////////////////////////////////////////////////////
+void release_cache(ThreadCache& c) noexcept {
+   for (std::size_t i = 0; i < c.count; ++i) {
+      std::free(c.blocks[i]);
+   }
+   c.count = 0;
+   c.bytes = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+struct ThreadCacheGuard {
+   ~ThreadCacheGuard() {
+      release_cache(cache);
+      cache.disabled = true;
+   }
+};
+
+///////////////////////////////////////////////////////////////////////////////
+std::atomic<U8> config_mode { static_cast<U8>(ZlibAllocatorMode::thread_cache) };
+std::atomic<std::size_t> config_max_cached_bytes { ZlibAllocatorConfig().max_cached_bytes };
+
+std::atomic<U64> stat_allocations { 0 };
+std::atomic<U64> stat_system_allocations { 0 };
+std::atomic<std::size_t> stat_bytes_in_use { 0 };
+std::atomic<std::size_t> stat_peak_bytes_in_use { 0 };
+
+///////////////////////////////////////////////////////////////////////////////
+ThreadCache* get_cache() noexcept {
+   if (config_mode.load(std::memory_order_relaxed) != static_cast<U8>(ZlibAllocatorMode::thread_cache)) {
+      return nullptr;
+   }
+
+   ThreadCache& c = cache;
+   if (!c.initialized) {
+      thread_local ThreadCacheGuard guard;
+      c.initialized = true;
+   }
+   return c.disabled ? nullptr : &c;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Takes the most recently cached block of exactly the requested
+///         size, if there is one.
+BlockHeader* take_cached(ThreadCache& c, std::size_t size) noexcept {
+   for (std::size_t i = c.count; i > 0; --i) {
+      BlockHeader* block = c.blocks[i - 1];
+      if (block->size == size) {
+         c.blocks[i - 1] = c.blocks[c.count - 1];
+         --c.count;
+         c.bytes -= size;
+         return block;
+      }
+   }
+   return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void record_allocation(std::size_t size, bool system) noexcept {
+   stat_allocations.fetch_add(1, std::memory_order_relaxed);
+   if (system) {
+      stat_system_allocations.fetch_add(1, std::memory_order_relaxed);
+   }
+
+   const std::size_t in_use = stat_bytes_in_use.fetch_add(size, std::memory_order_relaxed) + size;
+   std::size_t peak = stat_peak_bytes_in_use.load(std::memory_order_relaxed);
+   while (in_use > peak && !stat_peak_bytes_in_use.compare_exchange_weak(peak, in_use, std::memory_order_relaxed)) { }
+}
+
+} // be::util::()
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibAllocatorConfig zlib_allocator_config() noexcept {
+   ZlibAllocatorConfig config;
+   config.mode = static_cast<ZlibAllocatorMode>(config_mode.load(std::memory_order_relaxed));
+   config.max_cached_bytes = config_max_cached_bytes.load(std::memory_order_relaxed);
+   return config;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Changes how zlib stream state is allocated from now on.
+///
+/// \details Streams which are already open are unaffected, and may free
+///         their memory to a thread cache even after switching to system
+///         mode.  Blocks already cached are kept until reused, released with
+///         release_zlib_allocator_cache(), or their thread exits.
+void zlib_allocator_config(const ZlibAllocatorConfig& config) noexcept {
+   config_max_cached_bytes.store(config.max_cached_bytes, std::memory_order_relaxed);
+   config_mode.store(static_cast<U8>(config.mode), std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+ZlibAllocatorStats zlib_allocator_stats() noexcept {
+   ZlibAllocatorStats stats;
+   stats.allocations = stat_allocations.load(std::memory_order_relaxed);
+   stats.system_allocations = stat_system_allocations.load(std::memory_order_relaxed);
+   stats.bytes_in_use = stat_bytes_in_use.load(std::memory_order_relaxed);
+   stats.peak_bytes_in_use = stat_peak_bytes_in_use.load(std::memory_order_relaxed);
+   return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Zeroes the allocation counters and sets the peak to the number of
+///         bytes currently in use.
+void reset_zlib_allocator_stats() noexcept {
+   stat_allocations.store(0, std::memory_order_relaxed);
+   stat_system_allocations.store(0, std::memory_order_relaxed);
+   stat_peak_bytes_in_use.store(stat_bytes_in_use.load(std::memory_order_relaxed), std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns all blocks cached by the calling thread to the system.
+void release_zlib_allocator_cache() noexcept {
+   release_cache(cache);
+}
+
+namespace detail {
+
+///////////////////////////////////////////////////////////////////////////////
+void* zlib_alloc(void*, unsigned items, unsigned size) noexcept {
+   const std::size_t bytes = std::size_t(items) * std::size_t(size);
+
+   BlockHeader* block = nullptr;
+   if (ThreadCache* c = get_cache()) {
+      block = take_cached(*c, bytes);
+   }
+
+   const bool system = !block;
+   if (system) {
+      block = static_cast<BlockHeader*>(std::malloc(sizeof(BlockHeader) + bytes));
+      if (!block) {
+         return nullptr;
+      }
+      block->size = bytes;
+   }
+
+   record_allocation(bytes, system);
+   return block + 1;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void zlib_free(void*, void* ptr) noexcept {
+   if (!ptr) {
+      return;
+   }
+
+   BlockHeader* block = static_cast<BlockHeader*>(ptr) - 1;
+   const std::size_t bytes = block->size;
+   stat_bytes_in_use.fetch_sub(bytes, std::memory_order_relaxed);
+
+   ThreadCache* c = get_cache();
+   if (c && c->count < max_cached_blocks && c->bytes + bytes <= config_max_cached_bytes.load(std::memory_order_relaxed)) {
+      c->blocks[c->count++] = block;
+      c->bytes += bytes;
+   } else {
+      std::free(block);
+   }
+}
+
+} // be::util::detail
+} // be::util
@@ -0,0 +1,240 @@
+#include "pch.hpp"
+#include "zlib_dictionary.hpp"
+#include <be/core/byte_order.hpp>
+#include <zlib/zlib.h>
+#include <algorithm>
+#include <unordered_map>
+#include <vector>
+
+namespace be::util {
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Substrings are scored by how many samples contain each of their
+///         k-mers, where k is the width of a U64.
+constexpr std::size_t kmer_size = sizeof(U64);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  The length of each substring copied into the dictionary.
+constexpr std::size_t segment_size = 64;
+
+///////////////////////////////////////////////////////////////////////////////
+U64 load_kmer(const UC* ptr) noexcept {
+   U64 kmer;
+   memcpy(&kmer, ptr, sizeof(U64));
+   return kmer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+struct Segment {
+   U64 score;
+   const UC* data;
+   std::size_t size;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+class DictionaryTrainer {
+public:
+   explicit DictionaryTrainer(gsl::span<const Buf<const UC>> samples)
+      : samples_(samples)
+   {
+      std::vector<U64> kmers;
+      for (const Buf<const UC>& sample : samples_) {
+         if (sample.size() < kmer_size) {
+            continue;
+         }
+
+         kmers.clear();
+         for (std::size_t i = 0; i + kmer_size <= sample.size(); ++i) {
+            kmers.push_back(load_kmer(sample.get() + i));
+         }
+         std::sort(kmers.begin(), kmers.end());
+         kmers.erase(std::unique(kmers.begin(), kmers.end()), kmers.end());
+
+         for (U64 kmer : kmers) {
+            ++frequency_[kmer];
+         }
+         total_size_ += sample.size();
+      }
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   /// \brief  Splits the samples into epochs and takes the best segment from
+   ///         each, so that the dictionary covers structure from the whole
+   ///         training set rather than just its most common string.
+   std::vector<Segment> select(std::size_t max_size) {
+      std::vector<Segment> segments;
+      if (total_size_ == 0) {
+         return segments;
+      }
+
+      const std::size_t epochs = std::max(max_size / segment_size, std::size_t(1));
+      const std::size_t epoch_size = std::max(total_size_ / epochs, segment_size);
+
+      std::size_t selected_size = 0;
+      for (std::size_t begin = 0; begin < total_size_ && selected_size < max_size; begin += epoch_size) {
+         Segment best = best_segment(begin, std::min(begin + epoch_size, total_size_));
+         if (best.score == 0) {
+            continue;
+         }
+
+         for (std::size_t i = 0; i + kmer_size <= best.size; ++i) {
+            frequency_[load_kmer(best.data + i)] = 0;
+         }
+         segments.push_back(best);
+         selected_size += best.size;
+      }
+
+      return segments;
+   }
+
+private:
+   ////////////////////////////////////////////////////////////////////////////
+   /// \brief  Only k-mers found in more than one sample are worth keeping.
+   U64 score(const UC* kmer) const {
+      auto it = frequency_.find(load_kmer(kmer));
+      return it == frequency_.end() || it->second < 2 ? 0 : it->second;
+   }
+
+   ////////////////////////////////////////////////////////////////////////////
+   /// \brief  Finds the highest-scoring segment that starts within
+   ///         [begin, end) of the concatenated samples.  Segments never
+   ///         straddle two samples.
+   Segment best_segment(std::size_t begin, std::size_t end) const {
+      Segment best { 0, nullptr, 0 };
+
+      std::size_t offset = 0;
+      for (const Buf<const UC>& sample : samples_) {
+         if (sample.size() < kmer_size) {
+            continue;
+         }
+
+         const std::size_t sample_begin = offset;
+         offset += sample.size();
+         if (offset <= begin) {
+            continue;
+         } else if (sample_begin >= end) {
+            break;
+         }
+
+         const UC* data = sample.get();
+         const std::size_t window = std::min(segment_size, sample.size());
+         const std::size_t kmers_per_window = window - kmer_size + 1;
+         const std::size_t first = begin > sample_begin ? begin - sample_begin : 0;
+         const std::size_t last = std::min(end - sample_begin, sample.size() - window + 1);
+         if (first >= last) {
+            continue;
+         }
+
+         U64 current = 0;
+         for (std::size_t i = 0; i < kmers_per_window; ++i) {
+            current += score(data + first + i);
+         }
+
+         for (std::size_t start = first; ; ++start) {
+            if (current > best.score) {
+               best = Segment { current, data + start, window };
+            }
+            if (start + 1 >= last) {
+               break;
+            }
+            current -= score(data + start);
+            current += score(data + start + kmers_per_window);
+         }
+      }
+
+      return best;
+   }
+
+   gsl::span<const Buf<const UC>> samples_;
+   std::unordered_map<U64, U32> frequency_;
+   std::size_t total_size_ = 0;
+};
+
+} // be::util::()
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Builds a preset dictionary from representative sample messages.
+///
+/// \details Substrings which occur in many samples are collected, with the
+///         most valuable placed at the end of the dictionary, where deflate
+///         can reference them with the shortest distances.  The samples
+///         should be typical of the messages the dictionary will be used
+///         for; a few hundred is usually enough.
+///
+///         Returns an empty buffer if the samples have nothing in common.
+Buf<UC> train_zlib_dictionary(gsl::span<const Buf<const UC>> samples, std::size_t max_size) {
+   max_size = std::min(max_size, max_zlib_dictionary_size);
+
+   DictionaryTrainer trainer(samples);
+   std::vector<Segment> segments = trainer.select(max_size);
+   std::stable_sort(segments.begin(), segments.end(), [](const Segment& a, const Segment& b) {
+      return a.score < b.score;
+   });
+
+   std::size_t size = 0;
+   for (const Segment& segment : segments) {
+      size += segment.size;
+   }
+
+   // if there are too many segments, drop the least valuable ones
+   auto it = segments.begin();
+   while (size > max_size) {
+      size -= it->size;
+      ++it;
+   }
+
+   Buf<UC> dictionary = make_buf<UC>(size);
+   UC* out = dictionary.get();
+   for (; it != segments.end(); ++it) {
+      memcpy(out, it->data, it->size);
+      out += it->size;
+   }
+   return dictionary;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the identifier recorded in the header of streams
+///         compressed with this dictionary (its Adler-32 checksum).
+U32 zlib_dictionary_id(const Buf<const UC>& dictionary) noexcept {
+   ::uLong adler = ::adler32(0, nullptr, 0);
+   const UC* ptr = dictionary.get();
+   std::size_t remaining = dictionary.size();
+   while (remaining > 0) {
+      const ::uInt size = remaining > 0x40000000 ? 0x40000000 : static_cast<::uInt>(remaining);
+      adler = ::adler32(adler, (const ::Bytef*)ptr, size);
+      ptr += size;
+      remaining -= size;
+   }
+   return static_cast<U32>(adler);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Determines which dictionary, if any, is needed to decompress a
+///         stream.
+///
+/// \param  compressed The output of deflate_buf().
+/// \param  id Receives the zlib_dictionary_id() of the required dictionary.
+/// \param  encoded_length Whether compressed begins with the uncompressed
+///         length (deflate_buf()'s encode_length parameter).
+/// \returns true if the stream requires a preset dictionary.
+bool zlib_stream_dictionary_id(const Buf<const UC>& compressed, U32& id, bool encoded_length) noexcept {
+   const std::size_t offset = encoded_length ? sizeof(U64) : 0;
+   if (compressed.size() < offset + 6) {
+      return false;
+   }
+
+   const UC* header = compressed.get() + offset;
+   const UC cmf = header[0];
+   const UC flg = header[1];
+   if ((cmf & 0x0F) != Z_DEFLATED || (cmf * 256u + flg) % 31 != 0 || (flg & 0x20) == 0) {
+      return false;
+   }
+
+   U32 dictid;
+   memcpy(&dictid, header + 2, sizeof(U32));
+   id = bo::to_host(dictid);
+   return true;
+}
+
+} // be::util
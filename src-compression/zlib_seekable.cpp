@@ -0,0 +1,227 @@
+#include "pch.hpp"
+#include "zlib_seekable.hpp"
+#include "zlib_result_code.hpp"
+#include <be/core/byte_order.hpp>
+#include <be/core/exceptions.hpp>
+#include <limits>
+#include <vector>
+
+namespace be::util {
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+constexpr U32 footer_magic = 0x425A736B; // 'BZsk'
+constexpr std::size_t footer_size = sizeof(U64) + sizeof(U32) + sizeof(U32);
+constexpr std::size_t no_frame = std::size_t(-1);
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+void write_net(UC* ptr, T value) noexcept {
+   value = bo::to_net(value);
+   memcpy(ptr, &value, sizeof(T));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename T>
+T read_net(const UC* ptr) noexcept {
+   T value;
+   memcpy(&value, ptr, sizeof(T));
+   return bo::to_host(value);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+[[noreturn]] void throw_corrupt(const char* msg) {
+   throw RecoverableTrace(make_error_code(ZlibResultCode::data_error), msg);
+}
+
+} // be::util::()
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Compresses data into a container which can be read by
+///         SeekableZlibReader.
+///
+/// \details Each frame_size bytes of the input are compressed independently,
+///         so smaller frames allow finer-grained access at the cost of a
+///         worse compression ratio.
+///
+/// \note   The returned buffer may be allocated for a larger size than its
+///         size() accessor reports.
+Buf<UC> deflate_seekable_buf(const Buf<const UC>& data, std::size_t frame_size, I8 level) {
+   if (frame_size == 0 || frame_size > std::numeric_limits<U32>::max()) {
+      throw RecoverableTrace(std::make_error_code(std::errc::invalid_argument), "Frame size must be between 1 and 4294967295 bytes");
+   }
+
+   const std::size_t frame_count = (data.size() + frame_size - 1) / frame_size;
+   const std::size_t max_frame_size = deflate_bound(std::min(frame_size, data.size()), false);
+   Buf<UC> buffer = make_buf<UC>(frame_count * (max_frame_size + sizeof(U64)) + footer_size);
+   std::vector<U64> frame_ends(frame_count);
+
+   ZlibDeflater deflater(level);
+   UC* out = buffer.get();
+   std::size_t compressed_size = 0;
+
+   for (std::size_t frame = 0; frame < frame_count; ++frame) {
+      const std::size_t begin = frame * frame_size;
+      const std::size_t size = std::min(frame_size, data.size() - begin);
+
+      deflater.reset();
+      deflater.push(gsl::span<const UC>(data.get() + begin, size));
+      deflater.finish();
+      compressed_size += deflater.pull(gsl::span<UC>(out + compressed_size, max_frame_size));
+      if (!deflater.done()) {
+         throw RecoverableError(make_error_code(ZlibResultCode::buffer_error));
+      }
+
+      frame_ends[frame] = compressed_size;
+   }
+
+   for (U64 end : frame_ends) {
+      write_net(out + compressed_size, end);
+      compressed_size += sizeof(U64);
+   }
+
+   write_net(out + compressed_size, static_cast<U64>(data.size()));
+   write_net(out + compressed_size + sizeof(U64), static_cast<U32>(frame_size));
+   write_net(out + compressed_size + sizeof(U64) + sizeof(U32), footer_magic);
+   compressed_size += footer_size;
+
+   detail::trim_buf(buffer, compressed_size);
+   return buffer;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Opens a container produced by deflate_seekable_buf().
+///
+/// \details The footer and index are validated, but frames are not
+///         decompressed until they are read.
+SeekableZlibReader::SeekableZlibReader(Buf<const UC> compressed)
+   : data_(std::move(compressed)),
+     cached_frame_(no_frame)
+{
+   if (data_.size() < footer_size) {
+      throw_corrupt("Seekable zlib container is truncated");
+   }
+
+   const UC* footer = data_.get() + data_.size() - footer_size;
+   const U64 size = read_net<U64>(footer);
+   frame_size_ = read_net<U32>(footer + sizeof(U64));
+   if (read_net<U32>(footer + sizeof(U64) + sizeof(U32)) != footer_magic || frame_size_ == 0 ||
+       size > std::numeric_limits<std::size_t>::max()) {
+      throw_corrupt("Seekable zlib container footer is invalid");
+   }
+
+   size_ = static_cast<std::size_t>(size);
+   frame_count_ = size_ / frame_size_ + (size_ % frame_size_ != 0 ? 1 : 0);
+
+   const std::size_t frames_end = data_.size() - footer_size;
+   if (frame_count_ > frames_end / sizeof(U64)) {
+      throw_corrupt("Seekable zlib container index is truncated");
+   }
+
+   const std::size_t index_offset = frames_end - frame_count_ * sizeof(U64);
+   index_ = data_.get() + index_offset;
+
+   U64 prev_end = 0;
+   for (std::size_t frame = 0; frame < frame_count_; ++frame) {
+      const U64 end = read_net<U64>(index_ + frame * sizeof(U64));
+      if (end <= prev_end || end > index_offset) {
+         throw_corrupt("Seekable zlib container index is invalid");
+      }
+      prev_end = end;
+   }
+
+   if (prev_end != index_offset) {
+      throw_corrupt("Seekable zlib container index is invalid");
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the size of the uncompressed data.
+std::size_t SeekableZlibReader::size() const noexcept {
+   return size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t SeekableZlibReader::frame_size() const noexcept {
+   return frame_size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t SeekableZlibReader::frame_count() const noexcept {
+   return frame_count_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Copies uncompressed data starting at offset into output.
+///
+/// \returns The number of bytes copied, which will be less than
+///         output.size() only if the end of the data is reached.
+std::size_t SeekableZlibReader::read(std::size_t offset, gsl::span<UC> output) {
+   if (offset >= size_) {
+      return 0;
+   }
+
+   const std::size_t total = std::min(static_cast<std::size_t>(output.size()), size_ - offset);
+   UC* out = output.data();
+   std::size_t remaining = total;
+
+   while (remaining > 0) {
+      const std::size_t frame = offset / frame_size_;
+      const std::size_t frame_offset = offset % frame_size_;
+      const std::size_t frame_length = std::min(frame_size_, size_ - frame * frame_size_);
+      const std::size_t length = std::min(remaining, frame_length - frame_offset);
+
+      if (length == frame_length && frame != cached_frame_) {
+         inflate_frame_(frame, out, frame_length);
+      } else {
+         if (frame != cached_frame_) {
+            if (!cache_) {
+               cache_ = make_buf<UC>(frame_size_);
+            }
+            cached_frame_ = no_frame;
+            inflate_frame_(frame, cache_.get(), frame_length);
+            cached_frame_ = frame;
+         }
+         memcpy(out, cache_.get() + frame_offset, length);
+      }
+
+      out += length;
+      offset += length;
+      remaining -= length;
+   }
+
+   return total;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns a copy of up to size bytes of uncompressed data starting
+///         at offset.
+Buf<UC> SeekableZlibReader::read(std::size_t offset, std::size_t size) {
+   Buf<UC> buf = make_buf<UC>(offset < size_ ? std::min(size, size_ - offset) : 0);
+   read(offset, gsl::span<UC>(buf.get(), buf.size()));
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t SeekableZlibReader::frame_begin_(std::size_t frame) const noexcept {
+   return frame == 0 ? 0 : frame_end_(frame - 1);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t SeekableZlibReader::frame_end_(std::size_t frame) const noexcept {
+   return static_cast<std::size_t>(read_net<U64>(index_ + frame * sizeof(U64)));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void SeekableZlibReader::inflate_frame_(std::size_t frame, UC* output, std::size_t size) {
+   const std::size_t begin = frame_begin_(frame);
+   const std::size_t end = frame_end_(frame);
+
+   inflater_.reset();
+   inflater_.push(gsl::span<const UC>(data_.get() + begin, end - begin));
+   if (inflater_.pull(gsl::span<UC>(output, size)) != size || !inflater_.done()) {
+      throw_corrupt("Seekable zlib container frame is corrupt");
+   }
+}
+
+} // be::util
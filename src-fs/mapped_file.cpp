@@ -0,0 +1,245 @@
+#include "pch.hpp"
+#include "mapped_file.hpp"
+#include "get_file_contents.hpp"
+#include <be/core/native.hpp>
+#include <algorithm>
+#include <limits>
+
+#ifndef BE_NATIVE_VC_WIN
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+#endif
+
+namespace be::util {
+
+///////////////////////////////////////////////////////////////////////////////
+MappedFile::MappedFile(const Path& path, MappedFileAccess access) {
+   std::error_code ec;
+   data_ = detail::map_file(path, ec);
+   if (ec) {
+      throw fs::filesystem_error("Failed to map file", path, ec);
+   }
+
+   if (access != MappedFileAccess::normal) {
+      advise(access);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+MappedFile::MappedFile(const Path& path, std::error_code& ec) noexcept
+   : MappedFile(path, MappedFileAccess::normal, ec)
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+MappedFile::MappedFile(const Path& path, MappedFileAccess access, std::error_code& ec) noexcept
+   : data_(detail::map_file(path, ec))
+{
+   if (access != MappedFileAccess::normal) {
+      advise(access);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const UC* MappedFile::data() const noexcept {
+   return data_.get();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t MappedFile::size() const noexcept {
+   return data_.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns a non-owning view of the file's contents, valid until the
+///         MappedFile is destroyed.
+Buf<const UC> MappedFile::buf() const noexcept {
+   return tmp_buf(data_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Transfers ownership of the mapping to a buffer which unmaps the
+///         file when it is destroyed.
+Buf<const UC> MappedFile::release() noexcept {
+   return std::move(data_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void MappedFile::advise(MappedFileAccess access) noexcept {
+   detail::advise_mapped_file(data_.get(), data_.size(), access);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Starts reading part of the file into memory in the background, so
+///         that it is less likely to fault when it is touched.
+void MappedFile::prefetch(std::size_t offset, std::size_t size) noexcept {
+   if (offset >= data_.size()) {
+      return;
+   }
+   detail::advise_mapped_file(data_.get() + offset, std::min(size, data_.size() - offset), MappedFileAccess::will_need);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Loads an entire file, mapping it into memory rather than copying
+///         it if it is at least min_mapped_file_size bytes.
+///
+/// \details Use this instead of get_file_contents_buf() for large files
+///         which may only be partly read, or which are kept for a long time
+///         without modification: no data is copied up front, and pages are
+///         only read from disk when they are first touched.
+///
+///         For large files, the returned buffer keeps the file mapped until
+///         it is destroyed, with the same hazards as a MappedFile.  While the
+///         buffer exists, the file must not be truncated or rewritten in
+///         place (on POSIX systems, reading a page past the new end of the
+///         file crashes the process with SIGBUS, and other changes to the
+///         file may become visible through the buffer).  On Windows, the
+///         mapping prevents the file from being truncated or replaced until
+///         the buffer is destroyed.
+Buf<const UC> get_file_contents_mapped(const Path& path) {
+   std::error_code ec;
+   Buf<const UC> data = get_file_contents_mapped(path, ec);
+   if (ec) {
+      throw fs::filesystem_error("Failed to load file", path, ec);
+   }
+   return data;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+Buf<const UC> get_file_contents_mapped(const Path& path, std::error_code& ec) noexcept {
+   std::error_code size_ec;
+   const std::uintmax_t size = fs::file_size(path, size_ec);
+   if (!size_ec && size >= min_mapped_file_size) {
+      Buf<const UC> data = detail::map_file(path, ec);
+      if (ec != std::errc::not_supported) {
+         return data;
+      }
+      ec = std::error_code();
+   }
+
+   return Buf<const UC>(get_file_contents_buf(path, ec));
+}
+
+#ifndef BE_NATIVE_VC_WIN
+
+namespace detail {
+namespace {
+
+#if defined(__unix__) || defined(__APPLE__)
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t page_size() noexcept {
+   static const std::size_t size = std::size_t(::sysconf(_SC_PAGESIZE));
+   return size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Buf deleters only receive the data pointer, so each file is mapped
+///         one page after a private page which records the mapping's size.
+void unmap_file(void* ptr) noexcept {
+   UC* header = static_cast<UC*>(ptr) - page_size();
+   std::size_t size;
+   memcpy(&size, header, sizeof(std::size_t));
+   ::munmap(header, page_size() + size);
+}
+
+#endif
+
+} // be::util::detail::()
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Maps an entire file into memory, read-only.
+///
+/// \details Returns an empty buffer if the file is empty.
+Buf<const UC> map_file(const Path& path, std::error_code& ec) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+   const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+   if (fd < 0) {
+      ec = std::error_code(errno, std::generic_category());
+      return Buf<const UC>();
+   }
+
+   struct ::stat info;
+   if (::fstat(fd, &info) != 0) {
+      ec = std::error_code(errno, std::generic_category());
+      ::close(fd);
+      return Buf<const UC>();
+   }
+
+   if (S_ISDIR(info.st_mode)) {
+      ec = std::make_error_code(std::errc::is_a_directory);
+      ::close(fd);
+      return Buf<const UC>();
+   }
+
+   if (info.st_size <= 0) {
+      ::close(fd);
+      return Buf<const UC>();
+   }
+
+   const std::size_t page = page_size();
+   if (std::uintmax_t(info.st_size) > std::numeric_limits<std::size_t>::max() - page) {
+      ec = std::make_error_code(std::errc::file_too_large);
+      ::close(fd);
+      return Buf<const UC>();
+   }
+   const std::size_t size = std::size_t(info.st_size);
+
+   // reserve address space for the header page and the file together, then
+   // map the file over the end of the reservation
+   void* reserved = ::mmap(nullptr, page + size, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (reserved == MAP_FAILED) {
+      ec = std::error_code(errno, std::generic_category());
+      ::close(fd);
+      return Buf<const UC>();
+   }
+
+   UC* header = static_cast<UC*>(reserved);
+   UC* data = header + page;
+   if (::mmap(data, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED ||
+       ::mprotect(header, page, PROT_READ | PROT_WRITE) != 0) {
+      ec = std::error_code(errno, std::generic_category());
+      ::munmap(reserved, page + size);
+      ::close(fd);
+      return Buf<const UC>();
+   }
+
+   ::close(fd);
+   memcpy(header, &size, sizeof(std::size_t));
+   return Buf<const UC>(data, size, unmap_file);
+#else
+   ec = std::make_error_code(std::errc::not_supported);
+   return Buf<const UC>();
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void advise_mapped_file(const UC* data, std::size_t size, MappedFileAccess access) noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+   if (size == 0) {
+      return;
+   }
+
+   int advice;
+   switch (access) {
+      case MappedFileAccess::sequential: advice = MADV_SEQUENTIAL; break;
+      case MappedFileAccess::random:     advice = MADV_RANDOM; break;
+      case MappedFileAccess::will_need:  advice = MADV_WILLNEED; break;
+      default:                           advice = MADV_NORMAL; break;
+   }
+
+   // madvise() requires a page-aligned address
+   const std::uintptr_t end = reinterpret_cast<std::uintptr_t>(data) + size;
+   const std::uintptr_t begin = reinterpret_cast<std::uintptr_t>(data) & ~std::uintptr_t(page_size() - 1);
+   ::madvise(reinterpret_cast<void*>(begin), std::size_t(end - begin), advice);
+#endif
+}
+
+} // be::util::detail
+
+#endif
+
+} // be::util
@@ -0,0 +1,91 @@
+#include <be/core/native.hpp>
+#ifdef BE_NATIVE_VC_WIN
+
+#include "mapped_file.hpp"
+#include BE_NATIVE_CORE(vc_win_win32.hpp)
+#include <limits>
+
+namespace be::util::detail {
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+void unmap_file(void* ptr) noexcept {
+   ::UnmapViewOfFile(ptr);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::error_code last_error() noexcept {
+   return std::error_code(static_cast<int>(::GetLastError()), std::system_category());
+}
+
+} // be::util::detail::()
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Maps an entire file into memory, read-only.
+///
+/// \details Returns an empty buffer if the file is empty.
+Buf<const UC> map_file(const Path& path, std::error_code& ec) noexcept {
+   ::HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+   if (file == INVALID_HANDLE_VALUE) {
+      ec = last_error();
+      return Buf<const UC>();
+   }
+
+   ::LARGE_INTEGER size;
+   if (!::GetFileSizeEx(file, &size)) {
+      ec = last_error();
+      ::CloseHandle(file);
+      return Buf<const UC>();
+   }
+
+   if (size.QuadPart <= 0) {
+      ::CloseHandle(file);
+      return Buf<const UC>();
+   }
+
+   if (U64(size.QuadPart) > U64(std::numeric_limits<std::size_t>::max())) {
+      ec = std::make_error_code(std::errc::file_too_large);
+      ::CloseHandle(file);
+      return Buf<const UC>();
+   }
+
+   // the view keeps the file and mapping objects alive after their handles are closed
+   ::HANDLE mapping = ::CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+   if (!mapping) {
+      ec = last_error();
+      ::CloseHandle(file);
+      return Buf<const UC>();
+   }
+
+   void* view = ::MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+   if (!view) {
+      ec = last_error();
+   }
+
+   ::CloseHandle(mapping);
+   ::CloseHandle(file);
+
+   if (!view) {
+      return Buf<const UC>();
+   }
+
+   return Buf<const UC>(static_cast<const UC*>(view), std::size_t(size.QuadPart), unmap_file);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Windows has no equivalent to madvise()'s access pattern hints, so
+///         only MappedFileAccess::will_need has any effect.
+void advise_mapped_file(const UC* data, std::size_t size, MappedFileAccess access) noexcept {
+   if (access != MappedFileAccess::will_need || size == 0) {
+      return;
+   }
+
+   ::WIN32_MEMORY_RANGE_ENTRY range;
+   range.VirtualAddress = const_cast<UC*>(data);
+   range.NumberOfBytes = size;
+   ::PrefetchVirtualMemory(::GetCurrentProcess(), 1, &range, 0);
+}
+
+} // be::util::detail
+
+#endif
@@ -1,5 +1,7 @@
 #include "lua_util.hpp"
+#include <be/util/compression_codec.hpp>
 #include <be/util/zlib.hpp>
+#include <be/core/exceptions.hpp>
 #include <be/core/filesystem.hpp>
 #include <be/util/pointer_to_string.hpp>
 
@@ -483,29 +485,72 @@ int util_seed(lua_State* L) {
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+util::CodecType util_check_codec(lua_State* L, int arg) {
+   static const char* const names[] = { "zlib", "lz4", "zstd", nullptr };
+   util::CodecType type = static_cast<util::CodecType>(luaL_checkoption(L, arg, "zlib", names));
+   if (!util::codec_available(type)) {
+      luaL_argerror(L, arg, "codec not available in this build");
+   }
+   return type;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  util.deflate(data [, level [, codec]]) compresses data using
+///         "zlib" (the default), "lz4", or "zstd", if the latter are enabled
+///         in this build.  No length or codec is recorded, so both must be
+///         passed to util.inflate().
 int util_deflate(lua_State* L) {
    std::size_t len;
    const char* ptr = luaL_checklstring(L, 1, &len);
+   util::CodecType type = util_check_codec(L, 3);
 
-   I8 level = 8;
-   if (lua_gettop(L) > 1) {
+   I8 level = type == util::CodecType::zlib ? 8 : util::default_codec_level;
+   if (!lua_isnoneornil(L, 2)) {
       level = (I8)luaL_checkinteger(L, 2);
    }
 
-   Buf<const UC> data = make_buf(ptr, len);
-   Buf<const char> compressed(util::deflate_buf(data, false, level));
-   lua_pushlstring(L, compressed.get(), compressed.size());
+   const util::Codec& codec = util::codec(type);
+   if (level == util::default_codec_level) {
+      level = codec.default_level();
+   }
+
+   std::size_t bound = codec.bound(len);
+   if (bound == 0) {
+      return luaL_argerror(L, 1, "too large for codec");
+   }
+
+   Buf<UC> compressed = make_buf<UC>(bound);
+   std::error_code ec;
+   std::size_t size = codec.compress(reinterpret_cast<const UC*>(ptr), len, compressed.get(), compressed.size(), level, ec);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   lua_pushlstring(L, reinterpret_cast<const char*>(compressed.get()), size);
    return 1;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+/// \brief  util.inflate(data, uncompressed_length [, codec])
 int util_inflate(lua_State* L) {
    std::size_t len;
    const char* ptr = luaL_checklstring(L, 1, &len);
    std::size_t uncompressed_length = luaL_checkinteger(L, 2);
+   util::CodecType type = util_check_codec(L, 3);
    Buf<const UC> data = make_buf(ptr, len);
-   Buf<const char> uncompressed(util::inflate_buf(data, uncompressed_length));
-   lua_pushlstring(L, uncompressed.get(), uncompressed.size());
+
+   if (type == util::CodecType::zlib) {
+      Buf<const char> uncompressed(util::inflate_buf(data, uncompressed_length));
+      lua_pushlstring(L, uncompressed.get(), uncompressed.size());
+      return 1;
+   }
+
+   Buf<UC> uncompressed = make_buf<UC>(uncompressed_length);
+   std::error_code ec;
+   util::codec(type).decompress(data.get(), data.size(), uncompressed.get(), uncompressed.size(), ec);
+   if (ec) {
+      throw RecoverableError(ec);
+   }
+   lua_pushlstring(L, reinterpret_cast<const char*>(uncompressed.get()), uncompressed.size());
    return 1;
 }
 
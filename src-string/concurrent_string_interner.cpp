@@ -0,0 +1,214 @@
+#include "pch.hpp"
+#include "concurrent_string_interner.hpp"
+#include <cstring>
+
+namespace be {
+namespace util {
+namespace {
+
+constexpr std::size_t min_table_capacity = 16;
+
+} // be::util::()
+
+///////////////////////////////////////////////////////////////////////////////
+ConcurrentStringInterner::table::table(std::size_t capacity)
+   : mask(capacity - 1),
+     slots(new slot[capacity])
+{
+   for (std::size_t i = 0; i < capacity; ++i) {
+      slots[i].hash.store(0, std::memory_order_relaxed);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+ConcurrentStringInterner::shard::shard()
+   : size(0)
+{
+   tables.push_back(std::make_unique<table>(min_table_capacity));
+   current.store(tables.back().get(), std::memory_order_relaxed);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \param  shards The number of shards to divide strings between.  Rounded
+///         up to a power of two.  More shards reduce contention between
+///         threads interning new strings, at the cost of some memory for
+///         each shard's table and arena.
+ConcurrentStringInterner::ConcurrentStringInterner(std::size_t shards) {
+   shard_count_ = 1;
+   shard_shift_ = 64;
+   while (shard_count_ < shards) {
+      shard_count_ *= 2;
+      --shard_shift_;
+   }
+   shards_ = std::make_unique<shard[]>(shard_count_);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t ConcurrentStringInterner::shard_count() const noexcept {
+   return shard_count_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the number of distinct strings which have been interned.
+///
+/// \details If other threads are interning strings concurrently, the result
+///         may not include strings which have just been added.
+std::size_t ConcurrentStringInterner::size() const noexcept {
+   std::size_t total = 0;
+   for (std::size_t i = 0; i < shard_count_; ++i) {
+      total += shards_[i].size.load(std::memory_order_relaxed);
+   }
+   return total;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns memory usage statistics summed over all shards.
+///
+/// \details Locks each shard in turn, so it should not be called while
+///         other threads are busy interning new strings.
+StringInternerStats ConcurrentStringInterner::stats() {
+   StringInternerStats result;
+   for (std::size_t i = 0; i < shard_count_; ++i) {
+      shard& s = shards_[i];
+      std::lock_guard<std::mutex> lock(s.mutex);
+      result.strings += s.size.load(std::memory_order_relaxed);
+      result.segments += s.arena.segment_count();
+      result.bytes_reserved += s.arena.bytes_reserved();
+      result.bytes_used += s.arena.bytes_used();
+      result.bytes_wasted += s.arena.bytes_wasted();
+   }
+   return result;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Ensures that at least count distinct strings can be interned
+///         without growing any shard's table, assuming strings are evenly
+///         distributed between shards.
+void ConcurrentStringInterner::reserve_strings(std::size_t count) {
+   std::size_t per_shard = (count + shard_count_ - 1) / shard_count_;
+   for (std::size_t i = 0; i < shard_count_; ++i) {
+      shard& s = shards_[i];
+      std::lock_guard<std::mutex> lock(s.mutex);
+      grow_(s, per_shard);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+be::SV ConcurrentStringInterner::operator()(be::SV str) {
+   const U64 hash = hash_(str);
+   shard& s = shard_(hash);
+
+   const slot* existing = find_(*s.current.load(std::memory_order_acquire), str, hash);
+   if (existing) {
+      return be::SV(existing->data, existing->size);
+   }
+
+   std::lock_guard<std::mutex> lock(s.mutex);
+
+   // another thread may have interned the string since the lock-free lookup
+   table* t = s.current.load(std::memory_order_relaxed);
+   existing = find_(*t, str, hash);
+   if (existing) {
+      return be::SV(existing->data, existing->size);
+   }
+
+   const std::size_t size = s.size.load(std::memory_order_relaxed) + 1;
+   t = &grow_(s, size);
+
+   char* data = s.arena.allocate(str.size());
+   if (!str.empty()) {
+      std::memcpy(data, str.data(), str.size());
+   }
+
+   insert_(*t, hash, data, str.size());
+   s.size.store(size, std::memory_order_relaxed);
+   return be::SV(data, str.size());
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Hashes a string.  A hash of 0 marks an empty slot, so it is
+///         never returned.
+U64 ConcurrentStringInterner::hash_(be::SV str) noexcept {
+   U64 hash = detail::StringInternerTable::hash(str);
+   return hash == 0 ? 1 : hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Searches a table without locking.
+///
+/// \details Slots are filled in probe order and never cleared, and a slot's
+///         hash is stored (with release semantics) only after its data and
+///         size have been written.  So once an empty slot is found, the
+///         string was not in the table when the search started.
+const ConcurrentStringInterner::slot* ConcurrentStringInterner::find_(const table& t, be::SV str, U64 hash) noexcept {
+   for (std::size_t i = hash & t.mask;; i = (i + 1) & t.mask) {
+      const slot& sl = t.slots[i];
+      const U64 slot_hash = sl.hash.load(std::memory_order_acquire);
+      if (slot_hash == 0) {
+         return nullptr;
+      }
+      if (slot_hash == hash && sl.size == str.size() && (sl.size == 0 || std::memcmp(sl.data, str.data(), sl.size) == 0)) {
+         return &sl;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Fills the first empty slot in hash's probe sequence.  The caller
+///         must hold the owning shard's mutex and ensure there is room.
+void ConcurrentStringInterner::insert_(table& t, U64 hash, const char* data, std::size_t size) noexcept {
+   for (std::size_t i = hash & t.mask;; i = (i + 1) & t.mask) {
+      slot& sl = t.slots[i];
+      if (sl.hash.load(std::memory_order_relaxed) == 0) {
+         sl.data = data;
+         sl.size = size;
+         sl.hash.store(hash, std::memory_order_release);
+         return;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Selects a shard using the high bits of the hash; the low bits
+///         are used to index each shard's table.
+ConcurrentStringInterner::shard& ConcurrentStringInterner::shard_(U64 hash) noexcept {
+   return shards_[shard_shift_ >= 64 ? 0 : std::size_t(hash >> shard_shift_)];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Ensures a shard's table can hold count strings while staying at
+///         or below 3/4 full, replacing it with a larger copy if necessary.
+///
+/// \details Readers may still be searching the old table, so it is kept
+///         alive until the interner is destroyed.  Since each table is at
+///         least twice the size of the last, this at most doubles the memory
+///         used by tables.  The caller must hold the shard's mutex.
+ConcurrentStringInterner::table& ConcurrentStringInterner::grow_(shard& s, std::size_t count) {
+   table* old = s.current.load(std::memory_order_relaxed);
+   std::size_t capacity = old->mask + 1;
+   if (count * 4 <= capacity * 3) {
+      return *old;
+   }
+
+   while (count * 4 > capacity * 3) {
+      capacity *= 2;
+   }
+
+   s.tables.reserve(s.tables.size() + 1);
+   auto t = std::make_unique<table>(capacity);
+   for (std::size_t i = 0; i <= old->mask; ++i) {
+      const slot& sl = old->slots[i];
+      const U64 hash = sl.hash.load(std::memory_order_relaxed);
+      if (hash != 0) {
+         insert_(*t, hash, sl.data, sl.size);
+      }
+   }
+
+   table& result = *t;
+   s.tables.push_back(std::move(t));
+   s.current.store(&result, std::memory_order_release);
+   return result;
+}
+
+} // be::util
+} // be
@@ -1,47 +1,705 @@
 #include "pch.hpp"
 #include "string_interner.hpp"
+#include <be/core/exceptions.hpp>
+#include <cassert>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define BE_UTIL_STRING_INTERNER_SSE2
+#  include <emmintrin.h>
+#endif
+#ifdef _MSC_VER
+#  include <intrin.h>
+#endif
 
 namespace be {
 namespace util {
+namespace detail {
+namespace {
+
+constexpr U8 ctrl_empty = 0x80;
+
+///////////////////////////////////////////////////////////////////////////////
+U8 h2(U64 hash) noexcept {
+   return U8(hash & 0x7F);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t h1(U64 hash) noexcept {
+   return std::size_t(hash >> 7);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns a bitmask with one bit set for each control byte in the
+///         group which equals tag.
+U32 match_group(const U8* ctrl, U8 tag) noexcept {
+#ifdef BE_UTIL_STRING_INTERNER_SSE2
+   __m128i group = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl));
+   return U32(_mm_movemask_epi8(_mm_cmpeq_epi8(group, _mm_set1_epi8(char(tag)))));
+#else
+   U32 mask = 0;
+   for (std::size_t i = 0; i < StringInternerTable::group_size; ++i) {
+      mask |= U32(ctrl[i] == tag) << i;
+   }
+   return mask;
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns a bitmask with one bit set for each empty slot in the
+///         group.
+U32 match_empty(const U8* ctrl) noexcept {
+#ifdef BE_UTIL_STRING_INTERNER_SSE2
+   // full slots never have the high bit set
+   return U32(_mm_movemask_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl))));
+#else
+   return match_group(ctrl, ctrl_empty);
+#endif
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t lowest_bit(U32 mask) noexcept {
+#ifdef _MSC_VER
+   unsigned long index;
+   _BitScanForward(&index, mask);
+   return std::size_t(index);
+#else
+   return std::size_t(__builtin_ctz(mask));
+#endif
+}
+
+constexpr std::size_t no_slot = std::size_t(-1);
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the number of groups a table needs to hold count strings
+///         without exceeding the maximum load factor of 7/8.
+std::size_t groups_for(std::size_t count) noexcept {
+   std::size_t slots = count + count / 7 + 1;
+   std::size_t groups = 1;
+   while (groups * StringInternerTable::group_size < slots) {
+      groups *= 2;
+   }
+   return groups;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Searches hash's probe sequence for a slot whose control byte
+///         matches and for which match(index) returns true.
+///
+/// \details Triangular probing visits every group exactly once when the
+///         number of groups is a power of two.  The search ends at the first
+///         group with an empty slot, or once every group has been visited,
+///         so even a corrupt snapshot can't cause an infinite loop.
+template <typename F>
+std::size_t find_slot(const U8* ctrl, std::size_t groups, U64 hash, F&& match) noexcept {
+   if (groups == 0) {
+      return no_slot;
+   }
+
+   const U8 tag = h2(hash);
+   const std::size_t mask = groups - 1;
+   std::size_t group = h1(hash) & mask;
+
+   for (std::size_t step = 1; step <= groups; ++step) {
+      const std::size_t base = group * StringInternerTable::group_size;
+      const U8* group_ctrl = ctrl + base;
+      for (U32 matches = match_group(group_ctrl, tag); matches != 0; matches &= matches - 1) {
+         const std::size_t index = base + lowest_bit(matches);
+         if (match(index)) {
+            return index;
+         }
+      }
+      if (match_empty(group_ctrl) != 0) {
+         break;
+      }
+      group = (group + step) & mask;
+   }
+   return no_slot;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Marks the first empty slot in hash's probe sequence as full and
+///         returns its index.  There must be at least one empty slot.
+std::size_t claim_slot(U8* ctrl, std::size_t groups, U64 hash) noexcept {
+   const std::size_t mask = groups - 1;
+   std::size_t group = h1(hash) & mask;
+
+   for (std::size_t step = 1;; ++step) {
+      const std::size_t base = group * StringInternerTable::group_size;
+      U32 empty = match_empty(ctrl + base);
+      if (empty != 0) {
+         const std::size_t index = base + lowest_bit(empty);
+         ctrl[index] = h2(hash);
+         return index;
+      }
+      group = (group + step) & mask;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+U64 hash_mix(U64 hash, U64 word) noexcept {
+   hash = (hash ^ word) * 0xFF51AFD7ED558CCDull;
+   return hash ^ (hash >> 32);
+}
+
+} // be::util::detail::()
+
+///////////////////////////////////////////////////////////////////////////////
+StringArena::StringArena(std::size_t min_segment_size, std::size_t max_segment_size)
+   : min_segment_size_(min_segment_size),
+     max_segment_size_(be::max(min_segment_size, max_segment_size))
+{ }
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Allocates from the current segment if possible, otherwise from a
+///         new segment of max(bytes, segment_size) bytes.  If segment_size is
+///         0, the new segment's size is chosen by geometric growth.
+char* StringArena::allocate(std::size_t bytes, std::size_t segment_size) {
+   if (bytes <= free_ && next_) {
+      char* data = next_;
+      next_ += bytes;
+      free_ -= bytes;
+      used_ += bytes;
+      return data;
+   }
+
+   if (segment_size == 0) {
+      segment_size = be::min(be::max(reserved_, min_segment_size_), max_segment_size_);
+   }
+   return allocate_segment_(bytes, segment_size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Ensures the current segment has at least bytes free, allocating
+///         a new segment of exactly that size if necessary.
+void StringArena::reserve(std::size_t bytes) {
+   if (bytes > free_ || !next_) {
+      allocate_segment_(0, bytes);
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the number of bytes which can be allocated from the
+///         current segment.
+std::size_t StringArena::available() const noexcept {
+   return next_ ? free_ : 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t StringArena::segment_count() const noexcept {
+   return segments_.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t StringArena::bytes_reserved() const noexcept {
+   return reserved_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t StringArena::bytes_used() const noexcept {
+   return used_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t StringArena::bytes_wasted() const noexcept {
+   return wasted_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+char* StringArena::allocate_segment_(std::size_t bytes, std::size_t segment_size) {
+   segment_size = be::max(bytes, segment_size);
+   segments_.push_back(std::make_unique<char[]>(segment_size));
+   char* data = segments_.back().get();
+   reserved_ += segment_size;
+   used_ += bytes;
+
+   // keep allocating from whichever segment has more room left
+   const std::size_t remaining = segment_size - bytes;
+   if (remaining > free_ || !next_) {
+      wasted_ += free_;
+      next_ = data + bytes;
+      free_ = remaining;
+   } else {
+      wasted_ += remaining;
+   }
+   return data;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Hashes a string eight bytes at a time, followed by a final
+///         avalanche step so that both the high bits (used to select a group)
+///         and the low 7 bits (used as the control byte tag) are well mixed.
+U64 StringInternerTable::hash(be::SV str) noexcept {
+   const char* ptr = str.data();
+   std::size_t remaining = str.size();
+   U64 hash = 0x9E3779B97F4A7C15ull ^ (U64(remaining) * 0xC2B2AE3D27D4EB4Full);
+
+   while (remaining >= sizeof(U64)) {
+      U64 word;
+      std::memcpy(&word, ptr, sizeof(U64));
+      hash = hash_mix(hash, word);
+      ptr += sizeof(U64);
+      remaining -= sizeof(U64);
+   }
+
+   // Fixed-size (possibly overlapping) loads for the tail, since a
+   // variable-length memcpy generally won't be inlined.
+   if (remaining > 0) {
+      U64 word;
+      if (str.size() >= sizeof(U64)) {
+         std::memcpy(&word, ptr + remaining - sizeof(U64), sizeof(U64));
+      } else if (remaining >= sizeof(U32)) {
+         U32 lo, hi;
+         std::memcpy(&lo, ptr, sizeof(U32));
+         std::memcpy(&hi, ptr + remaining - sizeof(U32), sizeof(U32));
+         word = U64(hi) << 32 | lo;
+      } else {
+         word = U64(UC(ptr[0])) << 16 | U64(UC(ptr[remaining / 2])) << 8 | UC(ptr[remaining - 1]);
+      }
+      hash = hash_mix(hash, word);
+   }
+
+   hash ^= hash >> 33;
+   hash *= 0xFF51AFD7ED558CCDull;
+   hash ^= hash >> 33;
+   hash *= 0xC4CEB9FE1A85EC53ull;
+   hash ^= hash >> 33;
+   return hash;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t StringInternerTable::size() const noexcept {
+   return size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the number of strings which can be held without growing
+///         the table.
+std::size_t StringInternerTable::capacity() const noexcept {
+   return size_ + growth_left_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void StringInternerTable::reserve(std::size_t count) {
+   if (count <= capacity()) {
+      return;
+   }
+
+   rehash_(groups_for(count));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+const StringInternerTable::entry* StringInternerTable::find(be::SV str, U64 hash) const noexcept {
+   const std::size_t index = find_slot(ctrl_.get(), groups_, hash, [&](std::size_t i) {
+         const entry& e = slots_[i];
+         return e.hash == hash && e.size == str.size() && (e.size == 0 || std::memcmp(e.data, str.data(), e.size) == 0);
+      });
+   return index == no_slot ? nullptr : &slots_[index];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Adds a string to the table.  The string must not already be
+///         present, must be shorter than 4 GiB, and the table does not copy
+///         its contents.
+const StringInternerTable::entry& StringInternerTable::insert(be::SV str, U64 hash, U32 id) {
+   if (growth_left_ == 0) {
+      rehash_(groups_ == 0 ? 1 : groups_ * 2);
+   }
+
+   entry& e = insert_unique_(hash);
+   e.data = str.data();
+   e.size = U32(str.size());
+   e.id = id;
+   return e;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void StringInternerTable::rehash_(std::size_t groups) {
+   const std::size_t slots = groups * group_size;
+   std::unique_ptr<U8[]> old_ctrl = std::move(ctrl_);
+   std::unique_ptr<entry[]> old_slots = std::move(slots_);
+   const std::size_t old_slot_count = groups_ * group_size;
+
+   try {
+      ctrl_ = std::make_unique<U8[]>(slots);
+      slots_ = std::unique_ptr<entry[]>(new entry[slots]);
+   } catch (...) {
+      ctrl_ = std::move(old_ctrl);
+      slots_ = std::move(old_slots);
+      throw;
+   }
+
+   std::memset(ctrl_.get(), ctrl_empty, slots);
+   groups_ = groups;
+   size_ = 0;
+   growth_left_ = slots - slots / 8;
+
+   for (std::size_t i = 0; i < old_slot_count; ++i) {
+      if (old_ctrl[i] != ctrl_empty) {
+         const entry& old = old_slots[i];
+         insert_unique_(old.hash) = old;
+      }
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Claims the first empty slot in hash's probe sequence.  Does not
+///         check for growth; the caller must ensure there is room.
+StringInternerTable::entry& StringInternerTable::insert_unique_(U64 hash) noexcept {
+   entry& e = slots_[claim_slot(ctrl_.get(), groups_, hash)];
+   e.hash = hash;
+   --growth_left_;
+   ++size_;
+   return e;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+struct StringInternerSnapshot::header {
+   char magic[8];
+   U32 version;
+   U32 byte_order;
+   U64 strings;
+   U64 groups;
+   U64 ctrl_offset;
+   U64 slots_offset;
+   U64 strings_offset;
+   U64 data_offset;
+   U64 data_size;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+struct StringInternerSnapshot::slot {
+   U64 hash;
+   U64 offset;
+   U32 size;
+   U32 id;
+};
+
+///////////////////////////////////////////////////////////////////////////////
+struct StringInternerSnapshot::string_ref {
+   U64 offset;
+   U64 size;
+};
+
+namespace {
+
+constexpr char snapshot_magic[8] = { 'b', 'e', 'S', 'I', 'n', 't', 'r', 'n' };
+constexpr U32 snapshot_version = 1;
+constexpr U32 snapshot_byte_order = 0x01020304;
+
+///////////////////////////////////////////////////////////////////////////////
+bool snapshot_section_valid(U64 offset, U64 count, std::size_t element_size, std::size_t size) noexcept {
+   return offset % alignof(U64) == 0 &&
+      offset <= size &&
+      count <= (size - offset) / element_size;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+[[noreturn]] void throw_invalid_snapshot(const char* reason) {
+   throw RecoverableTrace(std::make_error_code(std::errc::invalid_argument), S("Invalid StringInterner snapshot: ") + reason);
+}
+
+} // be::util::detail::()
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Validates a snapshot image and prepares to use it in place.
+///
+/// \details The image must be aligned to 8 bytes and must remain valid for
+///         as long as the StringInternerSnapshot (or anything that uses it)
+///         exists.  Section bounds are checked here; the slots themselves are
+///         bounds-checked lazily as they are probed, so that loading doesn't
+///         need to touch the whole image.
+StringInternerSnapshot::StringInternerSnapshot(const UC* data, std::size_t size) {
+   if (size < sizeof(header) || reinterpret_cast<std::uintptr_t>(data) % alignof(U64) != 0) {
+      throw_invalid_snapshot("truncated or misaligned");
+   }
+
+   const header& h = *reinterpret_cast<const header*>(data);
+   if (std::memcmp(h.magic, snapshot_magic, sizeof(snapshot_magic)) != 0) {
+      throw_invalid_snapshot("bad signature");
+   }
+   if (h.version != snapshot_version) {
+      throw_invalid_snapshot("unsupported version");
+   }
+   if (h.byte_order != snapshot_byte_order) {
+      throw_invalid_snapshot("byte order mismatch");
+   }
+   if (h.groups == 0 || (h.groups & (h.groups - 1)) != 0 || h.groups > size / StringInternerTable::group_size) {
+      throw_invalid_snapshot("bad table size");
+   }
+
+   const U64 slot_count = h.groups * StringInternerTable::group_size;
+   if (h.strings > std::numeric_limits<U32>::max() || h.strings >= slot_count) {
+      throw_invalid_snapshot("bad string count");
+   }
+   if (!snapshot_section_valid(h.ctrl_offset, slot_count, 1, size) ||
+       !snapshot_section_valid(h.slots_offset, slot_count, sizeof(slot), size) ||
+       !snapshot_section_valid(h.strings_offset, h.strings, sizeof(string_ref), size) ||
+       !snapshot_section_valid(h.data_offset, h.data_size, 1, size)) {
+      throw_invalid_snapshot("section out of bounds");
+   }
+
+   ctrl_ = data + h.ctrl_offset;
+   slots_ = reinterpret_cast<const slot*>(data + h.slots_offset);
+   strings_ = reinterpret_cast<const string_ref*>(data + h.strings_offset);
+   data_ = reinterpret_cast<const char*>(data + h.data_offset);
+   data_size_ = std::size_t(h.data_size);
+   groups_ = std::size_t(h.groups);
+   size_ = std::size_t(h.strings);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a snapshot image containing the given strings, with each
+///         string's index in the vector as its ID.  Strings must be unique.
+Buf<UC> StringInternerSnapshot::write(const std::vector<be::SV>& strings) {
+   const std::size_t groups = groups_for(strings.size());
+   const std::size_t slot_count = groups * StringInternerTable::group_size;
+
+   std::size_t data_size = 0;
+   for (be::SV str : strings) {
+      data_size += str.size();
+   }
+
+   header h = { };
+   std::memcpy(h.magic, snapshot_magic, sizeof(snapshot_magic));
+   h.version = snapshot_version;
+   h.byte_order = snapshot_byte_order;
+   h.strings = strings.size();
+   h.groups = groups;
+   h.ctrl_offset = sizeof(header);
+   h.slots_offset = h.ctrl_offset + slot_count;
+   h.strings_offset = h.slots_offset + slot_count * sizeof(slot);
+   h.data_offset = h.strings_offset + strings.size() * sizeof(string_ref);
+   h.data_size = data_size;
+
+   Buf<UC> buf = make_buf<UC>(std::size_t(h.data_offset + data_size));
+   std::memset(buf.get(), 0, std::size_t(h.data_offset));
+   std::memcpy(buf.get(), &h, sizeof(header));
+
+   U8* ctrl = buf.get() + h.ctrl_offset;
+   slot* slots = reinterpret_cast<slot*>(buf.get() + h.slots_offset);
+   string_ref* refs = reinterpret_cast<string_ref*>(buf.get() + h.strings_offset);
+   char* data = reinterpret_cast<char*>(buf.get() + h.data_offset);
+   std::memset(ctrl, ctrl_empty, slot_count);
+
+   U64 offset = 0;
+   for (std::size_t id = 0; id < strings.size(); ++id) {
+      const be::SV str = strings[id];
+      const U64 hash = StringInternerTable::hash(str);
+      slot& sl = slots[claim_slot(ctrl, groups, hash)];
+      sl.hash = hash;
+      sl.offset = offset;
+      sl.size = U32(str.size());
+      sl.id = U32(id);
+      refs[id].offset = offset;
+      refs[id].size = str.size();
+      if (!str.empty()) {
+         std::memcpy(data + offset, str.data(), str.size());
+      }
+      offset += str.size();
+   }
+
+   return buf;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t StringInternerSnapshot::size() const noexcept {
+   return size_;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+bool StringInternerSnapshot::find(be::SV str, U64 hash, be::SV& result, U32& id) const noexcept {
+   const std::size_t index = find_slot(ctrl_, groups_, hash, [&](std::size_t i) {
+         const slot& sl = slots_[i];
+         if (sl.hash != hash || sl.size != str.size() || sl.id >= size_) {
+            return false;
+         }
+         be::SV view = view_(sl.offset, sl.size);
+         return view.data() && (view.empty() || std::memcmp(view.data(), str.data(), view.size()) == 0);
+      });
+
+   if (index == no_slot) {
+      return false;
+   }
+   result = view_(slots_[index].offset, slots_[index].size);
+   id = slots_[index].id;
+   return true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+be::SV StringInternerSnapshot::lookup(U32 id) const noexcept {
+   assert(id < size_);
+   return view_(strings_[id].offset, strings_[id].size);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns a view of part of the data section, or a null view if
+///         the range is out of bounds.
+be::SV StringInternerSnapshot::view_(U64 offset, U64 size) const noexcept {
+   if (offset > data_size_ || size > data_size_ - offset) {
+      return be::SV();
+   }
+   return be::SV(data_ + offset, std::size_t(size));
+}
+
+} // be::util::detail
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Creates a StringInterner which uses a snapshot image (created by
+///         snapshot()) as its initial set of strings, without copying it.
+///
+/// \details The image must be aligned to 8 bytes.  It may be read-only; new
+///         strings are interned into separate storage.  Views of strings in
+///         the snapshot point into the image, which the StringInterner keeps
+///         ownership of until it is destroyed.
+///
+/// \throws RecoverableTrace if the image is invalid or was created on a
+///         platform with a different byte order.
+StringInterner::StringInterner(Buf<const UC> snapshot)
+   : snapshot_buf_(std::move(snapshot)),
+     snapshot_(snapshot_buf_.get(), snapshot_buf_.size())
+{ }
 
 ///////////////////////////////////////////////////////////////////////////////
+/// \brief  Sets a function which determines the size of new segments, given
+///         the size of a string which doesn't fit in the current segment.
+///
+/// \details Segments are always at least large enough to hold the string.
+///         If there is no policy, or it returns 0, each new segment is as
+///         large as all previous segments combined, up to 1 MiB.
 void StringInterner::provisioning_policy(std::function<std::size_t(std::size_t)> func) {
    policy_ = std::move(func);
 }
 
 ///////////////////////////////////////////////////////////////////////////////
+/// \brief  Ensures that at least bytes of string data can be interned
+///         without allocating a new segment.
 void StringInterner::reserve(std::size_t bytes) {
-   reserve_(bytes);
+   arena_.reserve(bytes);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Ensures that at least count distinct strings can be interned
+///         without growing the lookup table.
+void StringInterner::reserve_strings(std::size_t count) {
+   table_.reserve(count);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the number of distinct strings which have been interned.
+std::size_t StringInterner::size() const noexcept {
+   return snapshot_.size() + table_.size();
+}
+
+///////////////////////////////////////////////////////////////////////////////
+StringInternerStats StringInterner::stats() const noexcept {
+   StringInternerStats result;
+   result.strings = size();
+   result.segments = arena_.segment_count();
+   result.bytes_reserved = arena_.bytes_reserved();
+   result.bytes_used = arena_.bytes_used();
+   result.bytes_wasted = arena_.bytes_wasted();
+   return result;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 be::SV StringInterner::operator()(be::SV str) {
-   auto it = set_.find(str);
-   if (it == set_.end()) {
-      std::size_t reserve_amount = str.length();
-      if (policy_) {
-         reserve_amount = be::max(reserve_amount, policy_(reserve_amount));
-      }
-      segment& seg = reserve_(reserve_amount);
-      char* start = seg.data.get() + seg.size - seg.free;
-      std::memcpy(start, str.data(), str.length());
-      seg.free -= str.length();
-      be::SV value = be::SV(start, str.length());
-      set_.insert(value);
-      return value;
+   return intern_(str).str;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Interns a string and returns its ID.
+InternedId StringInterner::id(be::SV str) {
+   return InternedId(intern_(str).id);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Retrieves the ID of a string without interning it.
+///
+/// \returns false if the string has not been interned.
+bool StringInterner::find_id(be::SV str, InternedId& id) const noexcept {
+   const U64 hash = detail::StringInternerTable::hash(str);
+   be::SV found;
+   U32 found_id;
+   if (snapshot_.find(str, hash, found, found_id)) {
+      id = InternedId(found_id);
+      return true;
    }
-   return *it;
+
+   const detail::StringInternerTable::entry* e = table_.find(str, hash);
+   if (e) {
+      id = InternedId(e->id);
+      return true;
+   }
+   return false;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-StringInterner::segment& StringInterner::reserve_(std::size_t bytes) {
-   for (auto& seg : segments_) {
-      if (seg.free >= bytes) {
-         return seg;
-      }
+/// \brief  Returns the interned string corresponding to an ID.  The ID must
+///         have come from this StringInterner.
+be::SV StringInterner::lookup(InternedId id) const noexcept {
+   std::size_t index = std::size_t(id);
+   if (index < snapshot_.size()) {
+      return snapshot_.lookup(U32(index));
+   }
+   index -= snapshot_.size();
+   assert(index < strings_.size());
+   return strings_[index];
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Serializes all interned strings (including any from the snapshot
+///         this StringInterner was created from) into a position-independent
+///         image which can be saved and passed to the
+///         StringInterner(Buf<const UC>) constructor later.  IDs are
+///         preserved.
+Buf<UC> StringInterner::snapshot() const {
+   std::vector<be::SV> strings;
+   strings.reserve(size());
+   for (std::size_t i = 0; i < snapshot_.size(); ++i) {
+      strings.push_back(snapshot_.lookup(U32(i)));
    }
-   segments_.push_back(segment { bytes, bytes, std::make_unique<char[]>(bytes) });
-   return segments_.back();
+   strings.insert(strings.end(), strings_.begin(), strings_.end());
+   return detail::StringInternerSnapshot::write(strings);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+StringInterner::interned StringInterner::intern_(be::SV str) {
+   const U64 hash = detail::StringInternerTable::hash(str);
+   interned result;
+   if (snapshot_.find(str, hash, result.str, result.id)) {
+      return result;
+   }
+
+   const detail::StringInternerTable::entry* existing = table_.find(str, hash);
+   if (existing) {
+      return interned { be::SV(existing->data, existing->size), existing->id };
+   }
+
+   if (str.size() > std::numeric_limits<U32>::max()) {
+      throw std::length_error("String too long to intern");
+   }
+   if (size() >= std::numeric_limits<U32>::max()) {
+      throw std::length_error("Too many interned strings");
+   }
+
+   table_.reserve(table_.size() + 1);
+   std::size_t segment_size = 0;
+   if (policy_ && str.size() > arena_.available()) {
+      segment_size = policy_(str.size());
+   }
+   char* data = arena_.allocate(str.size(), segment_size);
+   if (!str.empty()) {
+      std::memcpy(data, str.data(), str.size());
+   }
+
+   result.str = be::SV(data, str.size());
+   result.id = U32(size());
+   strings_.push_back(result.str);
+   table_.insert(result.str, hash, result.id);
+   return result;
 }
 
 } // be::util
@@ -0,0 +1,293 @@
+#include "pch.hpp"
+#include "block_pool.hpp"
+#include <be/core/native.hpp>
+#include <algorithm>
+#include <cassert>
+
+#ifndef BE_NATIVE_VC_WIN
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/mman.h>
+#endif
+#endif
+
+namespace be::util::detail {
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+constexpr std::size_t default_slab_size = 2 * 1024 * 1024;
+constexpr std::size_t magazine_bytes = 8192;
+
+///////////////////////////////////////////////////////////////////////////////
+/// The free magazine stack head packs a pointer into the low 48 bits and an
+/// ABA tag into the high 16 bits.  User-space addresses on all supported
+/// 64-bit platforms fit in 48 bits.
+constexpr U64 pointer_mask = (U64(1) << 48) - 1;
+constexpr U64 tag_increment = U64(1) << 48;
+
+static_assert(sizeof(void*) <= sizeof(U64), "Pointers must fit in 64 bits");
+
+///////////////////////////////////////////////////////////////////////////////
+BlockPoolState::Block* unpack(U64 head) noexcept {
+   return reinterpret_cast<BlockPoolState::Block*>(static_cast<std::uintptr_t>(head & pointer_mask));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+U64 pack(BlockPoolState::Block* ptr, U64 old_head) noexcept {
+   U64 addr = static_cast<U64>(reinterpret_cast<std::uintptr_t>(ptr));
+   assert((addr & ~pointer_mask) == 0);
+   return ((old_head & ~pointer_mask) + tag_increment) | addr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+std::size_t round_up(std::size_t value, std::size_t multiple) noexcept {
+   return (value + multiple - 1) / multiple * multiple;
+}
+
+} // be::util::detail::()
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns any blocks cached by an exiting thread to the shared free
+///         list, and stops the thread from caching any more.
+BlockPoolState::ThreadCacheGuard::~ThreadCacheGuard() {
+   cache.state->flush(cache);
+   cache.disabled = true;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+BlockPoolState::BlockPoolState(std::size_t block_size, std::size_t block_align) noexcept
+   : block_size_(round_up(std::max(block_size, sizeof(Block)), std::max(block_align, alignof(Block)))),
+     block_align_(std::max(block_align, alignof(Block))),
+     magazine_size_(std::min(std::max(magazine_bytes / block_size_, std::size_t(16)), std::size_t(256))),
+     free_magazines_(0),
+     slab_cursor_(nullptr),
+     slab_end_(nullptr),
+     slabs_(0),
+     huge_page_slabs_(0),
+     slab_bytes_(0),
+     blocks_carved_(0)
+{
+   assert((block_align_ & (block_align_ - 1)) == 0);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void BlockPoolState::init(ThreadCache& cache) noexcept {
+   cache.state = this;
+   cache.head = nullptr;
+   cache.count = 0;
+   cache.limit = magazine_size_;
+   cache.spare = nullptr;
+   cache.initialized = true;
+   cache.disabled = false;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Called when a thread's current magazine is empty.  Replaces it
+///         with the spare magazine, or one from the shared free list, and
+///         returns one block from it.
+void* BlockPoolState::refill(ThreadCache& cache) {
+   assert(!cache.head);
+
+   Block* magazine = cache.spare;
+   if (magazine) {
+      cache.spare = nullptr;
+      magazine->count = magazine_size_;
+   } else {
+      magazine = pop_magazine_();
+      if (!magazine) {
+         magazine = carve_magazine_();
+      }
+   }
+
+   cache.head = magazine->next;
+   cache.count = magazine->count - 1;
+   return magazine;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Called when a thread's current magazine is full.  Pushes the
+///         spare magazine (if any) to the shared free list and makes the
+///         current magazine the spare.
+void BlockPoolState::drain(ThreadCache& cache) noexcept {
+   assert(cache.count == magazine_size_);
+
+   if (cache.spare) {
+      cache.spare->count = magazine_size_;
+      push_magazine_(cache.spare);
+   }
+
+   cache.spare = cache.head;
+   cache.head = nullptr;
+   cache.count = 0;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Moves all blocks in a thread's cache to the shared free list.
+void BlockPoolState::flush(ThreadCache& cache) noexcept {
+   if (cache.head) {
+      cache.head->count = cache.count;
+      push_magazine_(cache.head);
+      cache.head = nullptr;
+      cache.count = 0;
+   }
+
+   if (cache.spare) {
+      cache.spare->count = magazine_size_;
+      push_magazine_(cache.spare);
+      cache.spare = nullptr;
+   }
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Allocates a block for a thread whose cache has been destroyed,
+///         returning the rest of the magazine it came from to the shared
+///         free list.
+void* BlockPoolState::allocate_uncached() {
+   ThreadCache cache;
+   init(cache);
+   void* block = refill(cache);
+   flush(cache);
+   return block;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Frees a block for a thread whose cache has been destroyed, by
+///         pushing it to the shared free list as a magazine of one block.
+void BlockPoolState::deallocate_uncached(void* ptr) noexcept {
+   Block* block = static_cast<Block*>(ptr);
+   block->next = nullptr;
+   block->count = 1;
+   push_magazine_(block);
+}
+
+///////////////////////////////////////////////////////////////////////////////
+BlockPoolStats BlockPoolState::stats() const {
+   BlockPoolStats stats;
+   stats.block_size = block_size_;
+   stats.blocks_per_magazine = magazine_size_;
+
+   std::lock_guard<std::mutex> lock(mutex_);
+   stats.slabs = slabs_;
+   stats.huge_page_slabs = huge_page_slabs_;
+   stats.slab_bytes = slab_bytes_;
+   stats.blocks_carved = blocks_carved_;
+   return stats;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+void BlockPoolState::push_magazine_(Block* magazine) noexcept {
+   U64 head = free_magazines_.load(std::memory_order_relaxed);
+   U64 new_head;
+   do {
+      magazine->next_magazine = unpack(head);
+      new_head = pack(magazine, head);
+   } while (!free_magazines_.compare_exchange_weak(head, new_head, std::memory_order_release, std::memory_order_relaxed));
+}
+
+///////////////////////////////////////////////////////////////////////////////
+/// \details Reading next_magazine from a magazine which another thread has
+///         already popped (and possibly begun using) may produce a garbage
+///         value, but slabs are never unmapped so the read itself is safe,
+///         and the tag ensures the compare-exchange fails in that case.
+BlockPoolState::Block* BlockPoolState::pop_magazine_() noexcept {
+   U64 head = free_magazines_.load(std::memory_order_acquire);
+   while (Block* magazine = unpack(head)) {
+      Block* next = magazine->next_magazine;
+      if (free_magazines_.compare_exchange_weak(head, pack(next, head), std::memory_order_acquire, std::memory_order_acquire)) {
+         return magazine;
+      }
+   }
+   return nullptr;
+}
+
+///////////////////////////////////////////////////////////////////////////////
+BlockPoolState::Block* BlockPoolState::carve_magazine_() {
+   const std::size_t bytes = magazine_size_ * block_size_;
+
+   std::lock_guard<std::mutex> lock(mutex_);
+
+   if (std::size_t(slab_end_ - slab_cursor_) < bytes) {
+      // any remaining space at the end of the current slab is abandoned
+      std::size_t slab_size = round_up(std::max(bytes, default_slab_size), default_slab_size);
+      bool huge_pages = false;
+      UC* slab = static_cast<UC*>(allocate_slab(slab_size, huge_pages));
+      if (!slab) {
+         throw std::bad_alloc();
+      }
+
+      assert(reinterpret_cast<std::uintptr_t>(slab) % block_align_ == 0);
+
+      slab_cursor_ = slab;
+      slab_end_ = slab + slab_size;
+      ++slabs_;
+      slab_bytes_ += slab_size;
+      if (huge_pages) {
+         ++huge_page_slabs_;
+      }
+   }
+
+   Block* magazine = reinterpret_cast<Block*>(slab_cursor_);
+   Block* block = magazine;
+   for (std::size_t i = 1; i < magazine_size_; ++i) {
+      Block* next = reinterpret_cast<Block*>(slab_cursor_ + i * block_size_);
+      block->next = next;
+      block = next;
+   }
+   block->next = nullptr;
+   magazine->count = magazine_size_;
+
+   slab_cursor_ += bytes;
+   blocks_carved_ += magazine_size_;
+   return magazine;
+}
+
+#ifndef BE_NATIVE_VC_WIN
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Allocates a slab of memory directly from the OS.
+///
+/// \details Explicit huge pages (MAP_HUGETLB) are tried first.  If none are
+///         available, regular pages are mapped at a huge page boundary and
+///         transparent huge pages are requested with madvise.  Slabs are
+///         never freed.
+void* allocate_slab(std::size_t size, bool& huge_pages) noexcept {
+   huge_pages = false;
+
+#if defined(__unix__) || defined(__APPLE__)
+#ifdef MAP_HUGETLB
+   void* ptr = ::mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+   if (ptr != MAP_FAILED) {
+      huge_pages = true;
+      return ptr;
+   }
+#endif
+
+   std::size_t mapped_size = size + default_slab_size;
+   void* mapped = ::mmap(nullptr, mapped_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+   if (mapped == MAP_FAILED) {
+      return nullptr;
+   }
+
+   UC* first = static_cast<UC*>(mapped);
+   UC* aligned = first + (round_up(reinterpret_cast<std::uintptr_t>(first), default_slab_size) - reinterpret_cast<std::uintptr_t>(first));
+   UC* last = first + mapped_size;
+
+   if (aligned > first) {
+      ::munmap(first, std::size_t(aligned - first));
+   }
+   if (last > aligned + size) {
+      ::munmap(aligned + size, std::size_t(last - (aligned + size)));
+   }
+
+#ifdef MADV_HUGEPAGE
+   ::madvise(aligned, size, MADV_HUGEPAGE);
+#endif
+
+   return aligned;
+#else
+   return ::operator new(size, std::align_val_t(4096), std::nothrow);
+#endif
+}
+
+#endif
+
+} // be::util::detail
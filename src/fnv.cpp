@@ -1,150 +1,156 @@
 #include "pch.hpp"
 #include "fnv.hpp"
-#include <cassert>
-#include <sstream>
-#include <iomanip>
+
+#ifdef _MSC_VER
+#  include <intrin.h>
+#endif
 
 namespace be::util {
 namespace {
 
 ///////////////////////////////////////////////////////////////////////////////
 struct U256 {
-   U32 d[8];    // Big-endian - d[0] is most significant
+   U64 d[4];    // Little-endian - d[0] is least significant
 };
 
-///////////////////////////////////////////////////////////////////////////////
-void shift_left(U256& n, const int bits) {
-   assert(bits <= 32);
-   const int ibits = 32 - bits;
+constexpr U256 fnv256_basis = { {
+      0x1023b4c8caee0535ull, 0xc8b1536847b6bbb3ull,
+      0x2d98c384c4e576ccull, 0xdd268dbcaac55036ull
+   } };
 
-   for (int i = 0; i < 7; ++i) {
-      n.d[i] <<= bits;
-      n.d[i] |= n.d[i + 1] >> ibits;
-   }
-   n.d[7] <<= bits;
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Returns the low 64 bits of a * b and stores the high 64 bits in
+///         hi.
+U64 multiply(U64 a, U64 b, U64& hi) noexcept {
+#if defined(__SIZEOF_INT128__)
+   unsigned __int128 product = (unsigned __int128)a * b;
+   hi = U64(product >> 64);
+   return U64(product);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_ARM64))
+#  ifdef _M_ARM64
+   hi = __umulh(a, b);
+   return a * b;
+#  else
+   return _umul128(a, b, &hi);
+#  endif
+#else
+   const U64 a_lo = a & 0xFFFFFFFFu, a_hi = a >> 32;
+   const U64 b_lo = b & 0xFFFFFFFFu, b_hi = b >> 32;
+   const U64 lo_lo = a_lo * b_lo;
+   const U64 hi_lo = a_hi * b_lo;
+   const U64 lo_hi = a_lo * b_hi;
+   const U64 cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+   hi = a_hi * b_hi + (hi_lo >> 32) + (cross >> 32);
+   return (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+#endif
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-void shift_left_160(U256& n) {
-   n.d[0] = n.d[5];
-   n.d[1] = n.d[6];
-   n.d[2] = n.d[7];
-   n.d[3] = 0;
-   n.d[4] = 0;
-   n.d[5] = 0;
-   n.d[6] = 0;
-   n.d[7] = 0;
+/// \brief  Multiplies n by the FNV-256 prime, 2^168 + 0x163, modulo 2^256.
+void multiply_prime(U256& n) noexcept {
+   constexpr U64 low_prime = 0x163;
+
+   U64 hi;
+   U64 carry;
+   const U64 r0 = multiply(n.d[0], low_prime, carry);
+   U64 r1 = multiply(n.d[1], low_prime, hi);
+   r1 += carry;
+   carry = hi + (r1 < carry);
+   U64 r2 = multiply(n.d[2], low_prime, hi);
+   r2 += carry;
+   carry = hi + (r2 < carry);
+   U64 r3 = n.d[3] * low_prime + carry;
+
+   // add n << 168
+   const U64 s2 = n.d[0] << 40;
+   const U64 s3 = (n.d[1] << 40) | (n.d[0] >> 24);
+   r2 += s2;
+   r3 += s3 + (r2 < s2);
+
+   n.d[0] = r0;
+   n.d[1] = r1;
+   n.d[2] = r2;
+   n.d[3] = r3;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-U32 accumulate(U256& a, const U256& b) {
-   U64 c = 0;
-   for (int i = 7; i >= 0; --i)
-   {
-      U64 nd = c + a.d[i] + b.d[i];
-      a.d[i] = (U32)nd;
-      c = nd >> 32;
+Fnv256Digest to_digest(const U256& n) noexcept {
+   Fnv256Digest digest;
+   for (std::size_t i = 0; i < 4; ++i) {
+      const U64 limb = n.d[3 - i];
+      for (std::size_t b = 0; b < 8; ++b) {
+         digest[i * 8 + b] = UC(limb >> (56 - b * 8));
+      }
    }
-   return (U32)c;
+   return digest;
 }
 
 ///////////////////////////////////////////////////////////////////////////////
-S u256_tostring(const U256& n) {
-   std::ostringstream oss;
-   oss << std::hex << std::setfill('0');
-
-   for (int i = 0; i < 8; ++i)
-      oss << std::setw(8) << n.d[i];
-
-   return oss.str();
+S to_hex_string(const Fnv256Digest& digest) {
+   char hex[64];
+   fnv256_hex(digest, hex);
+   return S(hex, sizeof(hex));
 }
 
 } // be::util::()
 
 ///////////////////////////////////////////////////////////////////////////////
-S fnv256_0(SV input) {
+Fnv256Digest fnv256_0_digest(SV input) noexcept {
    U256 hash = { { } };
-   for (auto i(input.begin()), end(input.end()); i != end; ++i) {
-      U256 t = hash;
-      shift_left(t, 1);
-      accumulate(hash, t);
-
-      shift_left(t, 4);
-      accumulate(hash, t);
-
-      shift_left(t, 1);
-      accumulate(hash, t);
+   for (char c : input) {
+      multiply_prime(hash);
+      hash.d[0] ^= U8(c);
+   }
+   return to_digest(hash);
+}
 
-      shift_left(t, 2);
-      accumulate(hash, t);
+///////////////////////////////////////////////////////////////////////////////
+Fnv256Digest fnv256_1_digest(SV input) noexcept {
+   U256 hash = fnv256_basis;
+   for (char c : input) {
+      multiply_prime(hash);
+      hash.d[0] ^= U8(c);
+   }
+   return to_digest(hash);
+}
 
-      shift_left_160(t);
-      accumulate(hash, t);
+///////////////////////////////////////////////////////////////////////////////
+Fnv256Digest fnv256_1a_digest(SV input) noexcept {
+   U256 hash = fnv256_basis;
+   for (char c : input) {
+      hash.d[0] ^= U8(c);
+      multiply_prime(hash);
+   }
+   return to_digest(hash);
+}
 
-      hash.d[7] ^= (U8)*i;
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Writes a digest as 64 lowercase hex digits, without a null
+///         terminator.
+///
+/// \returns A pointer to the character after the last digit written.
+char* fnv256_hex(const Fnv256Digest& digest, char* out) noexcept {
+   const char* symbols = "0123456789abcdef";
+   for (UC c : digest) {
+      *out++ = symbols[c >> 4];
+      *out++ = symbols[c & 0xF];
    }
+   return out;
+}
 
-   return u256_tostring(hash);
+///////////////////////////////////////////////////////////////////////////////
+S fnv256_0(SV input) {
+   return to_hex_string(fnv256_0_digest(input));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 S fnv256_1(SV input) {
-   U256 hash = { {
-         0xdd268dbcu, 0xaac55036u, 0x2d98c384u, 0xc4e576ccu,
-         0xc8b15368u, 0x47b6bbb3u, 0x1023b4c8u, 0xcaee0535u
-      } };
-
-   for (auto i(input.begin()), end(input.end()); i != end; ++i) {
-      U256 t = hash;
-      shift_left(t, 1);
-      accumulate(hash, t);
-
-      shift_left(t, 4);
-      accumulate(hash, t);
-
-      shift_left(t, 1);
-      accumulate(hash, t);
-
-      shift_left(t, 2);
-      accumulate(hash, t);
-
-      shift_left_160(t);
-      accumulate(hash, t);
-
-      hash.d[7] ^= (U8)*i;
-   }
-
-   return u256_tostring(hash);
+   return to_hex_string(fnv256_1_digest(input));
 }
 
 ///////////////////////////////////////////////////////////////////////////////
 S fnv256_1a(SV input) {
-   U256 hash = { {
-         0xdd268dbcu, 0xaac55036u, 0x2d98c384u, 0xc4e576ccu,
-         0xc8b15368u, 0x47b6bbb3u, 0x1023b4c8u, 0xcaee0535u
-      } };
-
-   for (auto i(input.begin()), end(input.end()); i != end; ++i) {
-      hash.d[7] ^= (U8)*i;
-
-      U256 t = hash;
-      shift_left(t, 1);
-      accumulate(hash, t);
-
-      shift_left(t, 4);
-      accumulate(hash, t);
-
-      shift_left(t, 1);
-      accumulate(hash, t);
-
-      shift_left(t, 2);
-      accumulate(hash, t);
-
-      shift_left_160(t);
-      accumulate(hash, t);
-   }
-
-   return u256_tostring(hash);
+   return to_hex_string(fnv256_1a_digest(input));
 }
 
 } // be::util
@@ -0,0 +1,31 @@
+#include <be/core/native.hpp>
+#ifdef BE_NATIVE_VC_WIN
+
+#include "block_pool.hpp"
+#include BE_NATIVE_CORE(vc_win_win32.hpp)
+
+namespace be::util::detail {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Allocates a slab of memory directly from the OS.
+///
+/// \details Large pages are used if the slab size is a multiple of the large
+///         page size and the process holds SeLockMemoryPrivilege; otherwise
+///         regular pages are used.  Slabs are never freed.
+void* allocate_slab(std::size_t size, bool& huge_pages) noexcept {
+   ::SIZE_T large_page_size = ::GetLargePageMinimum();
+   if (large_page_size > 0 && size % large_page_size == 0) {
+      void* ptr = ::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT | MEM_LARGE_PAGES, PAGE_READWRITE);
+      if (ptr) {
+         huge_pages = true;
+         return ptr;
+      }
+   }
+
+   huge_pages = false;
+   return ::VirtualAlloc(nullptr, size, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+}
+
+} // be::util::detail
+
+#endif
@@ -0,0 +1,182 @@
+#ifdef BE_TEST
+
+#include <catch/catch.hpp>
+#include <algorithm>
+#include <cstring>
+#include <set>
+#include <thread>
+#include <vector>
+#include "block_pool.hpp"
+#include "chunked_list.hpp"
+
+#define BE_CATCH_TAGS "[util][util:BlockPool]"
+
+using namespace be;
+
+TEST_CASE("util::BlockPool", BE_CATCH_TAGS) {
+   using pool = util::BlockPool<48, 16>;
+
+   std::vector<void*> blocks;
+   for (int i = 0; i < 1000; ++i) {
+      void* ptr = pool::allocate();
+      REQUIRE(ptr);
+      REQUIRE(reinterpret_cast<std::uintptr_t>(ptr) % 16 == 0);
+      std::memset(ptr, 0xCD, 48);
+      blocks.push_back(ptr);
+   }
+
+   REQUIRE(std::set<void*>(blocks.begin(), blocks.end()).size() == blocks.size());
+
+   util::BlockPoolStats stats = pool::stats();
+   REQUIRE(stats.block_size == 48);
+   REQUIRE(stats.slabs >= 1);
+   REQUIRE(stats.blocks_carved >= 1000);
+
+   SECTION("freed blocks are reused") {
+      std::size_t carved = pool::stats().blocks_carved;
+      for (void* ptr : blocks) {
+         pool::deallocate(ptr);
+      }
+      for (int i = 0; i < 1000; ++i) {
+         blocks[i] = pool::allocate();
+      }
+      REQUIRE(pool::stats().blocks_carved == carved);
+   }
+
+   SECTION("blocks can be freed by another thread") {
+      std::thread t([&]() {
+         for (void* ptr : blocks) {
+            pool::deallocate(ptr);
+         }
+      });
+      t.join();
+
+      // the other thread's cache was flushed when it exited
+      std::size_t carved = pool::stats().blocks_carved;
+      std::vector<void*> reused;
+      for (int i = 0; i < 1000; ++i) {
+         reused.push_back(pool::allocate());
+      }
+      REQUIRE(pool::stats().blocks_carved == carved);
+      blocks = reused;
+   }
+
+   for (void* ptr : blocks) {
+      pool::deallocate(ptr);
+   }
+}
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+template <typename Pool>
+struct FreeOnThreadExit {
+   ~FreeOnThreadExit() {
+      Pool::deallocate(ptr);
+   }
+
+   void* ptr = nullptr;
+};
+
+} // ()
+
+TEST_CASE("util::BlockPool after thread cache destruction", BE_CATCH_TAGS) {
+   using pool = util::BlockPool<200>;
+   void* freed = nullptr;
+
+   std::thread t([&]() {
+      // constructed before the thread's cache, so destroyed after it
+      thread_local FreeOnThreadExit<pool> holder;
+      holder.ptr = pool::allocate();
+      freed = holder.ptr;
+   });
+   t.join();
+
+   // the block went straight to the shared free list, after the rest of the
+   // other thread's cache
+   void* ptr = pool::allocate();
+   REQUIRE(ptr == freed);
+   pool::deallocate(ptr);
+}
+
+TEST_CASE("util::BlockPool concurrent use", BE_CATCH_TAGS) {
+   using pool = util::BlockPool<64, 64>;
+   constexpr int n_threads = 4;
+   constexpr int n_blocks = 5000;
+
+   std::vector<std::vector<void*>> allocated(n_threads);
+   std::vector<std::thread> threads;
+   for (int t = 0; t < n_threads; ++t) {
+      threads.emplace_back([&allocated, t]() {
+         auto& mine = allocated[t];
+         for (int round = 0; round < 4; ++round) {
+            for (int i = 0; i < n_blocks; ++i) {
+               U64* ptr = static_cast<U64*>(pool::allocate());
+               *ptr = U64(t);
+               mine.push_back(ptr);
+            }
+            std::vector<void*> kept;
+            for (std::size_t i = 0; i < mine.size(); ++i) {
+               if (i % 2 == 0) {
+                  pool::deallocate(mine[i]);
+               } else {
+                  kept.push_back(mine[i]);
+               }
+            }
+            mine.swap(kept);
+         }
+      });
+   }
+   for (auto& t : threads) {
+      t.join();
+   }
+
+   std::set<void*> unique;
+   for (int t = 0; t < n_threads; ++t) {
+      for (void* ptr : allocated[t]) {
+         REQUIRE(*static_cast<U64*>(ptr) == U64(t));
+         unique.insert(ptr);
+      }
+   }
+
+   std::size_t total = 0;
+   for (auto& a : allocated) {
+      total += a.size();
+   }
+   REQUIRE(unique.size() == total);
+
+   // free everything from a single thread
+   for (auto& a : allocated) {
+      for (void* ptr : a) {
+         pool::deallocate(ptr);
+      }
+   }
+}
+
+TEST_CASE("util::PoolAllocator", BE_CATCH_TAGS) {
+   util::PoolAllocator<int> alloc;
+   util::PoolAllocator<double> other(alloc);
+   REQUIRE(alloc == other);
+
+   int* single = alloc.allocate(1);
+   *single = 7;
+   int* array = alloc.allocate(100);
+   std::fill(array, array + 100, 3);
+   alloc.deallocate(array, 100);
+   alloc.deallocate(single, 1);
+
+   util::ChunkedList<int, util::PoolAllocator<int>, 8, 3, 2> con;
+   for (int i = 0; i < 500; ++i) {
+      con.push_back(i);
+   }
+   con.erase(con.begin() + 100, con.begin() + 400);
+   REQUIRE(con.size() == 200);
+   REQUIRE(con[99] == 99);
+   REQUIRE(con[100] == 400);
+
+   util::ChunkedList<int, util::PoolAllocator<int>, 8, 3, 2> moved(std::move(con));
+   REQUIRE(moved.size() == 200);
+   REQUIRE(con.empty());
+}
+
+#endif
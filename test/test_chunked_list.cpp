@@ -4,7 +4,12 @@
 #include <functional>
 #include <sstream>
 #include <iterator>
+#include <list>
 #include "chunked_list.hpp"
+#include "chunked_list_algorithms.hpp"
+#include <numeric>
+#include <random>
+#include <string>
 
 #define BE_CATCH_TAGS "[util][util:ChunkedList]"
 
@@ -1110,4 +1115,443 @@ TEST_CASE("util::ChunkedList emplace_back()", BE_CATCH_TAGS) {
    REQUIRE(*con[4] == 5);
 }
 
+TEST_CASE("util::ChunkedList with node index", BE_CATCH_TAGS) {
+   using con_type = be::util::ChunkedList<int, std::allocator<int>, 4, 3, 1, true>;
+   REQUIRE(con_type::indexed);
+
+   con_type con;
+   std::vector<int> ref;
+
+   auto check = [&]() {
+      REQUIRE(con.size() == ref.size());
+      for (std::size_t i = 0; i < ref.size(); ++i) {
+         REQUIRE(con[i] == ref[i]);
+         REQUIRE(con.at(i) == ref[i]);
+      }
+      REQUIRE(std::equal(con.begin(), con.end(), ref.begin(), ref.end()));
+   };
+
+   for (int i = 0; i < 100; ++i) {
+      con.push_back(i);
+      ref.push_back(i);
+   }
+   check();
+
+   SECTION("pop_back() releases nodes across metanode boundaries") {
+      for (int i = 0; i < 70; ++i) {
+         con.pop_back();
+         ref.pop_back();
+      }
+      check();
+
+      for (int i = 0; i < 30; ++i) {
+         con.push_back(-i);
+         ref.push_back(-i);
+      }
+      check();
+   }
+
+   SECTION("erase() and insert() keep the index in sync") {
+      con.erase(con.begin() + 10, con.begin() + 75);
+      ref.erase(ref.begin() + 10, ref.begin() + 75);
+      check();
+
+      std::vector<int> extra(50, 7);
+      con.insert(con.begin() + 5, extra.begin(), extra.end());
+      ref.insert(ref.begin() + 5, extra.begin(), extra.end());
+      check();
+   }
+
+   SECTION("resize(), clear() and reuse") {
+      con.resize(13);
+      ref.resize(13);
+      check();
+
+      con.clear();
+      ref.clear();
+      check();
+
+      for (int i = 0; i < 40; ++i) {
+         con.push_back(i * 3);
+         ref.push_back(i * 3);
+      }
+      check();
+   }
+
+   SECTION("swap() and move exchange indices") {
+      con_type other { 1, 2, 3 };
+      con.swap(other);
+      REQUIRE(con.size() == 3);
+      REQUIRE(con[2] == 3);
+      REQUIRE(other[99] == 99);
+
+      con_type moved(std::move(other));
+      REQUIRE(moved.size() == 100);
+      REQUIRE(moved[57] == 57);
+      REQUIRE(other.empty());
+   }
+}
+
+
+TEST_CASE("util::ChunkedList segmented iteration", BE_CATCH_TAGS) {
+   using con_type = be::util::ChunkedList<int, std::allocator<int>, 4, 3, 1>;
+
+   SECTION("empty container") {
+      con_type con;
+      std::size_t chunks = 0;
+      con.for_each_chunk([&](con_type::chunk_type) { ++chunks; });
+      REQUIRE(chunks == 0);
+      REQUIRE(con.begin().segment().size() == 0);
+      REQUIRE(be::util::accumulate(con.cbegin(), con.cend(), 0) == 0);
+      REQUIRE(be::util::find(con.begin(), con.end(), 0) == con.end());
+   }
+
+   con_type con;
+   std::vector<int> ref;
+   for (int i = 0; i < 37; ++i) {
+      con.push_back(i);
+      ref.push_back(i);
+   }
+
+   SECTION("for_each_chunk() visits each node in order") {
+      std::vector<int> visited;
+      std::vector<std::ptrdiff_t> sizes;
+      con.for_each_chunk([&](con_type::chunk_type chunk) {
+         sizes.push_back(chunk.size());
+         for (int& v : chunk) {
+            visited.push_back(v);
+            v *= 2;
+         }
+      });
+      REQUIRE(visited == ref);
+      REQUIRE(sizes.size() == 10);
+      REQUIRE(sizes.back() == 1);
+
+      const con_type& ccon = con;
+      int sum = 0;
+      ccon.for_each_chunk([&](con_type::const_chunk_type chunk) {
+         sum = std::accumulate(chunk.begin(), chunk.end(), sum);
+      });
+      REQUIRE(sum == 2 * std::accumulate(ref.begin(), ref.end(), 0));
+   }
+
+   SECTION("segment() extends to the end of the node or container") {
+      auto seg = (con.begin() + 5).segment();
+      REQUIRE(seg.size() == 3);
+      REQUIRE(seg[0] == 5);
+
+      seg = (con.begin() + 36).segment();
+      REQUIRE(seg.size() == 1);
+      REQUIRE(seg[0] == 36);
+
+      REQUIRE(con.end().segment().size() == 0);
+      REQUIRE(con.cbegin().segment().data() == &con.front());
+   }
+
+   SECTION("copy()") {
+      std::vector<int> out(40, -1);
+      auto it = be::util::copy(con.cbegin() + 3, con.cend() - 2, out.begin());
+      REQUIRE(it == out.begin() + 32);
+      REQUIRE(std::equal(ref.begin() + 3, ref.end() - 2, out.begin()));
+      REQUIRE(out[32] == -1);
+
+      con_type dest;
+      be::util::copy(con.begin(), con.end(), std::back_inserter(dest));
+      REQUIRE(std::equal(dest.begin(), dest.end(), ref.begin(), ref.end()));
+   }
+
+   SECTION("fill()") {
+      be::util::fill(con.begin() + 6, con.begin() + 30, 99);
+      std::fill(ref.begin() + 6, ref.begin() + 30, 99);
+      REQUIRE(std::equal(con.begin(), con.end(), ref.begin(), ref.end()));
+   }
+
+   SECTION("find()") {
+      for (int i = 0; i < 37; ++i) {
+         REQUIRE(be::util::find(con.begin(), con.end(), i) == con.begin() + i);
+         REQUIRE(be::util::find(con.cbegin(), con.cend(), i) == con.cbegin() + i);
+      }
+      REQUIRE(be::util::find(con.begin(), con.end(), 37) == con.end());
+      REQUIRE(be::util::find(con.begin() + 10, con.begin() + 20, 5) == con.begin() + 20);
+   }
+
+   SECTION("accumulate()") {
+      REQUIRE(be::util::accumulate(con.cbegin(), con.cend(), 0) == std::accumulate(ref.begin(), ref.end(), 0));
+      REQUIRE(be::util::accumulate(con.cbegin() + 7, con.cbegin() + 29, 0) == std::accumulate(ref.begin() + 7, ref.begin() + 29, 0));
+      REQUIRE(be::util::accumulate(con.cbegin(), con.cbegin() + 9, 1LL, std::multiplies<long long>()) == 0);
+      REQUIRE(be::util::accumulate(con.cbegin() + 1, con.cbegin() + 9, 1LL, std::multiplies<long long>()) == 40320);
+   }
+}
+
+
+namespace {
+
+struct Pod40 {
+   int v[10];
+
+   bool operator==(const Pod40& other) const {
+      return std::equal(v, v + 10, other.v);
+   }
+};
+
+template <typename C, typename F>
+void check_trivial_insert_erase(F make) {
+   C con;
+   std::vector<typename C::value_type> ref;
+   std::mt19937 prng(1234);
+
+   auto check = [&]() {
+      REQUIRE(con.size() == ref.size());
+      REQUIRE(std::equal(con.begin(), con.end(), ref.begin(), ref.end()));
+   };
+
+   int next = 0;
+   for (int i = 0; i < 400; ++i) {
+      std::size_t pos = ref.empty() ? 0 : prng() % (ref.size() + 1);
+      switch (prng() % 5) {
+         case 0: {
+            auto v = make(next++);
+            con.insert(con.begin() + pos, v);
+            ref.insert(ref.begin() + pos, v);
+            break;
+         }
+         case 1: {
+            std::size_t count = prng() % 30;
+            auto v = make(next++);
+            con.insert(con.begin() + pos, count, v);
+            ref.insert(ref.begin() + pos, count, v);
+            break;
+         }
+         case 2: {
+            std::vector<typename C::value_type> extra;
+            std::size_t count = prng() % 40;
+            for (std::size_t j = 0; j < count; ++j) {
+               extra.push_back(make(next++));
+            }
+            con.insert(con.begin() + pos, extra.begin(), extra.end());
+            ref.insert(ref.begin() + pos, extra.begin(), extra.end());
+            break;
+         }
+         case 3:
+            if (pos < ref.size()) {
+               con.erase(con.begin() + pos);
+               ref.erase(ref.begin() + pos);
+            }
+            break;
+         default: {
+            std::size_t count = std::min<std::size_t>(prng() % 25, ref.size() - pos);
+            con.erase(con.begin() + pos, con.begin() + pos + count);
+            ref.erase(ref.begin() + pos, ref.begin() + pos + count);
+            break;
+         }
+      }
+      check();
+   }
+}
+
+} // ()
+
+TEST_CASE("util::ChunkedList insert/erase of trivially copyable types", BE_CATCH_TAGS) {
+   SECTION("int") {
+      check_trivial_insert_erase<be::util::ChunkedList<int, std::allocator<int>, 4, 3, 1>>([](int i) { return i; });
+   }
+
+   SECTION("int, indexed") {
+      check_trivial_insert_erase<be::util::ChunkedList<int, std::allocator<int>, 5, 2, 1, true>>([](int i) { return i; });
+   }
+
+   SECTION("large POD") {
+      check_trivial_insert_erase<be::util::ChunkedList<Pod40, std::allocator<Pod40>, 3, 4, 2>>([](int i) {
+         Pod40 p;
+         std::fill(p.v, p.v + 10, i);
+         return p;
+      });
+   }
+
+   SECTION("non-trivial type") {
+      check_trivial_insert_erase<be::util::ChunkedList<std::string, std::allocator<std::string>, 4, 3, 1>>([](int i) {
+         return std::to_string(i);
+      });
+   }
+}
+
+
+TEST_CASE("util::ChunkedListAutoLayout", BE_CATCH_TAGS) {
+   struct Big {
+      char data[200];
+   };
+
+   struct Huge {
+      char data[5000];
+   };
+
+   using char_layout = be::util::ChunkedListAutoLayout<char>;
+   using int_layout = be::util::ChunkedListAutoLayout<int>;
+   using pod_layout = be::util::ChunkedListAutoLayout<Pod40>;
+   using big_layout = be::util::ChunkedListAutoLayout<Big>;
+   using huge_layout = be::util::ChunkedListAutoLayout<Huge>;
+
+   REQUIRE(char_layout::chunk_size == 256);
+   REQUIRE(int_layout::chunk_size == 256 / sizeof(int));
+   REQUIRE(pod_layout::chunk_size == 16);
+   REQUIRE(big_layout::chunk_size == 16);
+   REQUIRE(huge_layout::chunk_size == 16);
+   REQUIRE(be::util::ChunkedListAutoLayout<char[24]>::chunk_size == 16);
+   REQUIRE(be::util::ChunkedListAutoLayout<char[12], 64, 128>::chunk_size == 16);
+   REQUIRE(be::util::ChunkedListAutoLayout<char[36]>::chunk_size == 16);
+
+   REQUIRE((sizeof(Pod40) * pod_layout::chunk_size) % 64 == 0);
+   REQUIRE((36 * be::util::ChunkedListAutoLayout<char[36]>::chunk_size) % 64 == 0);
+   REQUIRE((sizeof(Big) * big_layout::chunk_size) % 64 == 0);
+
+   REQUIRE((int_layout::chunks_per_metanode + 1) * sizeof(void*) == 64);
+   REQUIRE((int_layout::static_chunks + 2) * sizeof(void*) <= 64);
+   REQUIRE((be::util::ChunkedListAutoLayout<int, 128>::static_chunks + 2) * sizeof(void*) <= 128);
+   REQUIRE(be::util::ChunkedListAutoLayout<int, 8>::static_chunks == 1);
+
+   be::util::AutoChunkedList<Pod40> con;
+   REQUIRE(con.chunk_size == pod_layout::chunk_size);
+
+   std::vector<Pod40> ref;
+   for (int i = 0; i < 100; ++i) {
+      Pod40 p;
+      std::fill(p.v, p.v + 10, i);
+      con.push_back(p);
+      ref.push_back(p);
+   }
+   con.erase(con.begin() + 10, con.begin() + 50);
+   ref.erase(ref.begin() + 10, ref.begin() + 50);
+   REQUIRE(std::equal(con.begin(), con.end(), ref.begin(), ref.end()));
+}
+
+TEST_CASE("util::ChunkedList reserve()/append_range()", BE_CATCH_TAGS) {
+   using list_type = be::util::ChunkedList<int, std::allocator<int>, 4, 3, 2>;
+   list_type con;
+
+   SECTION("reserve() allocates nodes without constructing elements") {
+      REQUIRE(con.capacity() == 0);
+      con.reserve(30);
+      REQUIRE(con.size() == 0);
+      REQUIRE(con.capacity() == 32);
+
+      con.push_back(1);
+      int* first = &con.front();
+      for (int i = 2; i <= 30; ++i) {
+         con.push_back(i);
+      }
+      REQUIRE(con.capacity() == 32);
+      REQUIRE(&con.front() == first);
+
+      con.reserve(10);
+      REQUIRE(con.capacity() == 32);
+   }
+
+   SECTION("append_range() from contiguous ranges") {
+      std::vector<int> src(50);
+      std::iota(src.begin(), src.end(), 0);
+      con.push_back(-1);
+      con.append_range(src);
+      con.append_range(gsl::span<const int>(src.data(), 7));
+
+      REQUIRE(con.size() == 58);
+      REQUIRE(con[0] == -1);
+      REQUIRE(std::equal(src.begin(), src.end(), con.begin() + 1));
+      REQUIRE(std::equal(src.begin(), src.begin() + 7, con.begin() + 51));
+   }
+
+   SECTION("append_range() from non-contiguous ranges") {
+      std::list<int> src { 1, 2, 3, 4, 5, 6, 7, 8, 9 };
+      con.append_range(src);
+      con.append_range(src);
+      list_type copy(con);
+      con.append_range(copy);
+      con.insert(con.begin() + 5, copy.begin() + 2, copy.end());
+
+      std::vector<int> ref(src.begin(), src.end());
+      ref.insert(ref.end(), src.begin(), src.end());
+      std::vector<int> ref_copy(ref);
+      ref.insert(ref.end(), ref_copy.begin(), ref_copy.end());
+      ref.insert(ref.begin() + 5, ref_copy.begin() + 2, ref_copy.end());
+      REQUIRE(std::equal(con.begin(), con.end(), ref.begin(), ref.end()));
+   }
+
+   SECTION("append_range() of non-trivial elements") {
+      be::util::ChunkedList<std::string, std::allocator<std::string>, 3, 2, 1> strs;
+      std::vector<std::string> src { "a", "bb", "ccc", "dddd", "eeeee", "ffffff", "g" };
+      strs.append_range(src);
+      strs.append_range(src);
+      REQUIRE(strs.size() == 14);
+      REQUIRE(std::equal(src.begin(), src.end(), strs.begin()));
+      REQUIRE(std::equal(src.begin(), src.end(), strs.begin() + 7));
+   }
+}
+
+TEST_CASE("util::ChunkedList shrink_to_fit()/compact()/memory_usage()", BE_CATCH_TAGS) {
+   using list_type = be::util::ChunkedList<int, std::allocator<int>, 4, 3, 2>;
+   using node_type = be::util::detail::ChunkedListNode<int, 4>;
+   using meta_type = be::util::detail::ChunkedListMetanode<int*, 3>;
+
+   list_type con;
+   REQUIRE(con.memory_usage() == sizeof(list_type));
+
+   for (int i = 0; i < 30; ++i) {
+      con.push_back(i);
+   }
+
+   // 8 nodes: 2 static, 6 in 2 metanodes
+   REQUIRE(con.memory_usage() == sizeof(list_type) + 8 * sizeof(node_type) + 2 * sizeof(meta_type));
+
+   SECTION("pop_back() releases spare capacity") {
+      con.reserve(100);
+      REQUIRE(con.capacity() == 100);
+      for (int i = 0; i < 25; ++i) {
+         con.pop_back();
+      }
+      REQUIRE(con.capacity() == 8);
+      con.push_back(5);
+      REQUIRE(con.size() == 6);
+      REQUIRE(con[5] == 5);
+   }
+
+   SECTION("shrink_to_fit()") {
+      con.reserve(100);
+      REQUIRE(con.memory_usage() == sizeof(list_type) + 25 * sizeof(node_type) + 8 * sizeof(meta_type));
+
+      int* first = &con.front();
+      con.shrink_to_fit();
+      REQUIRE(&con.front() == first);
+      REQUIRE(con.capacity() == 32);
+      REQUIRE(con.memory_usage() == sizeof(list_type) + 8 * sizeof(node_type) + 2 * sizeof(meta_type));
+   }
+
+   SECTION("compact()") {
+      con.reserve(100);
+      con.compact();
+      REQUIRE(con.size() == 30);
+      REQUIRE(con.capacity() == 32);
+      for (int i = 0; i < 30; ++i) {
+         REQUIRE(con[i] == i);
+      }
+
+      con.erase(con.begin(), con.end());
+      con.compact();
+      REQUIRE(con.memory_usage() == sizeof(list_type));
+   }
+
+   SECTION("compact() non-trivial, indexed") {
+      be::util::ChunkedList<std::string, std::allocator<std::string>, 3, 2, 1, true> strs;
+      for (int i = 0; i < 40; ++i) {
+         strs.push_back(std::to_string(i));
+      }
+      strs.erase(strs.begin() + 5, strs.end());
+      strs.reserve(12);
+      strs.compact();
+      REQUIRE(strs.size() == 5);
+      REQUIRE(strs.capacity() == 6);
+      REQUIRE(strs[4] == "4");
+      REQUIRE(strs.memory_usage() == sizeof(strs) + 2 * sizeof(be::util::detail::ChunkedListNode<std::string, 3>)
+              + 1 * sizeof(be::util::detail::ChunkedListMetanode<std::string*, 2>) + 2 * sizeof(std::string*));
+   }
+}
+
 #endif
@@ -0,0 +1,65 @@
+#ifdef BE_TEST
+
+#include "compression_codec.hpp"
+#include "test_data_util.hpp"
+#include "zlib.hpp"
+#include <be/core/exceptions.hpp>
+#include <catch/catch.hpp>
+#include <vector>
+
+#define BE_CATCH_TAGS "[util][util:compression]"
+
+using namespace be;
+
+TEST_CASE("util::compress_buf/decompress_buf", BE_CATCH_TAGS) {
+   const std::vector<UC> data = make_test_data(20000);
+   const Buf<const UC> input = make_buf(data.data(), data.size());
+
+   for (util::CodecType type : { util::CodecType::zlib, util::CodecType::lz4, util::CodecType::zstd }) {
+      INFO(util::codec_type_name(type));
+
+      if (!util::codec_available(type)) {
+         std::error_code ec;
+         util::compress_buf(input, ec, type);
+         REQUIRE(ec == std::errc::not_supported);
+         continue;
+      }
+
+      Buf<UC> frame = util::compress_buf(input, type);
+      REQUIRE(frame.size() < data.size());
+      REQUIRE(frame.size() <= util::compress_bound(data.size(), type));
+      REQUIRE(util::frame_codec_type(make_buf<const UC>(frame.get(), frame.size())) == type);
+
+      Buf<UC> output = util::decompress_buf(make_buf<const UC>(frame.get(), frame.size()));
+      REQUIRE(std::vector<UC>(output.begin(), output.end()) == data);
+
+      output = util::decompress_buf(util::compress_buf(make_buf(data.data(), 0), type));
+      REQUIRE(output.size() == 0);
+
+      std::error_code ec;
+      Buf<const UC> truncated = make_buf<const UC>(frame.get(), frame.size() / 2);
+      util::decompress_buf(truncated, ec);
+      REQUIRE(ec);
+
+      frame.get()[7] ^= 0x01; // claim a different uncompressed size
+      REQUIRE_THROWS(util::decompress_buf(std::move(frame)));
+   }
+
+   SECTION("zlib frames match deflate_buf") {
+      Buf<UC> frame = util::compress_buf(input, util::CodecType::zlib, 7);
+      Buf<UC> deflated = util::deflate_buf(input, true, 7);
+      REQUIRE(std::vector<UC>(frame.begin(), frame.end()) == std::vector<UC>(deflated.begin(), deflated.end()));
+
+      Buf<UC> output = util::decompress_buf(std::move(deflated));
+      REQUIRE(std::vector<UC>(output.begin(), output.end()) == data);
+   }
+
+   SECTION("unknown codec tags are rejected") {
+      Buf<UC> frame = util::compress_buf(input);
+      frame.get()[8] = 0x7F;
+      REQUIRE_THROWS(util::frame_codec_type(make_buf<const UC>(frame.get(), frame.size())));
+      REQUIRE_THROWS(util::decompress_buf(std::move(frame)));
+   }
+}
+
+#endif
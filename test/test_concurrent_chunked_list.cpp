@@ -0,0 +1,105 @@
+#ifdef BE_TEST
+
+#include <catch/catch.hpp>
+#include <algorithm>
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+#include "concurrent_chunked_list.hpp"
+
+#define BE_CATCH_TAGS "[util][util:ConcurrentChunkedList]"
+
+using namespace be;
+
+TEST_CASE("util::ConcurrentChunkedList", BE_CATCH_TAGS) {
+   util::ConcurrentChunkedList<std::string, std::allocator<std::string>, 4, 3, 2> con;
+   REQUIRE(con.empty());
+   REQUIRE(con.begin() == con.end());
+
+   std::vector<const std::string*> refs;
+   for (int i = 0; i < 100; ++i) {
+      refs.push_back(&con.emplace_back(std::to_string(i)));
+   }
+
+   REQUIRE(con.size() == 100);
+   REQUIRE(con.at(42) == "42");
+   REQUIRE_THROWS_AS(con.at(100), std::out_of_range);
+
+   int i = 0;
+   for (const std::string& str : con) {
+      REQUIRE(&str == refs[i]);
+      REQUIRE(str == std::to_string(i));
+      ++i;
+   }
+   REQUIRE(i == 100);
+
+   std::size_t total = 0;
+   con.for_each_chunk([&](util::ConcurrentChunkedList<std::string, std::allocator<std::string>, 4, 3, 2>::const_chunk_type chunk) {
+      REQUIRE(chunk.size() <= 4);
+      REQUIRE(chunk[0] == std::to_string(total));
+      total += chunk.size();
+   });
+   REQUIRE(total == 100);
+
+   con.clear();
+   REQUIRE(con.empty());
+   con.reserve(50);
+   con.push_back("x");
+   REQUIRE(con[0] == "x");
+}
+
+TEST_CASE("util::ConcurrentChunkedList concurrent writers and readers", BE_CATCH_TAGS) {
+   struct Event {
+      U32 thread;
+      U32 seq;
+      U64 check;
+   };
+
+   constexpr U32 n_writers = 4;
+   constexpr U32 n_events = 20000;
+
+   util::ConcurrentChunkedList<Event, std::allocator<Event>, 8, 3, 2> con;
+   std::atomic<bool> done(false);
+   std::atomic<bool> reader_ok(true);
+
+   std::thread reader([&]() {
+      while (!done.load()) {
+         std::size_t size = con.size();
+         std::size_t n = 0;
+         for (auto it = con.begin(); n < size; ++it, ++n) {
+            if (it->check != (U64(it->thread) << 32 | it->seq)) {
+               reader_ok = false;
+            }
+         }
+      }
+   });
+
+   std::vector<std::thread> writers;
+   for (U32 t = 0; t < n_writers; ++t) {
+      writers.emplace_back([&con, t]() {
+         for (U32 i = 0; i < n_events; ++i) {
+            con.push_back(Event { t, i, U64(t) << 32 | i });
+         }
+      });
+   }
+   for (auto& w : writers) {
+      w.join();
+   }
+   done = true;
+   reader.join();
+
+   REQUIRE(reader_ok);
+   REQUIRE(con.size() == n_writers * n_events);
+
+   // each writer's events appear in the order it appended them
+   std::vector<U32> next(n_writers, 0);
+   for (const Event& e : con) {
+      REQUIRE(e.check == (U64(e.thread) << 32 | e.seq));
+      REQUIRE(e.seq == next[e.thread]);
+      ++next[e.thread];
+   }
+   REQUIRE(std::all_of(next.begin(), next.end(), [](U32 n) { return n == n_events; }));
+}
+
+#endif
@@ -0,0 +1,68 @@
+#ifdef BE_TEST
+
+#include "concurrent_string_interner.hpp"
+#include <catch/catch.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+#define BE_CATCH_TAGS "[util][util:string]"
+
+using namespace be;
+
+TEST_CASE("util::ConcurrentStringInterner", BE_CATCH_TAGS) {
+   util::ConcurrentStringInterner interner(5);
+   REQUIRE(interner.shard_count() == 8);
+
+   SV interned;
+   {
+      S local_string = "test";
+      interned = interner(local_string);
+      REQUIRE(interned == "test");
+      REQUIRE(interned.data() != local_string.data());
+   }
+   REQUIRE(interned.data() == interner("test").data());
+
+   REQUIRE(interner("").empty());
+   REQUIRE(interner("").data() == interner(SV()).data());
+
+   interner.reserve_strings(1000);
+   for (int i = 0; i < 1000; ++i) {
+      interner(std::to_string(i));
+   }
+   REQUIRE(interner.size() == 1002);
+   REQUIRE(interner("test").data() == interned.data());
+}
+
+TEST_CASE("util::ConcurrentStringInterner concurrent interning", BE_CATCH_TAGS) {
+   constexpr std::size_t n_threads = 4;
+   constexpr std::size_t n_strings = 5000;
+
+   util::ConcurrentStringInterner interner(4);
+   std::vector<std::vector<SV>> results(n_threads, std::vector<SV>(n_strings));
+
+   std::vector<std::thread> threads;
+   for (std::size_t t = 0; t < n_threads; ++t) {
+      threads.emplace_back([&interner, &results, t]() {
+         // each thread interns the same strings, in a different order
+         for (std::size_t i = 0; i < n_strings; ++i) {
+            std::size_t n = (t % 2 == 0 ? i : n_strings - 1 - i);
+            n = (n + t * 1231) % n_strings;
+            results[t][n] = interner("string " + std::to_string(n));
+         }
+      });
+   }
+   for (auto& t : threads) {
+      t.join();
+   }
+
+   REQUIRE(interner.size() == n_strings);
+   for (std::size_t i = 0; i < n_strings; ++i) {
+      REQUIRE(results[0][i] == "string " + std::to_string(i));
+      for (std::size_t t = 1; t < n_threads; ++t) {
+         REQUIRE(results[t][i].data() == results[0][i].data());
+      }
+   }
+}
+
+#endif
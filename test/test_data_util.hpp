@@ -0,0 +1,26 @@
+#pragma once
+#ifndef BE_UTIL_TEST_DATA_UTIL_HPP_
+#define BE_UTIL_TEST_DATA_UTIL_HPP_
+
+#include <be/core/be.hpp>
+#include <random>
+#include <vector>
+
+namespace be {
+
+///////////////////////////////////////////////////////////////////////////////
+/// \brief  Generates deterministic, moderately compressible data: runs of
+///         random lowercase letters separated by runs of small byte values.
+inline std::vector<UC> make_test_data(std::size_t size) {
+   std::vector<UC> data(size);
+   std::mt19937 prng(1234);
+   std::uniform_int_distribution<int> dist(0, 15);
+   for (std::size_t i = 0; i < size; ++i) {
+      data[i] = UC(i % 97 < 40 ? 'a' + dist(prng) : i % 13);
+   }
+   return data;
+}
+
+} // be
+
+#endif
@@ -0,0 +1,121 @@
+#ifdef BE_TEST
+
+#include "fnv.hpp"
+#include <catch/catch.hpp>
+#include <algorithm>
+
+#define BE_CATCH_TAGS "[util][util:fnv]"
+
+using namespace be;
+
+TEST_CASE("util::FnvHasher", BE_CATCH_TAGS) {
+   const SV input = "The quick brown fox jumps over the lazy dog";
+
+   REQUIRE(util::FnvHasher<U64>().update(SV("a")).digest() == 0xAF63DC4C8601EC8Cull);
+   REQUIRE(util::FnvHasher<U64>().update(SV("foobar")).digest() == 0x85944171F73967E8ull);
+   REQUIRE(util::FnvHasher<U32>().update(SV("a")).digest() == 0xE40C292Cu);
+   REQUIRE(util::FnvHasher<U64>().digest() == util::fnv1a<U64>(input.begin(), input.begin()));
+
+   SECTION("incremental updates give the same result") {
+      const U64 expected = util::fnv1a<U64>(input.begin(), input.end());
+      REQUIRE(util::FnvHasher<U64>().update(input).digest() == expected);
+      REQUIRE(util::FnvHasher<U64>().update(input.begin(), input.end()).digest() == expected);
+
+      util::FnvHasher<U64> hasher;
+      hasher.update(input.substr(0, 5)).update(input.substr(5, 20)).update(input.substr(25));
+      REQUIRE(hasher.digest() == expected);
+
+      hasher.reset();
+      REQUIRE(hasher.update(input).digest() == expected);
+   }
+
+   SECTION("reset() restores a custom basis") {
+      const U64 basis = 0x0123456789ABCDEFull;
+      const U64 expected = util::fnv1a<U64>(basis, input.begin(), input.end());
+      util::FnvHasher<U64> hasher(basis);
+      REQUIRE(hasher.update(input).digest() == expected);
+
+      hasher.reset();
+      REQUIRE(hasher.digest() == basis);
+      REQUIRE(hasher.update(input).digest() == expected);
+
+      util::FnvWordHasher<U64> word_hasher(basis);
+      const U64 word_expected = word_hasher.update(input).digest();
+      REQUIRE(word_expected != util::FnvWordHasher<U64>().update(input).digest());
+      word_hasher.reset();
+      REQUIRE(word_hasher.update(input).digest() == word_expected);
+   }
+
+   SECTION("word mode is independent of how input is split") {
+      const U64 expected = util::FnvWordHasher<U64>().update(input).digest();
+      REQUIRE(expected != util::FnvHasher<U64>().update(input).digest());
+
+      for (std::size_t split = 0; split <= input.size(); ++split) {
+         const std::size_t split2 = std::min(split + 3, input.size());
+         util::FnvWordHasher<U64> hasher;
+         hasher.update(input.substr(0, split));
+         hasher.update(input.substr(split, split2 - split));
+         hasher.update(input.substr(split2));
+         REQUIRE(hasher.digest() == expected);
+      }
+
+      REQUIRE(util::FnvWordHasher<U64>().update(SV("a")).digest() != util::FnvWordHasher<U64>().update(SV("a\0", 2)).digest());
+      REQUIRE(util::FnvWordHasher<U32>().update(SV("abcd")).digest() != util::FnvWordHasher<U32>().update(SV("abcde")).digest());
+   }
+}
+
+
+TEST_CASE("util::fnv256", BE_CATCH_TAGS) {
+   REQUIRE(util::fnv256_0("") == "0000000000000000000000000000000000000000000000000000000000000000");
+   REQUIRE(util::fnv256_1("") == "dd268dbcaac550362d98c384c4e576ccc8b1536847b6bbb31023b4c8caee0535");
+   REQUIRE(util::fnv256_1a("") == "dd268dbcaac550362d98c384c4e576ccc8b1536847b6bbb31023b4c8caee0535");
+
+   REQUIRE(util::fnv256_0("a") == "0000000000000000000000000000000000000000000000000000000000000061");
+   REQUIRE(util::fnv256_1("a") == "63323fb0f35303ec28dc561d0a33bdfa4de6a99b7266494f6183b2716811381e");
+   REQUIRE(util::fnv256_1a("a") == "63323fb0f35303ec28dc751d0a33bdfa4de6a99b7266494f6183b2716811637c");
+
+   REQUIRE(util::fnv256_0("foobar") == "0000000000075a621ef5aa00000000000000000000000000000209d27d06710f");
+   REQUIRE(util::fnv256_1("foobar") == "b055ea2f2cc3908dddb794c02d3889dc32453dad5ae35b753ac86c6c2ac80d72");
+   REQUIRE(util::fnv256_1a("foobar") == "b055ea2f306cadad4f0f81c02d3889dc32453dad5ae35b753ba1a91084af3428");
+
+   SECTION("digests are most significant byte first") {
+      const util::Fnv256Digest digest = util::fnv256_1a_digest("foobar");
+      REQUIRE(digest[0] == 0xb0);
+      REQUIRE(digest[31] == 0x28);
+
+      char hex[65] = { };
+      REQUIRE(util::fnv256_hex(digest, hex) == hex + 64);
+      REQUIRE(S(hex) == util::fnv256_1a("foobar"));
+   }
+}
+
+
+TEST_CASE("util::fnv1a compile time hashing", BE_CATCH_TAGS) {
+   using namespace util::literals;
+
+   static_assert(util::fnv1a<U64>("a") == 0xAF63DC4C8601EC8Cull);
+   static_assert(util::fnv1a<U32>("a") == 0xE40C292Cu);
+   static_assert("foobar"_fnv == 0x85944171F73967E8ull);
+   static_assert(""_fnv == util::fnv1a<U64>(SV()));
+
+   const S input = "The quick brown fox jumps over the lazy dog";
+   REQUIRE(util::fnv1a(input) == util::fnv1a<U64>(input.begin(), input.end()));
+   REQUIRE(util::fnv1<U64>(input) == util::fnv1<U64>(input.begin(), input.end()));
+   REQUIRE(util::fnv1<U32>(input) == util::fnv1<U32>(input.begin(), input.end()));
+
+   auto dispatch = [](SV token) {
+      switch (util::fnv1a(token)) {
+         case "help"_fnv:  return 1;
+         case "quit"_fnv:  return 2;
+         case "a\0b"_fnv: return 3;
+         default:          return 0;
+      }
+   };
+   REQUIRE(dispatch("help") == 1);
+   REQUIRE(dispatch("quit") == 2);
+   REQUIRE(dispatch(SV("a\0b", 3)) == 3);
+   REQUIRE(dispatch("a") == 0);
+   REQUIRE(dispatch("") == 0);
+}
+
+#endif
@@ -0,0 +1,78 @@
+#ifdef BE_TEST
+
+#include "mapped_file.hpp"
+#include "test_data_util.hpp"
+#include <catch/catch.hpp>
+#include <fstream>
+#include <vector>
+
+#define BE_CATCH_TAGS "[util][util:fs]"
+
+using namespace be;
+
+namespace {
+
+///////////////////////////////////////////////////////////////////////////////
+Path write_mapped_file_test_file(const char* name, const std::vector<UC>& data) {
+   Path path = fs::temp_directory_path() / name;
+   std::ofstream ofs(path.native(), std::ios::binary | std::ios::trunc);
+   ofs.write(reinterpret_cast<const char*>(data.data()), std::streamsize(data.size()));
+   return path;
+}
+
+} // ()
+
+TEST_CASE("util::MappedFile", BE_CATCH_TAGS) {
+   const std::vector<UC> data = make_test_data(util::min_mapped_file_size + 12345);
+   const Path path = write_mapped_file_test_file("be_util_test_mapped_file.bin", data);
+
+   SECTION("maps the whole file") {
+      util::MappedFile file(path, util::MappedFileAccess::sequential);
+      REQUIRE(file.size() == data.size());
+      REQUIRE(std::vector<UC>(file.data(), file.data() + file.size()) == data);
+
+      file.prefetch(file.size() - 10, 100);
+      file.advise(util::MappedFileAccess::random);
+
+      Buf<const UC> view = file.buf();
+      REQUIRE(view.get() == file.data());
+      REQUIRE(!view.is_owner());
+
+      Buf<const UC> owned = file.release();
+      REQUIRE(file.size() == 0);
+      REQUIRE(owned.size() == data.size());
+      REQUIRE(std::vector<UC>(owned.begin(), owned.end()) == data);
+   }
+
+   SECTION("get_file_contents_mapped") {
+      Buf<const UC> contents = util::get_file_contents_mapped(path);
+      REQUIRE(std::vector<UC>(contents.begin(), contents.end()) == data);
+
+      const std::vector<UC> small_data(data.begin(), data.begin() + 1000);
+      const Path small = write_mapped_file_test_file("be_util_test_mapped_file_small.bin", small_data);
+      contents = util::get_file_contents_mapped(small);
+      REQUIRE(std::vector<UC>(contents.begin(), contents.end()) == small_data);
+      fs::remove(small);
+
+      std::error_code ec;
+      util::get_file_contents_mapped(small, ec);
+      REQUIRE(ec);
+   }
+
+   SECTION("empty and missing files") {
+      const Path empty = write_mapped_file_test_file("be_util_test_mapped_file_empty.bin", std::vector<UC>());
+      std::error_code ec;
+      util::MappedFile file(empty, ec);
+      REQUIRE(!ec);
+      REQUIRE(file.size() == 0);
+      fs::remove(empty);
+
+      util::MappedFile missing(empty, ec);
+      REQUIRE(ec);
+      REQUIRE_THROWS(util::MappedFile(empty));
+   }
+
+   fs::remove(path);
+}
+
+#endif
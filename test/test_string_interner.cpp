@@ -2,6 +2,7 @@
 
 #include "string_interner.hpp"
 #include <catch/catch.hpp>
+#include <vector>
 
 #define BE_CATCH_TAGS "[util][util:string]"
 
@@ -48,6 +49,131 @@ TEST_CASE("util::StringInterner advanced usage", BE_CATCH_TAGS) {
       REQUIRE(interner("asdf").data() < interner("ffff").data());
       REQUIRE(interner("asdf").data() + 100 > interner("ffff").data());
    }
+
+   SECTION("segment with the most room left is kept") {
+      interner.provisioning_policy([](std::size_t s) { return 100; });
+      interner("asdf");
+      interner(S(200, 'x'));
+      REQUIRE(interner.stats().segments == 2);
+      REQUIRE(interner.stats().bytes_wasted == 0);
+
+      interner("ffff");
+      REQUIRE(interner.stats().segments == 2);
+      REQUIRE(interner("asdf").data() + 4 == interner("ffff").data());
+   }
+}
+
+TEST_CASE("util::StringInterner many strings", BE_CATCH_TAGS) {
+
+   util::StringInterner interner;
+
+   SECTION("table grows as strings are added") {
+      std::vector<SV> interned;
+      std::size_t bytes = 0;
+      for (int i = 0; i < 5000; ++i) {
+         interned.push_back(interner(std::to_string(i)));
+         bytes += interned.back().size();
+      }
+      REQUIRE(interner.size() == 5000);
+
+      util::StringInternerStats stats = interner.stats();
+      REQUIRE(stats.strings == 5000);
+      REQUIRE(stats.segments <= 4);
+      REQUIRE(stats.bytes_used == bytes);
+      REQUIRE(stats.bytes_reserved >= stats.bytes_used + stats.bytes_wasted);
+
+      for (int i = 0; i < 5000; ++i) {
+         S str = std::to_string(i);
+         REQUIRE(interner(str).data() == interned[i].data());
+         REQUIRE(interned[i] == str);
+      }
+      REQUIRE(interner.size() == 5000);
+   }
+
+   SECTION("reserved table is used") {
+      interner.reserve_strings(1000);
+      SV empty = interner(SV());
+      REQUIRE(empty.empty());
+      REQUIRE(interner("").data() == empty.data());
+      REQUIRE(interner("a long string, to hash more than one word") != interner("a long string, to hash more than one word!"));
+      REQUIRE(interner.size() == 3);
+   }
+}
+
+TEST_CASE("util::StringInterner ids", BE_CATCH_TAGS) {
+
+   util::StringInterner interner;
+
+   util::InternedId a = interner.id("a");
+   util::InternedId b = interner.id("b");
+   REQUIRE(U32(a) == 0);
+   REQUIRE(U32(b) == 1);
+   REQUIRE(interner.id(S("a")) == a);
+   REQUIRE(a != b);
+
+   SV c = interner("c");
+   REQUIRE(U32(interner.id("c")) == 2);
+   REQUIRE(interner.lookup(interner.id("c")).data() == c.data());
+   REQUIRE(interner.lookup(b) == "b");
+
+   util::InternedId found;
+   REQUIRE(interner.find_id("a", found));
+   REQUIRE(found == a);
+   REQUIRE_FALSE(interner.find_id("d", found));
+   REQUIRE(interner.size() == 3);
+}
+
+TEST_CASE("util::StringInterner snapshots", BE_CATCH_TAGS) {
+
+   Buf<UC> image;
+   {
+      util::StringInterner interner;
+      interner("alpha");
+      interner("");
+      for (int i = 0; i < 100; ++i) {
+         interner(std::to_string(i));
+      }
+      interner("omega");
+      image = interner.snapshot();
+   }
+
+   util::StringInterner interner((Buf<const UC>(std::move(image))));
+   REQUIRE(interner.size() == 103);
+   REQUIRE(U32(interner.id("alpha")) == 0);
+   REQUIRE(U32(interner.id("")) == 1);
+   REQUIRE(U32(interner.id("42")) == 44);
+   REQUIRE(interner.lookup(util::InternedId(102)) == "omega");
+   REQUIRE(interner("alpha").data() == interner.lookup(util::InternedId(0)).data());
+   REQUIRE(interner.stats().segments == 0);
+
+   SECTION("new strings go to the overlay") {
+      SV beta = interner("beta");
+      REQUIRE(U32(interner.id("beta")) == 103);
+      REQUIRE(interner("beta").data() == beta.data());
+      REQUIRE(interner.size() == 104);
+
+      util::InternedId id;
+      REQUIRE(interner.find_id("omega", id));
+      REQUIRE(U32(id) == 102);
+      REQUIRE(interner.find_id("beta", id));
+      REQUIRE(U32(id) == 103);
+      REQUIRE_FALSE(interner.find_id("gamma", id));
+
+      util::StringInterner copy((Buf<const UC>(interner.snapshot())));
+      REQUIRE(copy.size() == 104);
+      REQUIRE(U32(copy.id("beta")) == 103);
+      REQUIRE(U32(copy.id("alpha")) == 0);
+   }
+
+   SECTION("invalid images are rejected") {
+      Buf<UC> bad = interner.snapshot();
+      bad[0] = 'x';
+      REQUIRE_THROWS(util::StringInterner(Buf<const UC>(std::move(bad))));
+
+      Buf<UC> truncated = interner.snapshot();
+      REQUIRE_THROWS(util::StringInterner(Buf<const UC>(truncated.get(), 64)));
+      REQUIRE_THROWS(util::StringInterner(Buf<const UC>(truncated.get(), truncated.size() - 1)));
+   }
 }
 
 #endif
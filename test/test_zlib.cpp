@@ -0,0 +1,340 @@
+#ifdef BE_TEST
+
+#include "test_data_util.hpp"
+#include "zlib.hpp"
+#include "zlib_allocator.hpp"
+#include "zlib_dictionary.hpp"
+#include "zlib_result_code.hpp"
+#include "zlib_seekable.hpp"
+#include <be/core/exceptions.hpp>
+#include <catch/catch.hpp>
+#include <random>
+#include <string>
+#include <vector>
+
+#define BE_CATCH_TAGS "[util][util:compression]"
+
+using namespace be;
+
+TEST_CASE("util::deflate_buf/inflate_buf", BE_CATCH_TAGS) {
+   const std::vector<UC> data = make_test_data(10000);
+   Buf<UC> compressed = util::deflate_buf(make_buf(data.data(), data.size()));
+   REQUIRE(compressed.size() < data.size());
+
+   Buf<UC> uncompressed = util::inflate_buf(std::move(compressed));
+   REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.end()) == data);
+
+   REQUIRE(util::inflate_string(util::deflate_string("")) == "");
+}
+
+TEST_CASE("util::deflate_buf_parallel", BE_CATCH_TAGS) {
+   const std::vector<UC> data = make_test_data(1000000);
+
+   for (std::size_t size : { 0, 1000, 131072, 131073, 1000000 }) {
+      for (std::size_t threads : { 1, 3, 8 }) {
+         Buf<UC> compressed = util::deflate_buf_parallel(make_buf(data.data(), size), threads);
+         const std::size_t serial_size = util::deflate_buf(make_buf(data.data(), size)).size();
+         REQUIRE(compressed.size() <= serial_size + serial_size / 100 + 64);
+
+         Buf<UC> uncompressed = util::inflate_buf(std::move(compressed));
+         REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.end()) == std::vector<UC>(data.begin(), data.begin() + size));
+      }
+   }
+
+   for (I8 level : { 1, 6, 9 }) {
+      Buf<UC> compressed = util::deflate_buf_parallel(make_buf(data.data(), data.size()), 2, false, level);
+      Buf<UC> serial = util::deflate_buf(make_buf(data.data(), data.size()), false, level);
+      REQUIRE(compressed[0] == serial[0]);
+      REQUIRE(compressed[1] == serial[1]);
+
+      Buf<UC> uncompressed = util::inflate_buf(std::move(compressed), data.size());
+      REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.end()) == data);
+   }
+}
+
+TEST_CASE("util::deflate_into/inflate_into", BE_CATCH_TAGS) {
+   const std::vector<UC> data = make_test_data(10000);
+   const Buf<const UC> input = make_buf(data.data(), data.size());
+
+   SECTION("spans") {
+      std::vector<UC> compressed(util::deflate_bound(data.size()));
+      std::size_t compressed_size = util::deflate_into(input, compressed);
+      REQUIRE(compressed_size < data.size());
+
+      Buf<UC> expected = util::deflate_buf(input);
+      REQUIRE(std::vector<UC>(compressed.begin(), compressed.begin() + compressed_size) == std::vector<UC>(expected.begin(), expected.end()));
+
+      std::vector<UC> uncompressed(data.size() + 10);
+      REQUIRE(util::inflate_into(make_buf<const UC>(compressed.data(), compressed_size), uncompressed) == data.size());
+      REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.begin() + data.size()) == data);
+
+      util::ZlibDeflater deflater;
+      util::ZlibInflater inflater;
+      compressed_size = deflater.deflate_into(input, compressed);
+      REQUIRE(inflater.inflate_into(make_buf<const UC>(compressed.data(), compressed_size), uncompressed) == data.size());
+      REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.begin() + data.size()) == data);
+   }
+
+   SECTION("reused buffers are only grown when too small") {
+      Buf<UC> compressed;
+      std::size_t compressed_size = util::deflate_into(input, compressed);
+      REQUIRE(compressed.size() == util::deflate_bound(data.size()));
+      const UC* compressed_ptr = compressed.get();
+
+      Buf<UC> uncompressed;
+      REQUIRE(util::inflate_into(make_buf<const UC>(compressed.get(), compressed_size), uncompressed) == data.size());
+      REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.end()) == data);
+      const UC* uncompressed_ptr = uncompressed.get();
+
+      const Buf<const UC> smaller = make_buf(data.data(), 5000);
+      compressed_size = util::deflate_into(smaller, compressed);
+      REQUIRE(compressed.get() == compressed_ptr);
+      REQUIRE(util::inflate_into(make_buf<const UC>(compressed.get(), compressed_size), uncompressed) == smaller.size());
+      REQUIRE(uncompressed.get() == uncompressed_ptr);
+      REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.begin() + smaller.size()) == std::vector<UC>(data.begin(), data.begin() + smaller.size()));
+   }
+
+   SECTION("outputs that are too small") {
+      std::error_code ec;
+      std::vector<UC> compressed(util::deflate_bound(data.size()));
+      std::vector<UC> tiny(16);
+      util::deflate_into(input, tiny, ec);
+      REQUIRE(ec);
+
+      ec = std::error_code();
+      std::size_t compressed_size = util::deflate_into(input, compressed, ec);
+      REQUIRE(!ec);
+
+      std::vector<UC> uncompressed(data.size() - 1);
+      REQUIRE_THROWS(util::inflate_into(make_buf<const UC>(compressed.data(), compressed_size), uncompressed));
+   }
+}
+
+TEST_CASE("util::ZlibDeflater/ZlibInflater", BE_CATCH_TAGS) {
+   const std::vector<UC> data = make_test_data(100000);
+
+   SECTION("messages are interchangeable with deflate_buf/inflate_buf") {
+      util::ZlibDeflater deflater;
+      util::ZlibInflater inflater;
+      for (std::size_t size : { 0, 1, 100, 5000 }) {
+         Buf<UC> compressed = deflater.deflate_buf(make_buf(data.data(), size));
+         Buf<UC> uncompressed = util::inflate_buf(make_buf<const UC>(compressed.get(), compressed.size()));
+         REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.end()) == std::vector<UC>(data.begin(), data.begin() + size));
+
+         compressed = util::deflate_buf(make_buf(data.data(), size));
+         uncompressed = inflater.inflate_buf(make_buf<const UC>(compressed.get(), compressed.size()));
+         REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.end()) == std::vector<UC>(data.begin(), data.begin() + size));
+      }
+   }
+
+   SECTION("streams can be pushed and pulled in chunks") {
+      util::ZlibDeflater deflater(9);
+      util::ZlibInflater inflater;
+
+      for (std::size_t chunk_size : { 1, 77, 4096, 100000 }) {
+         std::vector<UC> compressed;
+         UC buf[300];
+
+         for (std::size_t offset = 0; offset < data.size(); offset += chunk_size) {
+            deflater.push(gsl::span<const UC>(data.data() + offset, std::min(chunk_size, data.size() - offset)));
+            while (!deflater.needs_input()) {
+               compressed.insert(compressed.end(), buf, buf + deflater.pull(buf));
+            }
+         }
+         deflater.finish();
+         while (!deflater.done()) {
+            compressed.insert(compressed.end(), buf, buf + deflater.pull(buf));
+         }
+         REQUIRE(compressed.size() < data.size() / 2);
+
+         std::vector<UC> uncompressed;
+         for (std::size_t offset = 0; offset < compressed.size() && !inflater.done(); offset += chunk_size) {
+            inflater.push(gsl::span<const UC>(compressed.data() + offset, std::min(chunk_size, compressed.size() - offset)));
+            while (!inflater.done()) {
+               std::size_t n = inflater.pull(buf);
+               uncompressed.insert(uncompressed.end(), buf, buf + n);
+               if (n < sizeof(buf) && inflater.needs_input()) {
+                  break;
+               }
+            }
+         }
+         REQUIRE(inflater.done());
+         REQUIRE(uncompressed == data);
+
+         deflater.reset();
+         inflater.reset();
+      }
+   }
+
+   SECTION("truncated and corrupt streams") {
+      util::ZlibDeflater deflater;
+      Buf<UC> compressed = deflater.deflate_buf(make_buf(data.data(), 1000), false);
+
+      util::ZlibInflater inflater;
+      UC buf[2000];
+      inflater.push(gsl::span<const UC>(compressed.get(), compressed.size() - 4));
+      inflater.pull(buf);
+      REQUIRE(inflater.needs_input());
+      REQUIRE_FALSE(inflater.done());
+
+      inflater.reset();
+      compressed[0] ^= 0xFF;
+      inflater.push(gsl::span<const UC>(compressed.get(), compressed.size()));
+      REQUIRE_THROWS_AS(inflater.pull(buf), RecoverableError);
+   }
+}
+
+
+TEST_CASE("util::train_zlib_dictionary", BE_CATCH_TAGS) {
+   std::vector<S> messages;
+   std::mt19937 prng(5678);
+   std::uniform_int_distribution<int> dist(0, 99999);
+   for (int i = 0; i < 200; ++i) {
+      messages.push_back("{\"type\":\"position_update\",\"entity\":" + std::to_string(dist(prng)) +
+                         ",\"position\":{\"x\":" + std::to_string(dist(prng)) + ",\"y\":" + std::to_string(dist(prng)) +
+                         "},\"velocity\":{\"x\":" + std::to_string(dist(prng) % 10) + ",\"y\":0},\"flags\":[\"visible\",\"solid\"]}");
+   }
+
+   std::vector<Buf<const UC>> samples;
+   for (std::size_t i = 0; i < 150; ++i) {
+      samples.push_back(make_buf(messages[i].c_str(), messages[i].size()));
+   }
+
+   Buf<UC> trained = util::train_zlib_dictionary(samples, 1024);
+   REQUIRE(trained.size() > 0);
+   REQUIRE(trained.size() <= 1024);
+   const Buf<const UC> dictionary = make_buf<const UC>(trained.get(), trained.size());
+   const U32 id = util::zlib_dictionary_id(dictionary);
+
+   std::size_t plain_size = 0;
+   std::size_t dictionary_size = 0;
+   util::ZlibDeflater deflater;
+   util::ZlibInflater inflater;
+   deflater.dictionary(tmp_buf(dictionary));
+   inflater.dictionary(tmp_buf(dictionary));
+
+   for (std::size_t i = 150; i < messages.size(); ++i) {
+      const Buf<const UC> data = make_buf(messages[i].c_str(), messages[i].size());
+      plain_size += util::deflate_buf(data).size();
+
+      Buf<UC> compressed = util::deflate_buf(data, dictionary);
+      dictionary_size += compressed.size();
+
+      U32 stream_id = 0;
+      REQUIRE(util::zlib_stream_dictionary_id(make_buf<const UC>(compressed.get(), compressed.size()), stream_id));
+      REQUIRE(stream_id == id);
+
+      Buf<UC> uncompressed = util::inflate_buf(make_buf<const UC>(compressed.get(), compressed.size()), dictionary);
+      REQUIRE(S(uncompressed.begin(), uncompressed.end()) == messages[i]);
+
+      uncompressed = inflater.inflate_buf(make_buf<const UC>(compressed.get(), compressed.size()));
+      REQUIRE(S(uncompressed.begin(), uncompressed.end()) == messages[i]);
+
+      compressed = deflater.deflate_buf(data);
+      uncompressed = util::inflate_buf(make_buf<const UC>(compressed.get(), compressed.size()), dictionary);
+      REQUIRE(S(uncompressed.begin(), uncompressed.end()) == messages[i]);
+
+      std::error_code ec;
+      util::inflate_buf(make_buf<const UC>(compressed.get(), compressed.size()), ec);
+      REQUIRE(ec == util::ZlibResultCode::need_dictionary);
+   }
+
+   REQUIRE(dictionary_size * 2 < plain_size);
+
+   U32 stream_id = 0;
+   REQUIRE_FALSE(util::zlib_stream_dictionary_id(util::deflate_buf(make_buf(messages[0].c_str(), messages[0].size())), stream_id));
+}
+
+TEST_CASE("util::zlib_allocator_config", BE_CATCH_TAGS) {
+   const util::ZlibAllocatorConfig original = util::zlib_allocator_config();
+   const std::vector<UC> data = make_test_data(10000);
+   const Buf<const UC> input = make_buf(data.data(), data.size());
+
+   SECTION("thread_cache mode reuses stream memory") {
+      util::ZlibAllocatorConfig config;
+      config.mode = util::ZlibAllocatorMode::thread_cache;
+      util::zlib_allocator_config(config);
+
+      util::deflate_buf(input);
+      util::reset_zlib_allocator_stats();
+      Buf<UC> compressed = util::deflate_buf(input);
+
+      util::ZlibAllocatorStats stats = util::zlib_allocator_stats();
+      REQUIRE(stats.allocations > 0);
+      REQUIRE(stats.system_allocations == 0);
+      REQUIRE(stats.bytes_in_use == 0);
+      REQUIRE(stats.peak_bytes_in_use > 200 * 1024);
+
+      Buf<UC> uncompressed = util::inflate_buf(std::move(compressed));
+      REQUIRE(std::vector<UC>(uncompressed.begin(), uncompressed.end()) == data);
+   }
+
+   SECTION("system mode always allocates") {
+      util::ZlibAllocatorConfig config;
+      config.mode = util::ZlibAllocatorMode::system;
+      util::zlib_allocator_config(config);
+      util::release_zlib_allocator_cache();
+
+      util::reset_zlib_allocator_stats();
+      util::deflate_buf(input);
+
+      util::ZlibAllocatorStats stats = util::zlib_allocator_stats();
+      REQUIRE(stats.allocations > 0);
+      REQUIRE(stats.system_allocations == stats.allocations);
+      REQUIRE(stats.bytes_in_use == 0);
+   }
+
+   util::zlib_allocator_config(original);
+}
+
+TEST_CASE("util::SeekableZlibReader", BE_CATCH_TAGS) {
+   const std::vector<UC> data = make_test_data(100000);
+   Buf<UC> compressed = util::deflate_seekable_buf(make_buf(data.data(), data.size()), 4096);
+   REQUIRE(compressed.size() < data.size());
+
+   util::SeekableZlibReader reader(std::move(compressed));
+   REQUIRE(reader.size() == data.size());
+   REQUIRE(reader.frame_size() == 4096);
+   REQUIRE(reader.frame_count() == 25);
+
+   SECTION("reads within, across, and past the end of frames") {
+      for (std::size_t offset : { 0, 1, 4095, 4096, 10000, 98303, 99999, 100000, 200000 }) {
+         for (std::size_t size : { 0, 1, 100, 4096, 20000 }) {
+            const std::size_t expected = offset < data.size() ? std::min(size, data.size() - offset) : 0;
+            Buf<UC> buf = reader.read(offset, size);
+            REQUIRE(buf.size() == expected);
+            REQUIRE(std::equal(buf.begin(), buf.end(), data.begin() + std::min(offset, data.size())));
+         }
+      }
+
+      std::vector<UC> all(data.size() + 10);
+      REQUIRE(reader.read(0, all) == data.size());
+      REQUIRE(std::equal(data.begin(), data.end(), all.begin()));
+   }
+
+   SECTION("empty data") {
+      util::SeekableZlibReader empty(util::deflate_seekable_buf(Buf<const UC>()));
+      REQUIRE(empty.size() == 0);
+      REQUIRE(empty.frame_count() == 0);
+      REQUIRE(empty.read(0, 10).size() == 0);
+   }
+
+   SECTION("invalid containers are rejected") {
+      Buf<UC> valid = util::deflate_seekable_buf(make_buf(data.data(), 10000), 1000);
+
+      Buf<UC> truncated = copy_buf(sub_buf(valid, 0, valid.size() - 1));
+      REQUIRE_THROWS(util::SeekableZlibReader(std::move(truncated)));
+
+      Buf<UC> bad_index = copy_buf(valid);
+      bad_index[bad_index.size() - 16 - 8 * 5] ^= 0x40;
+      REQUIRE_THROWS(util::SeekableZlibReader(std::move(bad_index)));
+
+      Buf<UC> bad_frame = copy_buf(valid);
+      bad_frame[3] ^= 0xFF;
+      util::SeekableZlibReader bad_reader(std::move(bad_frame));
+      REQUIRE_THROWS(bad_reader.read(0, 10));
+      REQUIRE(bad_reader.read(5000, 10).size() == 10);
+   }
+}
+
+#endif